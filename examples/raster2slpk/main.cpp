@@ -22,11 +22,30 @@ email: contracts@esri.com
 #include "utils/utl_geom.h"
 #include "utils/utl_i3s_resource_defines.h"
 #include <iostream>
+#include <fstream>
 #include <vector>
 #include <algorithm>
+#include <cctype>
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
+#include <future>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <string>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 #include <filesystem>
 namespace stdfs = std::filesystem;
@@ -84,12 +103,52 @@ double screen_size_to_area(double pixels)
   return pixels * pixels * c_pi_over_4;
 }
 
-i3slib::i3s::Layer_writer::Var create_writer(const stdfs::path& slpk_path)
+std::optional<i3slib::i3s::Basis_encoding_preset> parse_ktx2_preset(const std::string& name)
+{
+  using i3slib::i3s::Basis_encoding_preset;
+  if (name == "etc1s")
+    return Basis_encoding_preset::Etc1s_default;
+  if (name == "etc1s_fast")
+    return Basis_encoding_preset::Etc1s_fast;
+  if (name == "uastc_rdo")
+    return Basis_encoding_preset::Uastc_rdo;
+  if (name == "uastc_hq")
+    return Basis_encoding_preset::Uastc_high_quality;
+  return std::nullopt;
+}
+
+// PNG preset name, optionally suffixed with "_libdeflate".
+std::optional<i3slib::utl::Png_encoding_params> parse_png_preset(std::string name)
+{
+  using i3slib::utl::Png_encoding_preset;
+  const std::string c_libdeflate_suffix = "_libdeflate";
+  const bool use_libdeflate = name.size() > c_libdeflate_suffix.size()
+    && name.compare(name.size() - c_libdeflate_suffix.size(), c_libdeflate_suffix.size(), c_libdeflate_suffix) == 0;
+  if (use_libdeflate)
+    name.resize(name.size() - c_libdeflate_suffix.size());
+
+  std::optional<i3slib::utl::Png_encoding_params> params;
+  if (name == "fast")
+    params = i3slib::utl::get_png_encoding_params(Png_encoding_preset::Fast);
+  else if (name == "balanced")
+    params = i3slib::utl::get_png_encoding_params(Png_encoding_preset::Balanced);
+  else if (name == "small")
+    params = i3slib::utl::get_png_encoding_params(Png_encoding_preset::Small);
+  if (params)
+    params->use_libdeflate = use_libdeflate;
+  return params;
+}
+
+i3slib::i3s::Layer_writer::Var create_writer(const stdfs::path& slpk_path, const std::optional<i3slib::i3s::Basis_encoding_preset>& ktx2_preset)
 {
   i3slib::i3s::Ctx_properties ctx_props(i3slib::i3s::Max_major_versions({}));
   //i3slib::i3s::set_geom_compression(ctx_props.geom_encoding_support, i3slib::i3s::Geometry_compression::Draco, true);
   //i3slib::i3s::set_gpu_compression(ctx_props.gpu_tex_encoding_support, i3slib::i3s::GPU_texture_compression::ETC_2, true);
+  if (ktx2_preset)
+    i3slib::i3s::set_gpu_compression(ctx_props.gpu_tex_encoding_support, i3slib::i3s::GPU_texture_compression::KTX2, true);
   auto writer_context = i3slib::i3s::create_i3s_writer_context(ctx_props);
+  if (ktx2_preset)
+    i3slib::i3s::set_basis_encoding(*writer_context, i3slib::i3s::get_basis_encoding_params(*ktx2_preset));
 
   i3slib::i3s::Layer_meta meta;
   meta.type = i3slib::i3s::Layer_type::Mesh_IM;
@@ -111,34 +170,239 @@ i3slib::i3s::Layer_writer::Var create_writer(const stdfs::path& slpk_path)
   return writer;
 }
 
-template<typename T>
-size_t remove_alpha_channel(T* data, size_t size)
+// Read-only mapping of a whole file into memory. Pages are loaded by the OS on first access and may be
+// evicted under memory pressure, so rasters larger than the available RAM can be read tile by tile.
+class Mapped_file
+{
+public:
+
+  Mapped_file() = default;
+  Mapped_file(const Mapped_file&) = delete;
+  Mapped_file& operator=(const Mapped_file&) = delete;
+  ~Mapped_file() { close(); }
+
+  bool open(const stdfs::path& path)
+  {
+    close();
+
+    std::error_code ec;
+    const auto size = stdfs::file_size(path, ec);
+    if (ec || size == 0)
+      return false;
+
+#ifdef _WIN32
+    file_ = ::CreateFileW(
+      path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+      return false;
+
+    mapping_ = ::CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_)
+      return false;
+
+    data_ = static_cast<const char*>(::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (!data_)
+      return false;
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+
+    // The mapping keeps its own reference to the file.
+    auto p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED)
+      return false;
+
+    data_ = static_cast<const char*>(p);
+#endif
+
+    size_ = static_cast<size_t>(size);
+    return true;
+  }
+
+  void close()
+  {
+#ifdef _WIN32
+    if (data_)
+      ::UnmapViewOfFile(data_);
+    if (mapping_)
+      ::CloseHandle(mapping_);
+    if (file_ != INVALID_HANDLE_VALUE)
+      ::CloseHandle(file_);
+    mapping_ = nullptr;
+    file_ = INVALID_HANDLE_VALUE;
+#else
+    if (data_)
+      ::munmap(const_cast<char*>(data_), size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+private:
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+
+#ifdef _WIN32
+  HANDLE file_ = INVALID_HANDLE_VALUE;
+  HANDLE mapping_ = nullptr;
+#endif
+};
+
+// Color raster of size * size RGB pixels for one pyramid level.
+struct Texture_level
+{
+  Mapped_file file;
+  int size = 0;
+
+  const char* data() const { return file.data(); }
+};
+
+// Elevation grid of size * size cells (i.e. (size + 1) * (size + 1) nodes) for one pyramid level.
+// The full resolution level holds 16-bit elevation codes, the downsampled levels hold elevations.
+struct Grid_level
 {
-  I3S_ASSERT(size % 4 == 0);
-  size_t out = 3;
-  for (size_t in = 4; in < size; in += 4, out += 3)
+  Mapped_file file;
+  int size = 0;
+  double unit = 0.0; // elevation unit for 16-bit codes, 0 for downsampled levels.
+
+  double at(int x, int y) const
+  {
+    const auto i = static_cast<size_t>(y) * (size + 1) + x;
+    if (unit != 0.0)
+      return reinterpret_cast<const uint16_t*>(file.data())[i] * unit;
+    return reinterpret_cast<const double*>(file.data())[i];
+  }
+};
+
+// Raster pyramids, from the coarsest level (depth 0) to the full resolution one.
+// Downsampled levels are streamed to temporary files, one row at a time, and mapped back,
+// so only the pages touched by the nodes being built need to be resident.
+struct Pyramid
+{
+  std::vector<std::unique_ptr<Grid_level>> grids;
+  std::vector<std::unique_ptr<Texture_level>> textures;
+};
+
+// Directory for the temporary pyramid files, removed with its content when the conversion is over.
+class Temp_dir
+{
+public:
+
+  explicit Temp_dir(stdfs::path path) :
+    path_(std::move(path))
   {
-    data[out] = data[in];
-    data[out + 1] = data[in + 1];
-    data[out + 2] = data[in + 2];
+    std::error_code ec;
+    stdfs::create_directories(path_, ec);
   }
 
-  I3S_ASSERT(out * 4 == size * 3);
-  return out;
+  ~Temp_dir()
+  {
+    std::error_code ec;
+    stdfs::remove_all(path_, ec);
+  }
+
+  const stdfs::path& path() const { return path_; }
+
+private:
+
+  const stdfs::path path_;
+};
+
+bool is_png(const stdfs::path& path)
+{
+  auto ext = path.extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(), [](char c) { return static_cast<char>(std::tolower(c)); });
+  return ext == ".png";
 }
 
-bool load_color_data(const stdfs::path& path, int& size, std::vector<char>& data)
+// Decodes a PNG file row by row and writes the rows converted by the functor to a raw file.
+template<typename Convert_row>
+bool convert_png_rows(
+  i3slib::utl::Png_reader& reader,
+  int width,
+  int height,
+  int bytes_per_pixel,
+  const stdfs::path& output_path,
+  Convert_row convert_row)
 {
-  data.clear();
+  std::ofstream out(output_path, std::ios::binary | std::ios::trunc);
+  if (!out)
+    return false;
 
-  int h;
-  if (!i3slib::utl::read_png_from_file(path, &size, &h, &data))
+  std::vector<char> row(static_cast<size_t>(width) * bytes_per_pixel);
+  std::vector<char> out_row;
+  for (int y = 0; y < height; y++)
+  {
+    if (!reader.read_rows(1, row.data(), static_cast<int>(row.size())))
+      return false;
+
+    convert_row(row, out_row);
+    out.write(out_row.data(), out_row.size());
+  }
+
+  return out.good();
+}
+
+bool open_color_data(const stdfs::path& path, const stdfs::path& temp_dir, Texture_level& level)
+{
+  auto raw_path = path;
+  if (is_png(path))
+  {
+    int w, h, bytes_per_pixel;
+    i3slib::utl::Png_reader reader;
+    if (!reader.open(path, &w, &h, &bytes_per_pixel))
+    {
+      std::cout << "Failed to load color bitmap from file." << std::endl;
+      return false;
+    }
+
+    if (w != h)
+    {
+      std::cout << "Color bitmap must have equal width and height." << std::endl;
+      return false;
+    }
+
+    // The current png reader implementation always produces RGBA output for color images.
+    // We have to strip alpha channel here.
+    if (bytes_per_pixel != 4)
+    {
+      std::cout << "Color bitmap must be an RGB(A) image." << std::endl;
+      return false;
+    }
+
+    raw_path = temp_dir / "color_full.raw";
+    const auto remove_alpha_channel = [](const std::vector<char>& rgba, std::vector<char>& rgb)
+    {
+      rgb.resize(rgba.size() / 4 * 3);
+      for (size_t in = 0, out = 0; in < rgba.size(); in += 4, out += 3)
+      {
+        rgb[out] = rgba[in];
+        rgb[out + 1] = rgba[in + 1];
+        rgb[out + 2] = rgba[in + 2];
+      }
+    };
+
+    if (!convert_png_rows(reader, w, h, bytes_per_pixel, raw_path, remove_alpha_channel))
+    {
+      std::cout << "Failed to load color bitmap from file." << std::endl;
+      return false;
+    }
+  }
+
+  if (!level.file.open(raw_path))
   {
     std::cout << "Failed to load color bitmap from file." << std::endl;
     return false;
   }
 
-  if (size != h)
+  const auto size = static_cast<int>(std::lround(std::sqrt(level.file.size() / 3.0)));
+  if (static_cast<size_t>(size) * size * 3 != level.file.size())
   {
     std::cout << "Color bitmap must have equal width and height." << std::endl;
     return false;
@@ -150,52 +414,72 @@ bool load_color_data(const stdfs::path& path, int& size, std::vector<char>& data
     return false;
   }
 
-  // The current png reader implementation always produces RGBA output for color images.
-  // We have to strip alpha channel here.
-  I3S_ASSERT(data.size() == size * size * 4);
-  data.resize(remove_alpha_channel(data.data(), data.size()));
-  I3S_ASSERT(data.size() == size * size * 3);
+  level.size = size;
   return true;
 }
 
-bool load_elevation_data(const stdfs::path& path, int size, std::vector<double>& data, double unit)
+bool open_elevation_data(const stdfs::path& path, int size, double unit, const stdfs::path& temp_dir, Grid_level& level)
 {
-  data.clear();
-
-  int w, h;
-  std::vector<char> grayscale_data;
-  if (!i3slib::utl::read_png_from_file(path, &w, &h, &grayscale_data))
+  auto raw_path = path;
+  if (is_png(path))
   {
-    std::cout << "Failed to load elevation image from file." << std::endl;
-    return false;
-  }
+    int w, h, bytes_per_pixel;
+    i3slib::utl::Png_reader reader;
+    if (!reader.open(path, &w, &h, &bytes_per_pixel))
+    {
+      std::cout << "Failed to load elevation image from file." << std::endl;
+      return false;
+    }
 
-  if (w != size + 1 || h != size + 1)
-  {
-    std::cout << "Invalid elevation image dimensions." << std::endl;
-    return false;
+    if (w != size + 1 || h != size + 1)
+    {
+      std::cout << "Invalid elevation image dimensions." << std::endl;
+      return false;
+    }
+
+    if (bytes_per_pixel != 2)
+    {
+      std::cout << "Elevation image is not a 16-bit grayscale." << std::endl;
+      return false;
+    }
+
+    raw_path = temp_dir / "elevation_full.raw";
+    const auto to_elevation_codes = [](const std::vector<char>& gray, std::vector<char>& codes)
+    {
+      codes.resize(gray.size());
+      auto p = reinterpret_cast<const unsigned char*>(gray.data());
+      auto out = reinterpret_cast<uint16_t*>(codes.data());
+      for (size_t i = 0; i < gray.size(); i += 2, p += 2)
+      {
+        // PNG files store 16-bit pixels in network byte order (that is big-endian, most significant bits
+        // first). See http://www.libpng.org/pub/png/libpng-manual.txt
+        // However, Png_reader sets png_set_invert_mono() and png_set_swap() modes for libpng
+        // (same as read_png_from_file()), and we have to deal with this here.
+        *out++ = static_cast<uint16_t>(0xffffu - (p[0] + (p[1] << 8)));
+      }
+    };
+
+    if (!convert_png_rows(reader, w, h, bytes_per_pixel, raw_path, to_elevation_codes))
+    {
+      std::cout << "Failed to load elevation image from file." << std::endl;
+      return false;
+    }
   }
 
-  if (grayscale_data.size() != w * w * 2)
+  if (!level.file.open(raw_path))
   {
-    std::cout << "Elevation image is not a 16-bit grayscale." << std::endl;
+    std::cout << "Failed to load elevation image from file." << std::endl;
     return false;
   }
 
-  data.reserve(grayscale_data.size() / 2);
-  auto p = reinterpret_cast<const unsigned char*>(grayscale_data.data());
-  auto end = p + grayscale_data.size();
-  for (; p != end; p += 2)
+  if (level.file.size() != static_cast<size_t>(size + 1) * (size + 1) * sizeof(uint16_t))
   {
-    // PNG files store 16-bit pixels in network byte order (that is big-endian, most significant bits
-    // first). See http://www.libpng.org/pub/png/libpng-manual.txt
-    // However, implementation of read_png_from_file() sets png_set_invert_mono() and png_set_swap()
-    // modes for libpng, and we have to deal with this here.
-
-    const auto e = 0xffffu - (p[0] + (p[1] << 8));
-    data.push_back(e * unit);
+    std::cout << "Invalid elevation image dimensions." << std::endl;
+    return false;
   }
 
+  level.size = size;
+  level.unit = unit;
   return true;
 }
 
@@ -204,104 +488,123 @@ uint8_t avg4(uint8_t c1, uint8_t c2, uint8_t c3, uint8_t c4)
   return static_cast<uint8_t>((c1 + c2 + c3 + c4 + 2) / 4);
 }
 
-void build_downsampled_textures(int size, const char* data, int min_size, std::vector<std::vector<char>>& textures)
+bool build_downsampled_texture(const Texture_level& src, const stdfs::path& path, Texture_level& dst)
 {
-  while(size > min_size)
-  {
-    I3S_ASSERT((size % 2) == 0);
-    const auto s = size / 2;
-    const auto stride = size * 3;
+  I3S_ASSERT((src.size % 2) == 0);
+  const auto s = src.size / 2;
+  const auto stride = static_cast<size_t>(src.size) * 3;
 
-    std::vector<char> texture;
-    texture.reserve(s * s * 3);
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out)
+    return false;
 
-    const uint8_t *p = reinterpret_cast<const uint8_t*>(data);
-    for (int y = 0; y < s; y++)
+  std::vector<char> row(static_cast<size_t>(s) * 3);
+  for (int y = 0; y < s; y++)
+  {
+    auto p = reinterpret_cast<const uint8_t*>(src.data()) + 2 * y * stride;
+    auto p1 = p + stride;
+    auto texel = row.begin();
+    for (int x = 0; x < s; x++, p += 6, p1 += 6)
     {
-      auto p1 = p + stride;
-      for (int x = 0; x < s; x++, p += 6 , p1 += 6)
-      {
-        // Get average R,G,B values over 2 * 2 block of pixels.
-        texture.push_back(avg4(p[0], p[3], p1[0], p1[3]));
-        texture.push_back(avg4(p[1], p[4], p1[1], p1[4]));
-        texture.push_back(avg4(p[2], p[5], p1[2], p1[5]));
-      }
-      p = p1;
+      // Get average R,G,B values over 2 * 2 block of pixels.
+      *texel++ = avg4(p[0], p[3], p1[0], p1[3]);
+      *texel++ = avg4(p[1], p[4], p1[1], p1[4]);
+      *texel++ = avg4(p[2], p[5], p1[2], p1[5]);
     }
 
-    textures.emplace_back(std::move(texture));
-    data = textures.back().data();
-    size = s;
+    out.write(row.data(), row.size());
   }
+
+  out.close();
+  if (!out || !dst.file.open(path))
+    return false;
+
+  dst.size = s;
+  return true;
 }
 
-void build_downsampled_grids(int size, const double* data, int min_size, std::vector<std::vector<double>>& grids)
+bool build_downsampled_textures(Pyramid& pyramid, int min_size, const stdfs::path& temp_dir)
 {
-  while (size > min_size)
+  // Levels are built from the full resolution one, the pyramid is reversed at the end.
+  auto& textures = pyramid.textures;
+  std::reverse(std::begin(textures), std::end(textures));
+  while (textures.back()->size > min_size)
   {
-    I3S_ASSERT((size % 2) == 0);
-    const auto s = size / 2;
-    I3S_ASSERT((s % 2) == 0);
-
-    std::vector<double> grid;
-    grid.reserve((s + 1) * (s + 1));
+    auto level = std::make_unique<Texture_level>();
+    const auto path = temp_dir / ("color_" + std::to_string(textures.size()) + ".raw");
+    if (!build_downsampled_texture(*textures.back(), path, *level))
+      return false;
 
-    auto p = data;
-    auto pn = p + size + 1;
-
-    // Corner vertex of the first row.
-    grid.push_back((p[0] + p[1] + pn[0]) / 3.0);
-    p += 2;
-    pn += 2;
+    textures.emplace_back(std::move(level));
+  }
 
-    // Internal vertices of the first row.
-    for (int x = 1; x < s; x++, p += 2, pn += 2)
-      grid.push_back((p[-1] + p[0] + p[1] + pn[0]) * 0.25);
+  std::reverse(std::begin(textures), std::end(textures));
+  return true;
+}
 
-    // Corner vertex of the first row.
-    grid.push_back((p[-1] + p[0] + pn[0]) / 3.0);
+// Every node of the downsampled grid is the average of the matching node of the source grid
+// and of its (up to 4) direct neighbors.
+bool build_downsampled_grid(const Grid_level& src, const stdfs::path& path, Grid_level& dst)
+{
+  I3S_ASSERT((src.size % 2) == 0);
+  const auto s = src.size / 2;
+  I3S_ASSERT((s % 2) == 0);
 
-    //
-    auto pp = p + 1;
-    p = pn + 1;
-    pn += (size + 2);
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  if (!out)
+    return false;
 
-    for (int y = 1; y < s; y++)
+  std::vector<double> row(static_cast<size_t>(s) + 1);
+  for (int y = 0; y <= s; y++)
+  {
+    const int cy = 2 * y;
+    for (int x = 0; x <= s; x++)
     {
-      // First vertex of the row.
-      grid.push_back((pp[0] + p[0] + p[1] + pn[0]) * 0.25);
-      pp += 2;
-      p += 2;
-      pn += 2;
-
-      // Internal vertices of the row.
-      for (int x = 1; x < s; x++, pp += 2, p += 2, pn += 2)
-        grid.push_back((pp[0] + p[-1] + p[0] + p[1] + pn[0]) * 0.2);
-
-      // Last vertex of the row.
-      grid.push_back((pp[0] + p[-1] + p[0] + pn[0]) * 0.25);
-
-      pp = p + 1;
-      p = pn + 1;
-      pn += (size + 2);
+      const int cx = 2 * x;
+      double sum = 0.0;
+      int count = 0;
+      const auto add = [&src, &sum, &count](int i, int j) { sum += src.at(i, j); count++; };
+
+      if (cy > 0)
+        add(cx, cy - 1);
+      if (cx > 0)
+        add(cx - 1, cy);
+      add(cx, cy);
+      if (cx < src.size)
+        add(cx + 1, cy);
+      if (cy < src.size)
+        add(cx, cy + 1);
+
+      row[x] = count == 5 ? sum * 0.2 : count == 4 ? sum * 0.25 : sum / 3.0;
     }
 
-    // Corner vertex of the last row.
-    grid.push_back((pp[0] + p[0] + p[1]) / 3.0);
-    pp += 2;
-    p += 2;
+    out.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(double));
+  }
+
+  out.close();
+  if (!out || !dst.file.open(path))
+    return false;
 
-    // Internal vertices of the last row.
-    for (int x = 1; x < s; x++, pp += 2, p += 2, pn += 2)
-      grid.push_back((pp[0] + p[-1] + p[0] + p[1]) * 0.25);
+  dst.size = s;
+  return true;
+}
 
-    // Corner vertex of the last row.
-    grid.push_back((pp[0] + p[-1] + p[0]) / 3.0);
+bool build_downsampled_grids(Pyramid& pyramid, int min_size, const stdfs::path& temp_dir)
+{
+  auto& grids = pyramid.grids;
+  std::reverse(std::begin(grids), std::end(grids));
+  while (grids.back()->size > min_size)
+  {
+    auto level = std::make_unique<Grid_level>();
+    const auto path = temp_dir / ("elevation_" + std::to_string(grids.size()) + ".raw");
+    if (!build_downsampled_grid(*grids.back(), path, *level))
+      return false;
 
-    grids.emplace_back(std::move(grid));
-    data = grids.back().data();
-    size = s;
+    grids.emplace_back(std::move(level));
   }
+
+  std::reverse(std::begin(grids), std::end(grids));
+  return true;
 }
 
 Vec2f clamp_uv(const Vec2f& uv)
@@ -368,6 +671,7 @@ bool extract_texture_fragment(
   int src_size,
   const Vec2i& start,
   int size,
+  const i3slib::utl::Png_encoding_params& png_params,
   i3slib::i3s::Texture_buffer& texture_buffer)
 {
   std::vector<char> texture(static_cast<size_t>(size) * size * 3);
@@ -427,7 +731,7 @@ bool extract_texture_fragment(
   // Encode to PNG.
   std::vector<uint8_t> png_bytes;
   if (!i3slib::utl::encode_png(
-        reinterpret_cast<uint8_t*>(texture.data()), size, size, false, png_bytes))
+        reinterpret_cast<uint8_t*>(texture.data()), size, size, false, png_bytes, png_params))
     return false;
 
   texture_buffer.meta.alpha_status = i3slib::i3s::Texture_meta::Alpha_status::Opaque;
@@ -445,25 +749,128 @@ bool extract_texture_fragment(
   return true;
 }
 
+// Edges of a square grid fragment.
+enum Grid_edge { Top = 1, Bottom = 2, Left = 4, Right = 8 };
+
+// Computes, for every node of a (size + 1) * (size + 1) elevation grid (size being a power of 2), the error of
+// the right-triangulated irregular network (RTIN) when this node is not a vertex, i.e. the max vertical
+// distance between the grid and the hypotenuse of any triangle split at this node or of any of its descendants.
+// Nodes on the locked edges get an infinite error, so these edges are kept at full resolution: the borders
+// shared with neighbor nodes of the same level are then identical on both sides, and crack-free.
+template<typename Get_elevation>
+std::vector<double> compute_rtin_errors(int size, const Get_elevation& get_elevation, int locked_edges)
+{
+  const auto stride = size + 1;
+  std::vector<double> errors(static_cast<size_t>(stride) * stride, 0.0);
+
+  constexpr double c_locked = std::numeric_limits<double>::infinity();
+  for (int i = 0; i <= size; i++)
+  {
+    if (locked_edges & Top)
+      errors[i] = c_locked;
+    if (locked_edges & Bottom)
+      errors[static_cast<size_t>(size) * stride + i] = c_locked;
+    if (locked_edges & Left)
+      errors[static_cast<size_t>(i) * stride] = c_locked;
+    if (locked_edges & Right)
+      errors[static_cast<size_t>(i) * stride + size] = c_locked;
+  }
+
+  // Triangles are visited from the smallest to the largest, so that errors of the children of
+  // a triangle are known when it is visited. Triangle i is identified by the path of its ancestors
+  // in the binary representation of (i + 2) ( the 2 root triangles being 2 and 3 ).
+  const int triangle_count = size * size * 2 - 2;
+  const int parent_triangle_count = triangle_count - size * size;
+  for (int i = triangle_count - 1; i >= 0; i--)
+  {
+    int id = i + 2;
+    int ax = 0, ay = 0, bx = 0, by = 0, cx = 0, cy = 0;
+    if (id & 1)
+      bx = by = cx = size;
+    else
+      ax = ay = cy = size;
+
+    while ((id >>= 1) > 1)
+    {
+      const int mx = (ax + bx) >> 1;
+      const int my = (ay + by) >> 1;
+      if (id & 1)
+      {
+        bx = ax;
+        by = ay;
+        ax = cx;
+        ay = cy;
+      }
+      else
+      {
+        ax = bx;
+        ay = by;
+        bx = cx;
+        by = cy;
+      }
+
+      cx = mx;
+      cy = my;
+    }
+
+    const int mx = (ax + bx) >> 1;
+    const int my = (ay + by) >> 1;
+    auto& error = errors[static_cast<size_t>(my) * stride + mx];
+    const double interpolated = (get_elevation(ax, ay) + get_elevation(bx, by)) * 0.5;
+    error = std::max(error, std::abs(interpolated - get_elevation(mx, my)));
+
+    if (i < parent_triangle_count)
+    {
+      // Children of the triangle are split at the middle of its legs.
+      error = std::max(error, errors[static_cast<size_t>((ay + cy) >> 1) * stride + ((ax + cx) >> 1)]);
+      error = std::max(error, errors[static_cast<size_t>((by + cy) >> 1) * stride + ((bx + cx) >> 1)]);
+    }
+  }
+
+  return errors;
+}
+
+// Emits the triangles ( a, b, c ) of the coarsest RTIN of the grid whose error does not exceed max_error.
+// ( a, b ) is the hypotenuse, c the right angle vertex.
+template<typename Emit_triangle>
+void select_rtin_triangles(
+  const std::vector<double>& errors, int size, double max_error,
+  int ax, int ay, int bx, int by, int cx, int cy, Emit_triangle& emit_triangle)
+{
+  const int mx = (ax + bx) >> 1;
+  const int my = (ay + by) >> 1;
+  if (std::abs(ax - cx) + std::abs(ay - cy) > 1 && errors[static_cast<size_t>(my) * (size + 1) + mx] > max_error)
+  {
+    select_rtin_triangles(errors, size, max_error, cx, cy, ax, ay, mx, my, emit_triangle);
+    select_rtin_triangles(errors, size, max_error, bx, by, cx, cy, mx, my, emit_triangle);
+  }
+  else
+    emit_triangle(Vec2i(ax, ay), Vec2i(bx, by), Vec2i(cx, cy));
+}
+
 // Extracts the fragment of the elevation grid starting at _start_ and spanning _size_ cells 
 // (i.e, size + 1 nodes) and extracts the fragment of color_data starting at texture_start
 // with texture_size * texture_size pixels.
+// If max_error is positive, the grid fragment is triangulated adaptively ( RTIN ), with vertical error up to
+// max_error * cell_factor, instead of 2 triangles per cell.
 
 bool build_mesh(
   const i3slib::i3s::Layer_writer& writer,
   const Vec2d& cell_size,
   int cell_factor,
-  const double* grid_data,
-  int grid_size,
+  const Grid_level& grid,
   const char* color_data,
   int color_size,
   const Vec2i& start,
   int size,
   const Vec2i& texture_start,
   int texture_size,
+  double max_error,
+  const i3slib::utl::Png_encoding_params& png_params,
   i3slib::i3s::Mesh_data& mesh,
   CS_transformation* transformation = nullptr)
 {
+  const auto grid_size = grid.size;
   I3S_ASSERT(start.x + size <= grid_size);
   I3S_ASSERT(start.y + size <= grid_size);
   I3S_ASSERT(texture_start.x + texture_size <= color_size);
@@ -472,9 +879,9 @@ bool build_mesh(
   const auto end = start + Vec2i(size, size);
   const double h = cell_factor * cell_size.x;
 
-  const auto get_elevation = [&grid_data, grid_size](int x, int y)
+  const auto get_elevation = [&grid](int x, int y)
   {
-    return grid_data[y * (grid_size + 1) + x];
+    return grid.at(x, y);
   };
 
   std::vector<Vec3d> verts;
@@ -518,7 +925,7 @@ bool build_mesh(
       add_quad(verts, uvs, vtx0, {0, v1}, vtx1, {0, v}, vtx2, {0, v}, vtx3, {0, v1});
     }
 
-    for (int dx = 0; dx < size; dx++)
+    for (int dx = 0; max_error <= 0.0 && dx < size; dx++)
     {
       const auto ind_x = start.x + dx;
       const auto ind_x1 = ind_x + 1;
@@ -572,6 +979,46 @@ bool build_mesh(
     }
   }
 
+  if (max_error > 0.0)
+  {
+    // Edges shared with other nodes keep all their vertices, to match the neighbors and the skirts.
+    int locked_edges = 0;
+    if (start.y != 0)
+      locked_edges |= Top;
+    if (end.y != grid_size)
+      locked_edges |= Bottom;
+    if (start.x != 0)
+      locked_edges |= Left;
+    if (end.x != grid_size)
+      locked_edges |= Right;
+
+    const auto get_node_elevation = [&start, &get_elevation](int dx, int dy)
+    {
+      return get_elevation(start.x + dx, start.y + dy);
+    };
+
+    const auto errors = compute_rtin_errors(size, get_node_elevation, locked_edges);
+
+    const auto add_vertex = [&](const Vec2i& node)
+    {
+      const auto ind = start + node;
+      verts.emplace_back((ind.x * cell_factor) * cell_size.x, -(ind.y * cell_factor) * cell_size.y, get_elevation(ind.x, ind.y));
+      uvs.push_back(clamp_uv(Vec2f(static_cast<float>(node.x) / size, static_cast<float>(node.y) / size)));
+    };
+
+    // RTIN triangles are clockwise in grid coordinates, i.e. counter-clockwise once the y axis is flipped.
+    auto add_triangle = [&add_vertex](const Vec2i& a, const Vec2i& b, const Vec2i& c)
+    {
+      add_vertex(a);
+      add_vertex(b);
+      add_vertex(c);
+    };
+
+    const auto tolerance = max_error * cell_factor;
+    select_rtin_triangles(errors, size, tolerance, 0, 0, size, size, size, 0, add_triangle);
+    select_rtin_triangles(errors, size, tolerance, size, size, 0, 0, 0, size, add_triangle);
+  }
+
   if (transformation)
     transformation->transform(verts.data(), verts.size());
   
@@ -581,18 +1028,29 @@ bool build_mesh(
   raw_mesh.uv = uvs.data();
 
   if (!extract_texture_fragment(
-        color_data, color_size, texture_start, texture_size, raw_mesh.img))
+        color_data, color_size, texture_start, texture_size, png_params, raw_mesh.img))
     return false;
 
   return writer.create_mesh_from_raw(raw_mesh, mesh) == IDS_I3S_OK;
 }
 
+// Number of nodes in the (full) subtree of a node at the given depth.
+i3slib::i3s::Node_id subtree_node_count(size_t depth, size_t depth_count)
+{
+  i3slib::i3s::Node_id count = 0;
+  for (; depth < depth_count; depth++)
+    count = count * 4 + 1;
+  return count;
+}
+
+// Node ids are assigned in post-order (children first, then their parent), starting at first_id.
+// Since the quadtree is full, ids of a subtree only depend on its position, so sibling subtrees
+// above parallel_depth are processed as concurrent tasks.
 bool process(
   i3slib::i3s::Layer_writer& writer,
   const int input_size,
   const Vec2d& cell_size,
-  const std::vector<std::vector<double>>& grids,
-  const std::vector<std::vector<char>>& textures,
+  const Pyramid& pyramid,
   int node_tris_size,
   int node_texture_size,
   int depth,
@@ -600,48 +1058,61 @@ bool process(
   const Vec2i& start,
   int texture_size,
   const Vec2i& texture_start,
-  i3slib::i3s::Node_id& node_id,
+  i3slib::i3s::Node_id first_id,
+  int parallel_depth,
+  double max_error,
+  const i3slib::utl::Png_encoding_params& png_params,
   CS_transformation* transformation = nullptr)
 {
+  const auto& grids = pyramid.grids;
+  const auto& textures = pyramid.textures;
   std::vector<i3slib::i3s::Node_id> node_ids;
 
-  if (depth + 1 < textures.size())
+  if (depth + 1 < grids.size())
   {
+    const auto child_node_count = subtree_node_count(depth + 1, grids.size());
+    const bool has_texture_level = depth + 1 < textures.size();
+
+    std::vector<std::future<bool>> tasks;
+    bool status = true;
     for (int i : { 0, 1 })
     {
       for (int j : { 0, 1 })
       {
-        const auto status = process(
-          writer, input_size, cell_size, grids, textures, node_tris_size, node_texture_size, depth + 1,
-          grid_size * 2, 2 * start + node_tris_size * Vec2i(j, i),
-          texture_size * 2, 2 * texture_start + node_texture_size * Vec2i(j, i),
-          node_id, transformation);
-
-        if (!status)
-          return false;
-
-        node_ids.push_back(node_id++);
+        const auto child_first_id = first_id + static_cast<i3slib::i3s::Node_id>(node_ids.size()) * child_node_count;
+        const auto process_child = [&, i, j, child_first_id]()
+        {
+          if (has_texture_level)
+          {
+            return process(
+              writer, input_size, cell_size, pyramid, node_tris_size, node_texture_size, depth + 1,
+              grid_size * 2, 2 * start + node_tris_size * Vec2i(j, i),
+              texture_size * 2, 2 * texture_start + node_texture_size * Vec2i(j, i),
+              child_first_id, parallel_depth, max_error, png_params, transformation);
+          }
+
+          return process(
+            writer, input_size, cell_size, pyramid, node_tris_size, node_texture_size / 2, depth + 1,
+            grid_size * 2, 2 * start + node_tris_size * Vec2i(j, i),
+            texture_size, texture_start + node_texture_size / 2 * Vec2i(j, i),
+            child_first_id, parallel_depth, max_error, png_params, transformation);
+        };
+
+        if (depth < parallel_depth)
+          tasks.emplace_back(std::async(std::launch::async, process_child));
+        else if (status)
+          status = process_child();
+
+        node_ids.push_back(child_first_id + child_node_count - 1);
       }
     }
-  }
-  else if (depth + 1 < grids.size())
-  {
-    for (int i : { 0, 1 })
-    {
-      for (int j : { 0, 1 })
-      {
-        const auto status = process(
-          writer, input_size, cell_size, grids, textures, node_tris_size, node_texture_size / 2, depth + 1,
-          grid_size * 2, 2 * start + node_tris_size * Vec2i(j, i),
-          texture_size, texture_start + node_texture_size / 2 * Vec2i(j, i),
-          node_id, transformation);
 
-        if (!status)
-          return false;
+    // All tasks must be over before returning, since they reference this frame.
+    for (auto& task : tasks)
+      status = task.get() && status;
 
-        node_ids.push_back(node_id++);
-      }
-    }
+    if (!status)
+      return false;
   }
 
   //
@@ -650,16 +1121,17 @@ bool process(
   node_data.children = std::move(node_ids);
   node_data.lod_threshold = screen_size_to_area(500);
 
-  const std::vector<char>& texture = depth < textures.size() ? textures[depth] : textures.back();
+  const auto& texture = depth < textures.size() ? *textures[depth] : *textures.back();
 
   const auto status = build_mesh(
     writer, cell_size, input_size / grid_size,
-    grids[depth].data(), grid_size, texture.data(), texture_size,
-    start, node_tris_size, texture_start, node_texture_size, node_data.mesh, transformation);
+    *grids[depth], texture.data(), texture_size,
+    start, node_tris_size, texture_start, node_texture_size, max_error, png_params, node_data.mesh, transformation);
 
   if (!status)
     return false;
 
+  const auto node_id = first_id + subtree_node_count(depth, grids.size()) - 1;
   return writer.create_node(node_data, node_id) == IDS_I3S_OK;
 }
 
@@ -667,10 +1139,12 @@ bool process(
 
 int main(int argc, char* argv[])
 {
-  if (argc != 7)
+  if (argc < 7 || argc > 11)
   {
     std::cout << "Usage:" << std::endl
-      << "raster2slpk <elevation_png> <color_png> <output_slpk_file> <x_step> <y_step> <z_unit>" << std::endl;
+      << "raster2slpk <elevation_png_or_raw> <color_png_or_raw> <output_slpk_file> <x_step> <y_step> <z_unit> [thread_count] [max_error] [ktx2_preset] [png_preset]" << std::endl
+      << "ktx2_preset: none, etc1s, etc1s_fast, uastc_rdo or uastc_hq" << std::endl
+      << "png_preset: fast, balanced or small, optionally suffixed with _libdeflate" << std::endl;
 
     return 1;
   }
@@ -681,47 +1155,78 @@ int main(int argc, char* argv[])
 
   const Vec2d cell_size(std::stod(argv[4]), std::stod(argv[5]));
   const double elevation_unit = std::stod(argv[6]);
+  const int thread_count = argc >= 8 && std::stoi(argv[7]) > 0 ? std::stoi(argv[7]) : static_cast<int>(std::thread::hardware_concurrency());
+  const double max_error = argc >= 9 ? std::stod(argv[8]) : 0.0;
+  const bool has_ktx2_preset = argc >= 10 && std::string(argv[9]) != "none";
+  const auto ktx2_preset = has_ktx2_preset ? parse_ktx2_preset(argv[9]) : std::nullopt;
+  if (has_ktx2_preset && !ktx2_preset)
+  {
+    std::cout << "Unknown KTX2 preset." << std::endl;
+    return 1;
+  }
+  const auto png_params = argc >= 11 ? parse_png_preset(argv[10]) : i3slib::utl::Png_encoding_params();
+  if (!png_params)
+  {
+    std::cout << "Unknown PNG preset." << std::endl;
+    return 1;
+  }
+  const auto start_time = std::chrono::steady_clock::now();
 
   //
-  int size;
-  std::vector<char> color_data;
-  if (!load_color_data(color_file_path, size, color_data))
+  Temp_dir temp_dir(stdfs::path(slpk_file_path).concat(".pyramid"));
+
+  Pyramid pyramid;
+  pyramid.textures.emplace_back(std::make_unique<Texture_level>());
+  if (!open_color_data(color_file_path, temp_dir.path(), *pyramid.textures.front()))
     return 1;
 
-  std::vector<double> elevation_data;
-  if (!load_elevation_data(elevation_file_path, size, elevation_data, elevation_unit))
+  const int size = pyramid.textures.front()->size;
+  if (size < 128)
+  {
+    std::cout << "Color bitmap size must be at least 128." << std::endl;
     return 1;
+  }
 
-  std::vector<std::vector<char>> textures;
-  textures.emplace_back(std::move(color_data));
-  build_downsampled_textures(size, textures.front().data(), 128, textures);
-  std::reverse(std::begin(textures), std::end(textures));
+  pyramid.grids.emplace_back(std::make_unique<Grid_level>());
+  if (!open_elevation_data(elevation_file_path, size, elevation_unit, temp_dir.path(), *pyramid.grids.front()))
+    return 1;
 
-  std::vector<std::vector<double>> grids;
-  grids.emplace_back(std::move(elevation_data));
-  build_downsampled_grids(size, grids.front().data(), 32, grids);
-  std::reverse(std::begin(grids), std::end(grids));
+  if (!build_downsampled_textures(pyramid, 128, temp_dir.path()) ||
+      !build_downsampled_grids(pyramid, 32, temp_dir.path()))
+  {
+    std::cout << "Failed to write the raster pyramid." << std::endl;
+    return 1;
+  }
 
   //
-  auto writer = create_writer(slpk_file_path);
+  auto writer = create_writer(slpk_file_path, ktx2_preset);
   if (!writer)
     return 1;
 
+  // Subtrees are processed concurrently down to the depth where there are enough of them to keep all threads busy.
+  int parallel_depth = 0;
+  for (int task_count = 1; task_count < thread_count && parallel_depth + 1 < static_cast<int>(pyramid.grids.size()); task_count *= 4)
+    parallel_depth++;
+
   ENU_to_WGS_transformation transformation({ -123.4583943, 47.6204856 });
-  i3slib::i3s::Node_id node_id = 0;
 
-  if(!process(*writer, size, cell_size, grids, textures, 32, 128, 0, 32, { 0, 0 }, 128, { 0, 0 }, node_id, &transformation))
+  if (!process(*writer, size, cell_size, pyramid, 32, 128, 0, 32, { 0, 0 }, 128, { 0, 0 }, 0, parallel_depth, max_error, *png_params, &transformation))
     return 1;
 
   // Add a root node on top of everything.
+  i3slib::i3s::Node_id node_id = subtree_node_count(0, pyramid.grids.size());
   i3slib::i3s::Simple_node_data node_data;
   node_data.node_depth = 0;
-  node_data.children.push_back(node_id++);
+  node_data.children.push_back(node_id - 1);
   if (writer->create_node(node_data, node_id) != IDS_I3S_OK)
     return 1;
 
   if (writer->save() != IDS_I3S_OK)
     return 1;
 
+  // Build time vs download size of the texture encoding settings:
+  const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+  std::error_code ec;
+  std::cout << "Built in " << elapsed.count() << " s, SLPK size: " << stdfs::file_size(slpk_file_path, ec) << " bytes." << std::endl;
   return 0;
 }
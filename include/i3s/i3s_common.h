@@ -28,6 +28,7 @@ email: contracts@esri.com
 #include "utils/utl_i3s_assert.h"
 #include <stdint.h>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <functional>
@@ -96,8 +97,9 @@ enum class Image_format : Image_formats {
 };
 
 
-I3S_EXPORT bool            from_string(const std::string& txt_utf8, Image_format* out);
+I3S_EXPORT bool            from_string(std::string_view txt_utf8, Image_format* out);
 I3S_EXPORT std::string     to_string(Image_format enc);
+I3S_EXPORT std::string_view to_string_view(Image_format enc);
 
 struct Obb
 {
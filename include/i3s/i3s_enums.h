@@ -20,6 +20,7 @@ email: contracts@esri.com
 #pragma once
 #include "utils/utl_i3s_export.h"
 #include <string>
+#include <string_view>
 
 //! -------------------------------------------------------------------------------
 //!      Formatting is used to generate to enum <--> string conversion code. 
@@ -0,0 +1,87 @@
+/*
+Copyright 2020 Esri
+
+Licensed under the Apache License, Version 2.0 (the "License"); you may not use
+this file except in compliance with the License. You may obtain a copy of
+the License at http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software distributed
+under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+CONDITIONS OF ANY KIND, either express or implied. See the License for the
+specific language governing permissions and limitations under the License.
+
+For additional information, contact:
+Environmental Systems Research Institute, Inc.
+Attn: Contracts Dept
+380 New York Street
+Redlands, California, USA 92373
+email: contracts@esri.com
+*/
+
+#pragma once
+#include "i3s/i3s_writer.h"
+#include "utils/utl_i3s_export.h"
+#include "utils/utl_geom.h"
+#include "utils/utl_declptr.h"
+#include <stdint.h>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace i3slib
+{
+
+namespace i3s
+{
+
+//! Camera of a frame. Positions and planes are in the cartesian space of the layer ( see Spatial_reference_xform::Sr_type::Dst_cartesian ).
+struct Lod_view
+{
+  std::array< utl::Vec4d, 6 > planes;     // frustum planes ( nx, ny, nz, d ) with unit normals pointing inside: p is inside if n.p + d >= 0.
+  utl::Vec3d                  eye;
+  double                      focal_length = 1.0; // in pixels: viewport_height / ( 2 * tan( fov_y / 2 ) )
+};
+
+//! LOD selection of a scene layer ( see create_lod_selector() ).
+struct Lod_selector_params
+{
+  Layer_type        layer_type = Layer_type::Mesh_3d;               // Layer_type::Point_cloud layers have PCSL node pages.
+  Lod_metric_type   metric_type = Lod_metric_type::Max_screen_area; // nodePages.lodSelectionMetricType of the layer
+  uint32_t          nodes_per_page = 64;
+  double            lod_factor = 1.0;           // scale of the LOD thresholds: above 1, coarser nodes are selected.
+  double            target_point_density = 1.0; // Lod_metric_type::Effective_density: points per pixel^2 below which nodes are refined.
+  int               max_fetch_count = 32;       // per frame
+  int               max_page_fetch_count = 4;   // per frame
+};
+
+//! Nodes selected for a view ( see Lod_selector::select() ). Nodes are identified by their index in the node pages.
+struct Lod_selection
+{
+  std::vector< uint32_t > render;       // resident nodes to draw, front to back.
+  std::vector< uint32_t > fetch;        // nodes to load, most important ( largest on screen ) first.
+  std::vector< uint32_t > page_fetch;   // node pages to load, most important first.
+  size_t                  visited = 0;  // nodes tested
+  size_t                  culled = 0;   // nodes outside of the frustum
+};
+
+//! View-dependent traversal of the node pages of a layer. Nodes are culled against the view frustum in batches and refined
+//! according to the LOD metric of the layer: a node is replaced by its children once the resources of all of them are resident.
+//! Not thread-safe.
+class Lod_selector
+{
+public:
+  DECL_PTR(Lod_selector);
+  virtual ~Lod_selector() = default;
+  //! json is the node page resource ( nodepages/<page_index> ). OBB centers are converted to cartesian space.
+  [[nodiscard]]
+  virtual status_t  add_node_page(uint32_t page_index, const std::string& json) = 0;
+  virtual bool      has_node_page(uint32_t page_index) const = 0;
+  //! Resources of the node loaded ( or evicted ) by the client.
+  virtual void      set_resident(uint32_t node, bool is_resident) = 0;
+  virtual void      select(const Lod_view& view, Lod_selection* out) = 0;
+};
+
+I3S_EXPORT Lod_selector* create_lod_selector(const Lod_selector_params& params, Spatial_reference_xform::cptr xform, utl::Basic_tracker* trk = nullptr);
+
+}
+
+} // namespace i3slib
@@ -24,6 +24,7 @@ email: contracts@esri.com
 #include "utils/utl_declptr.h"
 #include "utils/utl_gzip_context.h"
 #include "utils/utl_box.h"
+#include "utils/utl_png.h"
 #include <stdint.h>
 #include <unordered_map>
 #include <vector>
@@ -83,6 +84,25 @@ struct Simple_raw_mesh
   i3s::Rgba8 default_color{0xff};
 };
 
+struct Mesh_simplification_params
+{
+  int     target_face_count = 0;  // edge collapses stop once the mesh has at most this many triangles.
+  double  max_error = -1.0;       // if >= 0, edge collapses stop once the RMS distance to the source surface would exceed it ( cartesian units, e.g. meters ).
+  int     thread_count = 0;       // large meshes are split in clusters simplified concurrently. 0 means std::thread::hardware_concurrency().
+};
+
+//! Atlas of the base color textures of children with different materials ( see Layer_writer::create_parent_mesh() ).
+struct Texture_atlas_params
+{
+  int     max_size = 4096;        // maximum width and height of the atlas, in texels. Textures are downsampled further if they don't fit.
+  int     padding = 4;            // border texels replicated around each texture ( rounded up to a multiple of 4 ), so that mips don't bleed.
+  double  texel_scale = 0.5;      // scale of the child textures in the atlas ( a parent node is displayed at a lower resolution ).
+  bool    power_of_two = true;    // required for DDS encoding.
+};
+
+// default screen area ( in pixels^2 ) covered by a triangle of a parent node displayed at its lod_threshold ( see Layer_writer::create_parent_mesh() )
+constexpr double c_default_screen_area_per_triangle = 64.0;
+
 struct Simple_raw_points
 {
   int count{ 0 };
@@ -90,6 +110,51 @@ struct Simple_raw_points
   const uint64_t* fids{ nullptr };
 };
 
+//! Points of a point cloud scene layer ( see Pcsl_writer::add_points() ). Colors and intensities are optional.
+struct Simple_raw_point_cloud
+{
+  int count{ 0 };
+  const utl::Vec3d* abs_xyz{ nullptr }; // in the layer spatial reference
+  const utl::Rgb8* rgb{ nullptr };
+  const uint16_t* intensity{ nullptr };
+};
+
+//! Point cloud scene layer build ( see create_pcsl_builder() ).
+struct Pcsl_writer_params
+{
+  utl::Boxd   extent;                                 // of the points, in the layer spatial reference. Points outside are clamped to the border nodes.
+  bool        has_rgb = false;
+  bool        has_intensity = false;
+  int         max_points_per_node = 20000;            // leaf nodes hold at most this many points, parent nodes a subsample of this size.
+  utl::Vec3d  max_xyz_error{ 0.001, 0.001, 0.001 };   // LEPCC quantization, in the units of the layer spatial reference ( i.e. degrees for x and y in a GCS ).
+  size_t      memory_budget = size_t(1) << 30;        // bytes of points held in memory. Beyond, points are spilled to temporary files.
+  int         thread_count = 0;                       // 0: hardware concurrency
+};
+
+//! Basis Universal encoding of the Basis and KTX2 textures ( see set_basis_encoding() ). 
+//! Normal maps are always encoded to UASTC, without RDO.
+struct Basis_encoding_params
+{
+  enum class Codec { Etc1s, Uastc };
+  Codec   codec = Codec::Etc1s;
+  int     etc1s_quality = 128;        // [1, 255]: higher is larger and better.
+  int     etc1s_effort = 1;           // [0, 6]: basisu compression level, higher is slower and better.
+  int     uastc_level = 2;            // [0, 4]: basisu UASTC pack level, higher is slower and better.
+  float   uastc_rdo_lambda = 0.0f;    // > 0: UASTC rate-distortion optimization ( ~0.25 to 3 ), trades quality for a better supercompression.
+  int     zstd_level = 0;             // > 0: Zstd supercompression level of the UASTC textures ( ETC1S ones are always BasisLZ-compressed ).
+  bool    multithreading = false;     // whether an encoding is split in jobs run by a shared pool ( hardware concurrency threads ). One encoding uses it at a time: the other ones run on their calling thread.
+};
+
+enum class Basis_encoding_preset
+{
+  Etc1s_default,      // smallest download
+  Etc1s_fast,         // faster build, larger and lower quality
+  Uastc_rdo,          // much higher quality than ETC1S, RDO and Zstd keep the download size moderate
+  Uastc_high_quality  // close to BC7 quality, largest download
+};
+
+I3S_EXPORT Basis_encoding_params get_basis_encoding_params(Basis_encoding_preset preset);
+
 //! Create a opaque texture from a image buffer, no UV wrapping, not mipmap, no atlasing
 //! channel_count must be 3 or 4
 //! Byte order must be RGB(A) with R is LSB. 
@@ -181,6 +246,9 @@ enum class Gzip_draco { No, Yes };
 // Whether to write legacy documents
 enum class Write_legacy { No, Yes };
 
+// Whether Layer_writer::add_shard() should copy the shard resources to the output
+enum class Shard_resources { Append, Already_in_output };
+
 struct Writer_context
 {
   DECL_PTR(Writer_context);
@@ -189,6 +257,10 @@ struct Writer_context
   //typedef std::function< bool(const Texture_buffer& img, Texture_buffer* dst, i3slib::utl::Basis_output_format basis_out_fmt)> Encode_img_fct_basis;
   typedef std::function< bool(const Mesh_abstract& src, utl::Raw_buffer_view* out, Has_fids&, double scale_x, double scale_y)> Encode_geometry_fct;
   typedef std::function< Spatial_reference_xform::ptr(const i3s::Spatial_reference_desc& layer_sr, const i3s::Spatial_reference_desc* dst_sr )> Spatial_ref_factory_fct;
+  //! point_order receives the index ( in xyz ) of each encoded point. Attributes must be encoded in this order.
+  typedef std::function< bool(const utl::Vec3d* xyz, int count, const utl::Vec3d& max_error, utl::Raw_buffer_view* out, std::vector<uint32_t>* point_order)> Encode_lepcc_xyz_fct;
+  typedef std::function< bool(const utl::Rgb8* rgb, int count, utl::Raw_buffer_view* out)> Encode_lepcc_rgb_fct;
+  typedef std::function< bool(const uint16_t* intensity, int count, utl::Raw_buffer_view* out)> Encode_lepcc_intensity_fct;
 
   Encode_img_fct                      encode_to_jpeg;
   Encode_img_fct                      encode_to_png;
@@ -197,9 +269,18 @@ struct Writer_context
   Encode_img_fct                      encode_to_basis_ktx2_with_mips;
 
   Encode_geometry_fct                 encode_to_draco;
+  Encode_geometry_fct                 encode_to_draco_keep_face_order; // used instead of encode_to_draco when optimize_vertex_cache is set ( sequential Draco connectivity, larger than edgebreaker )
+  Encode_lepcc_xyz_fct                encode_to_lepcc_xyz;
+  Encode_lepcc_rgb_fct                encode_to_lepcc_rgb;
+  Encode_lepcc_intensity_fct          encode_to_lepcc_intensity;
   bool                                is_drop_region_if_not_repeated= true;
   bool                                draco_allow_large_fids = false;  // whether fid values >= 2^32 are allowed in draco metadata
+  bool                                optimize_vertex_cache = false;   // whether triangles and vertices of node meshes are reordered for vertex cache locality before encoding ( Draco then uses its sequential encoder, which keeps the face order but compresses less )
+  bool                                tight_node_obb = false;          // whether parent OBBs are searched on the convexoid of the merged child hulls ( slower, see utl::Pro_hull::Fit )
+  bool                                use_buffer_arena = false;        // whether per-node buffers are allocated from a per-thread utl::Buffer_arena ( fewer heap allocations, chunks may be kept alive longer )
   Write_legacy                        write_legacy = Write_legacy::Yes;
+  Basis_encoding_params               basis_encoding;                  // parameters of encode_to_basis_with_mips and encode_to_basis_ktx2_with_mips. Read-only: use set_basis_encoding()
+  utl::Png_encoding_params            png_encoding;                    // read by encode_to_png at encoding time ( see utl::get_png_encoding_params() for presets )
 
   utl::Basic_tracker*                 tracker() const { return decoder ? decoder->tracker() : nullptr; }
 
@@ -217,6 +298,12 @@ struct Writer_context
   i3s::Writer_finalization_mode         finalization_mode = i3s::Writer_finalization_mode::Finalize_output_stream;
   Gzip_with_monotonic_allocator         gzip_option = Gzip_with_monotonic_allocator::Yes;
   Gzip_draco                            gzip_draco{ Gzip_draco::Yes };
+  bool                                  write_behind_output{ false }; // SLPK is written by a dedicated I/O thread (see utl::Slpk_writer::Create_flag::Write_behind)
+  // write_behind_output only (see utl::Output_stream_async_params):
+  size_t                                write_behind_block_size{ 8 * 1024 * 1024 };
+  int                                   write_behind_block_count{ 4 };
+  bool                                  write_behind_direct_io{ false };
+  int                                   write_behind_sync_every_n_blocks{ 0 };
   Priority                              priority{ c_default_priority };
   Semantic                              semantic{ c_default_semantic };
 };
@@ -250,17 +337,80 @@ public:
   [[nodiscard]]
   virtual status_t   save(utl::Boxd* extent = nullptr) = 0;
 
+  // --- Sharded build: subtrees are built in separate SLPKs ( processes or machines ) and merged without re-encoding. 
+  // Node ids must be unique across all the shards of a layer.
+  //! Call instead of save(): remaining root(s) are written as children of parent_id ( to be created by the merging writer ) 
+  //! and the shard is finalized. 
+  [[nodiscard]]
+  virtual status_t   save_shard(Node_id parent_id) = 0;
+  //! Append all resources of a shard written by save_shard(). Its root(s) may then be used as children by create_node().
+  //! Layer meta and attribute definitions must be set first and match the shards'. Attribute statistics of shards are merged.
+  //! Use Shard_resources::Already_in_output for unchanged shards when updating a layer ( see create_mesh_layer_updater() ): 
+  //! the shard SLPK isn't needed then, its descriptor is read from the output where the appending add_shard() has kept it
+  //! ( shards are identified by the file name of shard_path ).
+  [[nodiscard]]
+  virtual status_t   add_shard(const std::filesystem::path& shard_path, Shard_resources res = Shard_resources::Append) = 0;
+
   //! Create Mesh_data from src mesh description. Vertex data will be deep-copied, but Texture_buffer will be shallow-copied.
   virtual status_t   create_mesh_from_raw(const Simple_raw_mesh& src, Mesh_data& dst) const = 0;
   virtual status_t   create_mesh_from_raw(const Simple_raw_points& src, Mesh_data& dst) const = 0;
+
+  //! Simplify the triangle mesh of src with quadric error metric edge collapses ( see Mesh_simplification_params ).
+  //! UVs, normals, colors, regions and feature ids are preserved: open borders and attribute seams are not collapsed,
+  //! so that the mesh still matches its neighbors. Material and attributes are shallow-copied.
+  virtual status_t   create_simplified_mesh(const Mesh_data& src, const Mesh_simplification_params& params, Mesh_data& dst) const = 0;
+  //! Create the mesh of a parent node from the meshes of its children, simplified to lod_threshold / screen_area_per_triangle triangles
+  //! ( lod_threshold being the Simple_node_data::lod_threshold of the parent ).
+  //! If the materials of the children differ, they may only have a base color texture: textures are packed in an atlas
+  //! and UVs are remapped to it ( with UV regions if some child textures are repeated or already are atlases ).
+  //! Attribute buffers are not merged.
+  virtual status_t   create_parent_mesh(
+    const std::vector<const Mesh_data*>& children,
+    double lod_threshold,
+    Mesh_data& dst,
+    double screen_area_per_triangle = c_default_screen_area_per_triangle,
+    int thread_count = 0,
+    const Texture_atlas_params& atlas_params = Texture_atlas_params()) const = 0;
+};
+
+//! Point cloud scene layer ( PCSL ) builder. Points are streamed in, binned and spilled to temporary files, then the LOD tree is 
+//! built in parallel: leaves hold at most Pcsl_writer_params::max_points_per_node points and parents a subsample of their children 
+//! of the same size ( one point per voxel ). Nodes are LEPCC-encoded ( XYZ, RGB and intensity ) and paged breadth-first.
+class Pcsl_writer
+{
+public:
+  DECL_PTR(Pcsl_writer);
+  virtual ~Pcsl_writer() = default;
+  //! Must be called before save(). meta.type is ignored ( Layer_type::Point_cloud ).
+  virtual void       set_layer_meta(const Layer_meta& meta) = 0;
+  //! Thread-safe. rgb and intensity must be provided if requested by Pcsl_writer_params.
+  [[nodiscard]]
+  virtual status_t   add_points(const Simple_raw_point_cloud& src) = 0;
+  //! Build and write the nodes, node pages and layer documents.
+  [[nodiscard]]
+  virtual status_t   save() = 0;
 };
 
 I3S_EXPORT Writer_context::Ptr create_i3s_writer_context(const Ctx_properties& prop, 
   Writer_finalization_mode finalization_mode = Writer_finalization_mode::Finalize_output_stream);
 
+//! Sets ctx.basis_encoding and the copy of it held by the Basis and KTX2 encoders installed by create_i3s_writer_context().
+//! Must not be called while ctx is used by a writer.
+I3S_EXPORT void set_basis_encoding(Writer_context& ctx, const Basis_encoding_params& params);
+
 I3S_EXPORT Layer_writer* create_mesh_layer_builder(Writer_context::Ptr ctx, const std::filesystem::path& path);
 I3S_EXPORT Layer_writer* create_mesh_layer_builder(Writer_context::Ptr ctx, std::shared_ptr<utl::Slpk_writer> slpk, int sublayer_id = -1);
 
+//! Update a layer built from shards ( see Layer_writer::save_shard() ) in place: only the shards that have changed are appended, 
+//! the other ones are added with Shard_resources::Already_in_output. Top-level nodes are re-created, then save() writes the node pages, 
+//! the layer documents and a new central directory. Replaced resources are left in the SLPK until utl::compact_slpk() is run.
+//! The nodes above the shard roots must all be re-created by the caller with create_node(), as for the initial merge: their OBB 
+//! and MBS are recomputed from their children ( hence from the updated shard roots ), but Simple_node_data::lod_threshold and 
+//! the mesh of these nodes are the caller's: they must be recomputed if the change of a shard affects them.
+I3S_EXPORT Layer_writer* create_mesh_layer_updater(Writer_context::Ptr ctx, const std::filesystem::path& path);
+
+I3S_EXPORT Pcsl_writer* create_pcsl_builder(Writer_context::Ptr ctx, const std::filesystem::path& path, const Pcsl_writer_params& params);
+
 }
 
 } // namespace i3slib
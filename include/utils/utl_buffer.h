@@ -22,6 +22,7 @@ email: contracts@esri.com
 #include "utils/utl_i3s_assert.h"
 #include "utils/utl_i3s_export.h"
 #include <cstring>
+#include <cstdint>
 
 #pragma warning(push)
 #pragma warning(disable:4251)
@@ -32,8 +33,10 @@ namespace i3slib
 namespace utl
 {
   
-enum class Buffer_memory_ownership :int { Shallow = 0, Deep, Deep_aligned };
+enum class Buffer_memory_ownership :int { Shallow = 0, Deep, Deep_aligned, Arena }; // Arena: see Buffer_arena
 class Buffer;
+class Buffer_arena;
+namespace detail { struct Buffer_arena_chunk; }
 
 //! Typed view of a buffer. Underlying buffer is ref_counted so the Buffer_view control the lifetime of the underlying buffer
 //! T may be const or non const type.
@@ -133,6 +136,10 @@ public:
   const char*         data() const { return m_rw_ptr; }
 
 private:
+  friend class Buffer_arena;
+  //! Allocates from the arena of the current thread, if any ( see Buffer_arena_scope ).
+  static Buffer::Ptr  _create(int size_in_bytes);
+
   union
   {
     //TBD: To work-around const-correctness for shared raw pointer from outside.
@@ -143,6 +150,49 @@ private:
   Memory          m_mode = Memory::Shallow;
 };
 
+//! Monotonic allocator of per-node Buffer memory: payloads and the Buffer objects themselves ( with their shared_ptr
+//! control blocks ) are carved out of large chunks. A chunk is freed when the last buffer allocated in it is destroyed,
+//! so Buffer_view lifetime semantics are unchanged, but a long-lived small buffer keeps its whole chunk alive.
+//! Allocations larger than chunk_size / 4 get a dedicated chunk.
+//! **Not thread-safe**: an arena must be used by a single thread at a time ( typically a thread_local one ).
+class I3S_EXPORT Buffer_arena
+{
+public:
+  DECL_PTR(Buffer_arena);
+  static constexpr int c_default_chunk_size = 1 << 20;
+
+  explicit Buffer_arena(int chunk_size = c_default_chunk_size);
+  ~Buffer_arena();
+  Buffer_arena(const Buffer_arena&) = delete;
+  Buffer_arena& operator=(const Buffer_arena&) = delete;
+
+  uint64_t  get_allocation_count() const { return m_allocation_count; }
+  uint64_t  get_chunk_count() const { return m_chunk_count; } // i.e. calls to the heap
+
+private:
+  friend class Buffer;
+  Buffer::Ptr   _create_buffer(int size_in_bytes);
+
+  std::shared_ptr< detail::Buffer_arena_chunk > m_chunk; // current one
+  int           m_chunk_size;
+  uint64_t      m_allocation_count = 0;
+  uint64_t      m_chunk_count = 0;
+};
+
+//! While in scope, Buffer::create_writable_typed_view(), Buffer::create_deep_copy() and Buffer::create_writable_view()
+//! allocate from arena on the calling thread. Scopes may be nested. A null arena leaves the current one unchanged.
+class I3S_EXPORT Buffer_arena_scope
+{
+public:
+  explicit Buffer_arena_scope(Buffer_arena* arena);
+  ~Buffer_arena_scope();
+  Buffer_arena_scope(const Buffer_arena_scope&) = delete;
+  Buffer_arena_scope& operator=(const Buffer_arena_scope&) = delete;
+
+private:
+  Buffer_arena* m_previous;
+};
+
 
 
 // ----------- inline implementation: ----------------
@@ -185,13 +235,13 @@ inline Buffer_view<T>& Buffer_view<T>::operator=(const Buffer_view<Mutable_T>& s
 
 template<class T > inline Buffer_view<T>  Buffer::create_writable_typed_view(int size)
 {
-  auto buff = std::make_shared< Buffer >((int)(sizeof(T)*size));
+  auto buff = _create((int)(sizeof(T)*size));
   return Buffer_view<T>(buff, reinterpret_cast<T*>(buff->m_rw_ptr), size);
 }
 
 template<class T > inline Buffer_view<T> Buffer::create_deep_copy(const T* src, int size)
 {
-  auto buff = std::make_shared< Buffer >((int)(sizeof(T)*size));
+  auto buff = _create((int)(sizeof(T)*size));
   auto ret = Buffer_view<T>(buff, reinterpret_cast<T*>(buff->m_rw_ptr), size);
   std::memcpy(ret.data(), src, size * sizeof(T));
   return ret;
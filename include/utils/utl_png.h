@@ -71,7 +71,44 @@ private:
   std::unique_ptr<Png_writer_impl> m_pimpl;
 };
 
-I3S_EXPORT bool encode_png(const uint8_t* raw_bytes, int w, int h, bool has_alpha, std::vector<uint8_t>& png_bytes);
+//! util class to read (sequentially) a non-interlaced PNG file, a few rows at a time, without decoding the whole image.
+//! Pixel layout is the same as read_png_from_file()'s.
+class Png_reader_impl;
+class Png_reader
+{
+public:
+  I3S_EXPORT Png_reader();
+  I3S_EXPORT ~Png_reader();
+  I3S_EXPORT bool open(const std::filesystem::path& file_name, int* out_w, int* out_h, int* out_bytes_per_pixel = nullptr);
+
+  I3S_EXPORT bool read_rows(int n_rows, char* buffer, int n_bytes);
+
+private:
+  std::unique_ptr<Png_reader_impl> m_pimpl;
+};
+
+//! PNG encoder settings ( see i3s::Writer_context::png_encoding ).
+struct Png_encoding_params
+{
+  //! Filter applied to every row before deflate. Adaptive picks the best of the five filters per row ( minimum sum of absolute differences ), at about twice the cost.
+  enum class Filter { Adaptive, None, Sub, Up, Average, Paeth };
+  int     zlib_level = -1;              // [0, 9]: higher is slower and smaller, -1: zlib default ( 6 ).
+  Filter  filter = Filter::Adaptive;
+  bool    use_libdeflate = false;       // whether IDAT is compressed in one shot by libdeflate ( faster than zlib at the same level ). Ignored if not built with USE_LIBDEFLATE.
+};
+
+//! Balanced ( libpng defaults ) is the default. The other presets and libdeflate are opt-in.
+enum class Png_encoding_preset
+{
+  Fast,       // zlib level 1, Up filter
+  Balanced,   // zlib default level, adaptive filtering ( default )
+  Small       // zlib level 9, adaptive filtering
+};
+
+I3S_EXPORT Png_encoding_params get_png_encoding_params(Png_encoding_preset preset);
+
+I3S_EXPORT bool encode_png(const uint8_t* raw_bytes, int w, int h, bool has_alpha, std::vector<uint8_t>& png_bytes
+                           , const Png_encoding_params& params = Png_encoding_params());
 
 }//endof ::utl
 
@@ -29,6 +29,7 @@ email: contracts@esri.com
 #include <sstream>
 #include <array>
 #include <cstring>
+#include <string_view>
 
 #pragma warning(push)
 #pragma warning(disable:4251)
@@ -224,6 +225,8 @@ public:
   std::string               get_parse_error_string() const;
   void                      clear_unsuppressed_error();
   void                      set_basic_parse_error_string(const std::string& s);
+  //! Loads a string value without copying it if the archive allows it. The view is valid until the next load.
+  bool                      load_string_view(std::string_view* v) { if (has_parse_error()) return false; _load_string_view(v); return !has_parse_error(); }
   friend Archive_in& operator&(Archive_in& in, bool& v) { if (in.has_parse_error()) return in; Variant wrap(&v, Variant::Memory::Shared);  in._load_variant(wrap); return in; }
   friend Archive_in& operator&(Archive_in& in, char& v) { if (in.has_parse_error()) return in; Variant wrap(&v, Variant::Memory::Shared);  in._load_variant(wrap); return in; }
   friend Archive_in& operator&(Archive_in& in, int8_t& v) { if (in.has_parse_error()) return in; Variant wrap(&v, Variant::Memory::Shared);  in._load_variant(wrap); return in; }
@@ -266,6 +269,7 @@ protected:
   //virtual int     _load_array_size() = 0;
   //virtual void    _load_array(char* ptr, int nBytes) = 0;
   virtual void    _load_unparsed_node(Unparsed_field& node) = 0;
+  virtual void    _load_string_view(std::string_view* v) { Variant wrap(&m_string_scratch, Variant::Memory::Shared); _load_variant(wrap); *v = m_string_scratch; }
   virtual std::string       _get_locator() const { return std::string(); } //experimental for better error reporting.
   virtual int     _get_rtti_code() = 0;
   struct Parse_error
@@ -283,6 +287,7 @@ protected:
   std::vector<Parse_error>  m_suppressed_log;
   Parse_error m_unsuppressed_error = {Json_parse_error::Error::Not_set, "", ""};
   std::string m_basic_parse_error_string = "";
+  std::string m_string_scratch; // see _load_string_view()
 private:
   bool has_unsuppressed_error() const;
 
@@ -331,6 +336,8 @@ public:
   template< class T > friend Archive_out& operator&(Archive_out& out, const Nvp< T >& v);
   template< class T, class Y > friend  Archive_out& operator&(Archive_out& out, const Nvp_opt< T, Y >& v);
   inline constexpr void          set_flags(Archive_out_flags flags) { m_flags = flags; }
+  //! Saves a string value without copying it if the archive allows it.
+  void                           save_string_view(std::string_view v) { _save_string_view(v); }
   //for symmetry with Archive_in:
   inline constexpr void          report_parsing_error(Json_parse_error::Error, const std::string&) noexcept {}
   inline constexpr void          report_parsing_error(Json_parse_error::Error, const char*) noexcept {}
@@ -346,6 +353,7 @@ protected:
   virtual void    _write_seq_separator() = 0;
   virtual void    _close_seq() {};
   virtual void    _save_variant(const Variant& v) = 0;
+  virtual void    _save_string_view(std::string_view v) { _save_variant(Variant(std::string(v))); }
   virtual void    _save_binary_blob(const Binary_blob_const& blob) = 0;
   virtual void    _save_unparsed_node(utl::Unparsed_field& node) = 0;
   virtual void    _set_rtti_code(int code) = 0;
@@ -630,15 +638,11 @@ inline void Archive_in::report_parsing_error(Json_parse_error::Error what, std::
 
 template< class T > inline Archive_in& operator&(Archive_in& in, Enum_str<T>& v)
 {
-  if (in.has_parse_error()) return in;
-
-  std::string tmp;
-  Variant wrap(&tmp, Variant::Memory::Shared);
-  in._load_variant(wrap);
-  if (in.has_parse_error()) return in;
+  std::string_view tmp;
+  if (!in.load_string_view(&tmp)) return in;
   if (!from_string(tmp, &v.val_ref))
   {
-    in.report_parsing_error(Json_parse_error::Error::Unknown_enum, tmp);
+    in.report_parsing_error(Json_parse_error::Error::Unknown_enum, std::string(tmp));
   }
   return in;
 }
@@ -773,7 +777,7 @@ template< class T, class Y > inline Archive_in& operator&(Archive_in& in, Nvp_op
 
 template< class T > inline Archive_out& operator&(Archive_out& out, const Enum_str<T>& v)
 {
-  out._save_variant(Variant(to_string(v.val_ref)));
+  out._save_string_view(to_string_view(v.val_ref));
   return out;
 }
 
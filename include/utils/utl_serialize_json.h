@@ -45,6 +45,7 @@ protected:
   I3S_EXPORT virtual void    _write_seq_separator() override;
   I3S_EXPORT virtual void    _close_seq() override;
   I3S_EXPORT virtual void    _save_variant(const Variant& v) override;
+  I3S_EXPORT virtual void    _save_string_view(std::string_view v) override;
   //virtual bool    _saveArraySize(int s)   override;
   //virtual void    _saveArray(const char* ptr, int nBytes) override;
   I3S_EXPORT virtual void    _save_binary_blob(const Binary_blob_const& blob) override;
@@ -55,6 +55,7 @@ class  Archive_in_json_dom final: public Archive_in
     virtual int     _open_sequence() override;
     virtual int     _read_seq_separator() override;
     virtual void    _load_variant(Variant& v) override;
+    virtual void    _load_string_view(std::string_view* v) override;
     //virtual int     _load_array_size()  override;
     //virtual void    _load_array(char* ptr, int nBytes) override;
     virtual void    _load_binary_blob(Binary_blob& blob) override;
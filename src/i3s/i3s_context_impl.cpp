@@ -25,7 +25,9 @@ email: contracts@esri.com
 #include "utils/utl_image_2d.h"
 #include "i3s/i3s_legacy_mesh.h"
 #include "lepcc_tpl_api.h"
+#include "lepcc_c_api.h"
 #include "utils/utl_geographic.h"
+#include "utils/utl_colors.h"
 
 #include <stdint.h>
 
@@ -100,8 +102,11 @@ static bool  compress_to_dds_with_mipmaps(const Texture_buffer& img, Texture_buf
   }
 
   utl::Buffer_view< char > dds;
-  I3S_ASSERT_EXT((int)img.meta.alpha_status != -1); // ALPHA status must have been set at this point.
-  if (!compress_to_dds_with_mips(src, img.meta.alpha_status != Texture_meta::Alpha_status::Opaque, &dds))
+  // Decoders only report Mask_or_blend ( and Not_set is possible ), so classify the pixels in that case:
+  bool has_alpha = img.meta.alpha_status != Texture_meta::Alpha_status::Opaque;
+  if ((int)img.meta.alpha_status < 0)
+    has_alpha = utl::get_alpha_bits(static_cast<const utl::Rgba8*>(src.data()), (size_t)w * h) != 0;
+  if (!compress_to_dds_with_mips(src, has_alpha, &dds))
     return false;
 
   dds_buffer->data = dds;
@@ -135,6 +140,74 @@ i3s::Mesh_abstract::Ptr decode_lepcc(const utl::Vec3d& origin, const utl::Raw_bu
   return i3s::Mesh_abstract::Ptr(i3s::parse_mesh_from_bulk(*dst));
 }
 
+namespace
+{
+
+class Lepcc_encoder
+{
+public:
+  Lepcc_encoder() : m_ctx(lepcc_createContext()) {}
+  ~Lepcc_encoder() { lepcc_deleteContext(&m_ctx); }
+  Lepcc_encoder(const Lepcc_encoder&) = delete;
+  Lepcc_encoder& operator=(const Lepcc_encoder&) = delete;
+
+  lepcc_ContextHdl get() const { return m_ctx; }
+
+  // Second step of the encoding ( after lepcc_computeCompressedSizeXXX() ):
+  template< class Encode_fct >
+  bool encode(unsigned int n_bytes, utl::Raw_buffer_view* out, Encode_fct encode_fct)
+  {
+    auto dst = utl::Buffer::create_writable_typed_view<char>(static_cast<int>(n_bytes));
+    auto ptr = reinterpret_cast<unsigned char*>(dst.data());
+    if (encode_fct(&ptr, static_cast<int>(n_bytes)) != c_ok)
+      return false;
+    *out = dst;
+    return true;
+  }
+
+  static constexpr lepcc_status c_ok = static_cast<lepcc_status>(lepcc::ErrCode::Ok);
+
+private:
+  lepcc_ContextHdl m_ctx;
+};
+
+bool encode_lepcc_xyz(const utl::Vec3d* xyz, int count, const utl::Vec3d& max_error, utl::Raw_buffer_view* out, std::vector<uint32_t>* point_order)
+{
+  static_assert(sizeof(utl::Vec3d) == 3 * sizeof(double), "unexpected size");
+  Lepcc_encoder lepcc;
+  point_order->resize(count);
+  unsigned int n_bytes = 0;
+  if (lepcc_computeCompressedSizeXYZ(lepcc.get(), static_cast<unsigned int>(count), reinterpret_cast<const double*>(xyz),
+    max_error.x, max_error.y, max_error.z, &n_bytes, point_order->data()) != Lepcc_encoder::c_ok)
+    return false;
+  return lepcc.encode(n_bytes, out, [&lepcc](unsigned char** ptr, int size) { return lepcc_encodeXYZ(lepcc.get(), ptr, size); });
+}
+
+bool encode_lepcc_rgb(const utl::Rgb8* rgb, int count, utl::Raw_buffer_view* out)
+{
+  static_assert(sizeof(utl::Rgb8) == 3, "unexpected size");
+  Lepcc_encoder lepcc;
+  unsigned int n_bytes = 0;
+  if (lepcc_computeCompressedSizeRGB(lepcc.get(), static_cast<unsigned int>(count), reinterpret_cast<const unsigned char*>(rgb), &n_bytes) 
+    != Lepcc_encoder::c_ok)
+    return false;
+  return lepcc.encode(n_bytes, out, [&lepcc](unsigned char** ptr, int size) { return lepcc_encodeRGB(lepcc.get(), ptr, size); });
+}
+
+bool encode_lepcc_intensity(const uint16_t* intensity, int count, utl::Raw_buffer_view* out)
+{
+  Lepcc_encoder lepcc;
+  unsigned int n_bytes = 0;
+  if (lepcc_computeCompressedSizeIntensity(lepcc.get(), static_cast<unsigned int>(count), intensity, &n_bytes) != Lepcc_encoder::c_ok)
+    return false;
+  return lepcc.encode(n_bytes, out, [&lepcc, intensity, count](unsigned char** ptr, int size)
+  { 
+    return lepcc_encodeIntensity(lepcc.get(), ptr, size, intensity, static_cast<unsigned int>(count)); 
+  });
+}
+
+} // namespace
+
 #ifndef NO_DRACO_SUPPORT
 
 extern "C"
@@ -279,7 +352,7 @@ struct Unindexed_mesh
   }
 };
 // Note: scalex/y will be applied to src.relative_position .
-static bool compress_to_draco(const Mesh_abstract& src, utl::Raw_buffer_view* out, Has_fids & fids, double scale_x, double scale_y)
+static bool compress_to_draco(const Mesh_abstract& src, utl::Raw_buffer_view* out, Has_fids & fids, double scale_x, double scale_y, bool keep_face_order = false)
 {
   //draco_compressed_buffer dst;
   Unindexed_mesh um;
@@ -297,6 +370,7 @@ static bool compress_to_draco(const Mesh_abstract& src, utl::Raw_buffer_view* ou
 
   dm.pos_scale_x = scale_x;
   dm.pos_scale_y = scale_y;
+  dm.keep_face_order = keep_face_order;
 
   char* ptr_out = nullptr;
   int  size = 0;
@@ -403,7 +477,7 @@ static bool compress_to_ktx_with_mipmaps(const Texture_buffer& img, Texture_buff
 
 #ifndef NO_BASIS_ENCODER_SUPPORT
 
-static bool compress_to_basis_ktx2_with_mipmaps(const i3s::Texture_buffer& img, i3s::Texture_buffer* basis_buffer)
+static bool compress_to_basis_ktx2_with_mipmaps(const i3s::Texture_buffer& img, i3s::Texture_buffer* basis_buffer, const Basis_encoding_params& params)
 {
   if (img.meta.format != i3s::Image_format::Raw_rgba8
     && img.meta.format != i3s::Image_format::Raw_rgb8)
@@ -416,7 +490,9 @@ static bool compress_to_basis_ktx2_with_mipmaps(const i3s::Texture_buffer& img,
   if (!utl::compress_to_basis_with_mips(img.data.data()
     , img.width(), img.height()
     , img.meta.format == i3s::Image_format::Raw_rgb8 ? 3 : 4
-    , basis)
+    , basis
+    , img.meta.semantic
+    , params)
     )
     return false;
 
@@ -429,13 +505,22 @@ static bool compress_to_basis_ktx2_with_mipmaps(const i3s::Texture_buffer& img,
 }
 
 // TODO: eliminate i3s::Image_format::Basis and the function
-static bool compress_to_basis_with_mipmaps(const i3s::Texture_buffer& img, i3s::Texture_buffer* basis_buffer)
+static bool compress_to_basis_with_mipmaps(const i3s::Texture_buffer& img, i3s::Texture_buffer* basis_buffer, const Basis_encoding_params& params)
 {
-  bool res = compress_to_basis_ktx2_with_mipmaps(img, basis_buffer);
+  bool res = compress_to_basis_ktx2_with_mipmaps(img, basis_buffer, params);
   basis_buffer->meta.format = i3s::Image_format::Basis;
   return res;
 }
 
+//! Encode_img_fct of the Basis / KTX2 encoders, with its own copy of the parameters ( see set_basis_encoding() ).
+struct Basis_encoder
+{
+  bool (*encode)(const i3s::Texture_buffer& img, i3s::Texture_buffer* dst, const Basis_encoding_params& params);
+  Basis_encoding_params params;
+
+  bool operator()(const Texture_buffer& img, Texture_buffer* dst) const { return encode(img, dst, params); }
+};
+
 #endif // NO_BASIS_ENCODER_SUPPORT
 
 #ifndef NO_BASIS_TRANSCODER_SUPPORT
@@ -444,24 +529,23 @@ static bool transcode_basis(const Texture_buffer& img, Texture_buffer* dds_buffe
   if (img.meta.format == Image_format::Basis || img.meta.format == Image_format::Ktx2)
   {
     I3S_ASSERT_EXT((int)img.meta.alpha_status != -1); // ALPHA status must have been set at this point.
-    std::vector<uint8_t> out_buffer;
-
-    if (to_img_fmt == Image_format::Dds)
-    {
-      utl::transcode_basis_to_dds(img.data.data(), img.data.size(), &out_buffer, img.meta.alpha_status != Texture_meta::Alpha_status::Opaque);
-
-      dds_buffer->data = utl::Buffer::create_deep_copy((const char*)out_buffer.data(), (int)out_buffer.size());
-      dds_buffer->meta = img.meta;
-      dds_buffer->meta.mip_count = -1; //dunno. 
-      dds_buffer->meta.format = to_img_fmt;
 
-      return true;
-    }
-    else if (to_img_fmt == Image_format::Ktx)
+    if (to_img_fmt == Image_format::Dds || to_img_fmt == Image_format::Ktx)
     {
-      utl::transcode_basis_to_ktx(img.data.data(), img.data.size(), &out_buffer, img.meta.alpha_status != Texture_meta::Alpha_status::Opaque);
-
-      dds_buffer->data = utl::Buffer::create_deep_copy((const char*)out_buffer.data(), (int)out_buffer.size());
+      // transcoded in place:
+      utl::Raw_buffer_view out_buffer;
+      if (!utl::transcode_basis_to_container(img.data.data(), img.data.size()
+        , to_img_fmt == Image_format::Dds ? utl::Mip_container::Dds : utl::Mip_container::Ktx
+        , img.meta.alpha_status != Texture_meta::Alpha_status::Opaque
+        , [&out_buffer](size_t size)
+        {
+          auto buff = utl::Buffer::create_writable_view(nullptr, static_cast<int>(size));
+          out_buffer = buff;
+          return buff.data();
+        }))
+        return false; // the ( uninitialized ) output buffer is dropped
+
+      dds_buffer->data = out_buffer;
       dds_buffer->meta = img.meta;
       dds_buffer->meta.mip_count = -1; //dunno. 
       dds_buffer->meta.format = to_img_fmt;
@@ -599,7 +683,7 @@ static bool raw_to_jpg(const Texture_buffer& img, Texture_buffer* dst)
 
 }
 
-static bool raw_to_png(const Texture_buffer& img, Texture_buffer* dst)
+static bool raw_to_png(const Texture_buffer& img, Texture_buffer* dst, const utl::Png_encoding_params& params)
 {
   I3S_ASSERT(img.meta.format == Image_format::Raw_rgb8 || img.meta.format == Image_format::Raw_rgba8);
   I3S_ASSERT(img.meta.mip_count == 1 && img.width() > 0 && img.height() > 0);
@@ -610,7 +694,8 @@ static bool raw_to_png(const Texture_buffer& img, Texture_buffer* dst)
         img.width(),
         img.height(),
         img.meta.format == Image_format::Raw_rgba8,
-        png_blob))
+        png_blob,
+        params))
     return false;
 
   dst->data =
@@ -663,7 +748,7 @@ struct Builder_context_impl : public Writer_context
     //typedef std::function< bool(const Texture_buffer& img, Texture_buffer* dst)> Encode_img_fct;
   #ifndef WASM
     encode_to_jpeg = raw_to_jpg;
-    encode_to_png = raw_to_png;
+    encode_to_png = [this](const Texture_buffer& img, Texture_buffer* dst) { return raw_to_png(img, dst, png_encoding); };
   #endif
   }
 
@@ -671,6 +756,31 @@ private:
 };
 
 
+Basis_encoding_params get_basis_encoding_params(Basis_encoding_preset preset)
+{
+  Basis_encoding_params params;
+  switch (preset)
+  {
+    case Basis_encoding_preset::Etc1s_fast:
+      params.etc1s_effort = 0;
+      break;
+    case Basis_encoding_preset::Uastc_rdo:
+      params.codec = Basis_encoding_params::Codec::Uastc;
+      params.uastc_level = 2;
+      params.uastc_rdo_lambda = 1.0f;
+      params.zstd_level = 9;
+      break;
+    case Basis_encoding_preset::Uastc_high_quality:
+      params.codec = Basis_encoding_params::Codec::Uastc;
+      params.uastc_level = 3;
+      params.zstd_level = 9;
+      break;
+    default:
+      break;
+  }
+  return params;
+}
+
 Writer_context::Ptr create_i3s_writer_context(
   const Ctx_properties& _prop, Writer_finalization_mode finalization_mode)
 {
@@ -686,21 +796,33 @@ Writer_context::Ptr create_i3s_writer_context(
 
 #ifndef NO_BASIS_ENCODER_SUPPORT
   if (prop.gpu_tex_encoding_support & (GPU_texture_compression_flags)GPU_texture_compression::Basis)
-    builder_ctx->encode_to_basis_with_mips = compress_to_basis_with_mipmaps;
+    builder_ctx->encode_to_basis_with_mips = Basis_encoder{ compress_to_basis_with_mipmaps, builder_ctx->basis_encoding };
   if (prop.gpu_tex_encoding_support & (GPU_texture_compression_flags)GPU_texture_compression::KTX2)
-      builder_ctx->encode_to_basis_ktx2_with_mips = compress_to_basis_ktx2_with_mipmaps;
+    builder_ctx->encode_to_basis_ktx2_with_mips = Basis_encoder{ compress_to_basis_ktx2_with_mipmaps, builder_ctx->basis_encoding };
 #endif
   set_gpu_compression(prop.gpu_tex_encoding_support, GPU_texture_compression::Basis, (bool)builder_ctx->encode_to_basis_with_mips);
   set_gpu_compression(prop.gpu_tex_encoding_support, GPU_texture_compression::KTX2, (bool)builder_ctx->encode_to_basis_ktx2_with_mips);
 
 #ifndef NO_DRACO_SUPPORT
   if (prop.geom_encoding_support & (Geometry_compression_flags)Geometry_compression::Draco)
-    builder_ctx->encode_to_draco = compress_to_draco;
+  {
+    builder_ctx->encode_to_draco = [](const Mesh_abstract& src, utl::Raw_buffer_view* out, Has_fids& fids, double scale_x, double scale_y)
+    {
+      return compress_to_draco(src, out, fids, scale_x, scale_y);
+    };
+    builder_ctx->encode_to_draco_keep_face_order = [](const Mesh_abstract& src, utl::Raw_buffer_view* out, Has_fids& fids, double scale_x, double scale_y)
+    {
+      return compress_to_draco(src, out, fids, scale_x, scale_y, true);
+    };
+  }
 #endif
   set_geom_compression(prop.gpu_tex_encoding_support, Geometry_compression::Draco, (bool)builder_ctx->encode_to_draco);
 
   //always on (build)
   set_geom_compression(prop.geom_encoding_support, Geometry_compression::Lepcc, true);
+  builder_ctx->encode_to_lepcc_xyz = encode_lepcc_xyz;
+  builder_ctx->encode_to_lepcc_rgb = encode_lepcc_rgb;
+  builder_ctx->encode_to_lepcc_intensity = encode_lepcc_intensity;
 
   // default SR helper doesn't project: 
   builder_ctx->sr_helper_factory = [](const i3s::Spatial_reference_desc& layer_sr, const i3s::Spatial_reference_desc* dst_sr)
@@ -711,6 +833,19 @@ Writer_context::Ptr create_i3s_writer_context(
   return builder_ctx;
 }
 
+void set_basis_encoding(Writer_context& ctx, const Basis_encoding_params& params)
+{
+  ctx.basis_encoding = params;
+#ifndef NO_BASIS_ENCODER_SUPPORT
+  // the encoders installed by create_i3s_writer_context() ( client-provided ones are left as is ):
+  for (auto* fct : { &ctx.encode_to_basis_with_mips, &ctx.encode_to_basis_ktx2_with_mips })
+  {
+    if (auto encoder = fct->target<Basis_encoder>())
+      encoder->params = params;
+  }
+#endif
+}
+
 }//endof ::i3s
 
 } // namespace i3slib
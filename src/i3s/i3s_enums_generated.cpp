@@ -20,7 +20,7 @@ email: contracts@esri.com
     #include "pch.h"
     #include "i3s/i3s_enums.h"
     #include "utils/utl_serialize.h"
-    #include <cstring>
+    #include <string_view>
     // --------------------------------------
     // file generated by test/scripts/enum_serialize.py 
     // WARNING: EDITS WILL BE LOST !!
@@ -29,24 +29,72 @@ email: contracts@esri.com
     namespace i3s {
     // --------------------------------------
     template<class Item, class T >
-    std::string       _enum_val_to_string(T code, const Item* items,  int count)
+    constexpr std::string_view _enum_val_to_string(T code, const Item* items,  int count)
     {
       //iterate:
       for (int i = 0; i < count; ++i)
         if (items[i].first == code)
           return items[i].second;
-      return std::string();
+      return std::string_view();
     }
-    template<class Item, class T >
-    bool            _find_by_string(const std::string& txt_utf8, const Item* items, int count, T* out)
+    //! FNV-1a
+    constexpr uint32_t _hash_string(std::string_view txt)
     {
-      for (int i = 0; i < count; ++i)
-        if (std::strcmp(items[i].second, txt_utf8.c_str()) == 0)
+      uint32_t hash = 2166136261u;
+      for (auto c : txt)
+        hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+      return hash;
+    }
+    //! Perfect hash of the strings of a Helper_*::c_known table: no two strings share a slot.
+    template< int Bits >
+    struct Perfect_hash
+    {
+      static constexpr int c_size = 1 << Bits;
+      uint32_t  seed = 0;
+      int8_t    slots[c_size] = {}; // index in c_known, -1 if empty
+
+      constexpr int get_slot(uint32_t hash) const { return static_cast<int>(((hash ^ seed) * 0x9E3779B1u) >> (32 - Bits)); }
+    };
+    //! At most a quarter of the slots are used, so that a seed is found in a few tries.
+    constexpr int _get_hash_bits(int count)
+    {
+      int bits = 1;
+      while ((1 << bits) < 4 * count)
+        ++bits;
+      return bits;
+    }
+    //! Compile-time seed search ( doesn't terminate if two strings have the same hash ).
+    template< int Bits, class Item, int N >
+    constexpr Perfect_hash< Bits > _create_perfect_hash(const Item(&items)[N])
+    {
+      static_assert(N < 128, "slots are 8 bits");
+      uint32_t hashes[N] = {};
+      for (int i = 0; i < N; ++i)
+        hashes[i] = _hash_string(items[i].second);
+      Perfect_hash< Bits > ph;
+      for (;; ++ph.seed)
+      {
+        bool is_perfect = true;
+        for (auto& slot : ph.slots)
+          slot = -1;
+        for (int i = 0; i < N && is_perfect; ++i)
         {
-          *out = items[i].first;
-          return true;
+          auto& slot = ph.slots[ph.get_slot(hashes[i])];
+          is_perfect = slot < 0;
+          slot = static_cast<int8_t>(i);
         }
-      return false;
+        if (is_perfect)
+          return ph;
+      }
+    }
+    template<class Item, class T, int N, int Bits >
+    constexpr bool  _find_by_string(std::string_view txt_utf8, const Item(&items)[N], const Perfect_hash< Bits >& hash, T* out)
+    {
+      const int i = hash.slots[hash.get_slot(_hash_string(txt_utf8))];
+      if (i < 0 || items[i].second != txt_utf8)
+        return false;
+      *out = items[i].first;
+      return true;
     }
     // --------------------------------------
     
@@ -55,7 +103,7 @@ email: contracts@esri.com
       typedef Alpha_mode Enum_t;
       static constexpr int c_key_count = 3;
       static constexpr int c_entry_count = 3;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Alpha_mode::Opaque, "opaque"},
@@ -63,39 +111,39 @@ email: contracts@esri.com
 {Alpha_mode::Blend, "blend"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Alpha_mode::Item Helper_Alpha_mode::c_known[Helper_Alpha_mode::c_entry_count];
 
-    std::string     to_string(Alpha_mode enum_val)   {    return Helper_Alpha_mode::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Alpha_mode* out)  { return Helper_Alpha_mode::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Alpha_mode enum_val) { return Helper_Alpha_mode::to_string(enum_val); }
+    std::string     to_string(Alpha_mode enum_val)   {    return std::string(Helper_Alpha_mode::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Alpha_mode* out)  { return Helper_Alpha_mode::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Alpha_mode& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Alpha_mode& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -106,7 +154,7 @@ email: contracts@esri.com
       typedef Face_culling_mode Enum_t;
       static constexpr int c_key_count = 3;
       static constexpr int c_entry_count = 3;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Face_culling_mode::None, "none"},
@@ -114,39 +162,39 @@ email: contracts@esri.com
 {Face_culling_mode::Back, "back"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Face_culling_mode::Item Helper_Face_culling_mode::c_known[Helper_Face_culling_mode::c_entry_count];
 
-    std::string     to_string(Face_culling_mode enum_val)   {    return Helper_Face_culling_mode::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Face_culling_mode* out)  { return Helper_Face_culling_mode::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Face_culling_mode enum_val) { return Helper_Face_culling_mode::to_string(enum_val); }
+    std::string     to_string(Face_culling_mode enum_val)   {    return std::string(Helper_Face_culling_mode::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Face_culling_mode* out)  { return Helper_Face_culling_mode::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Face_culling_mode& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Face_culling_mode& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -157,7 +205,7 @@ email: contracts@esri.com
       typedef Type Enum_t;
       static constexpr int c_key_count = 16;
       static constexpr int c_entry_count = 16;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Type::Int8, "Int8"},
@@ -178,39 +226,39 @@ email: contracts@esri.com
 {Type::Guid, "GUID"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Type::Item Helper_Type::c_known[Helper_Type::c_entry_count];
 
-    std::string     to_string(Type enum_val)   {    return Helper_Type::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Type* out)  { return Helper_Type::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Type enum_val) { return Helper_Type::to_string(enum_val); }
+    std::string     to_string(Type enum_val)   {    return std::string(Helper_Type::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Type* out)  { return Helper_Type::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Type& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Type& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -221,46 +269,46 @@ email: contracts@esri.com
       typedef Domain_type Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Domain_type::CodedValue, "codedValue"},
 {Domain_type::Range, "range"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Domain_type::Item Helper_Domain_type::c_known[Helper_Domain_type::c_entry_count];
 
-    std::string     to_string(Domain_type enum_val)   {    return Helper_Domain_type::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Domain_type* out)  { return Helper_Domain_type::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Domain_type enum_val) { return Helper_Domain_type::to_string(enum_val); }
+    std::string     to_string(Domain_type enum_val)   {    return std::string(Helper_Domain_type::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Domain_type* out)  { return Helper_Domain_type::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Domain_type& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Domain_type& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -271,7 +319,7 @@ email: contracts@esri.com
       typedef Esri_field_type Enum_t;
       static constexpr int c_key_count = 10;
       static constexpr int c_entry_count = 11;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Esri_field_type::Date, "esriFieldTypeDate"},
@@ -287,39 +335,39 @@ email: contracts@esri.com
 {Esri_field_type::Integer, "FieldTypeInteger"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Esri_field_type::Item Helper_Esri_field_type::c_known[Helper_Esri_field_type::c_entry_count];
 
-    std::string     to_string(Esri_field_type enum_val)   {    return Helper_Esri_field_type::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Esri_field_type* out)  { return Helper_Esri_field_type::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Esri_field_type enum_val) { return Helper_Esri_field_type::to_string(enum_val); }
+    std::string     to_string(Esri_field_type enum_val)   {    return std::string(Helper_Esri_field_type::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Esri_field_type* out)  { return Helper_Esri_field_type::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Esri_field_type& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Esri_field_type& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -330,45 +378,45 @@ email: contracts@esri.com
       typedef Key_value_encoding_type Enum_t;
       static constexpr int c_key_count = 1;
       static constexpr int c_entry_count = 1;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Key_value_encoding_type::Separated_key_values, "SeparatedKeyValues"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Key_value_encoding_type::Item Helper_Key_value_encoding_type::c_known[Helper_Key_value_encoding_type::c_entry_count];
 
-    std::string     to_string(Key_value_encoding_type enum_val)   {    return Helper_Key_value_encoding_type::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Key_value_encoding_type* out)  { return Helper_Key_value_encoding_type::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Key_value_encoding_type enum_val) { return Helper_Key_value_encoding_type::to_string(enum_val); }
+    std::string     to_string(Key_value_encoding_type enum_val)   {    return std::string(Helper_Key_value_encoding_type::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Key_value_encoding_type* out)  { return Helper_Key_value_encoding_type::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Key_value_encoding_type& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Key_value_encoding_type& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -379,45 +427,45 @@ email: contracts@esri.com
       typedef Legacy_topology Enum_t;
       static constexpr int c_key_count = 1;
       static constexpr int c_entry_count = 1;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Legacy_topology::Per_attribute_array, "PerAttributeArray"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Legacy_topology::Item Helper_Legacy_topology::c_known[Helper_Legacy_topology::c_entry_count];
 
-    std::string     to_string(Legacy_topology enum_val)   {    return Helper_Legacy_topology::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Legacy_topology* out)  { return Helper_Legacy_topology::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Legacy_topology enum_val) { return Helper_Legacy_topology::to_string(enum_val); }
+    std::string     to_string(Legacy_topology enum_val)   {    return std::string(Helper_Legacy_topology::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Legacy_topology* out)  { return Helper_Legacy_topology::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Legacy_topology& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Legacy_topology& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -428,7 +476,7 @@ email: contracts@esri.com
       typedef Vertex_attrib_ordering Enum_t;
       static constexpr int c_key_count = 5;
       static constexpr int c_entry_count = 5;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Vertex_attrib_ordering::Position, "position"},
@@ -438,39 +486,39 @@ email: contracts@esri.com
 {Vertex_attrib_ordering::Region, "region"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Vertex_attrib_ordering::Item Helper_Vertex_attrib_ordering::c_known[Helper_Vertex_attrib_ordering::c_entry_count];
 
-    std::string     to_string(Vertex_attrib_ordering enum_val)   {    return Helper_Vertex_attrib_ordering::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Vertex_attrib_ordering* out)  { return Helper_Vertex_attrib_ordering::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Vertex_attrib_ordering enum_val) { return Helper_Vertex_attrib_ordering::to_string(enum_val); }
+    std::string     to_string(Vertex_attrib_ordering enum_val)   {    return std::string(Helper_Vertex_attrib_ordering::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Vertex_attrib_ordering* out)  { return Helper_Vertex_attrib_ordering::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Vertex_attrib_ordering& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Vertex_attrib_ordering& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -481,46 +529,46 @@ email: contracts@esri.com
       typedef Feature_attrib_ordering Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Feature_attrib_ordering::Fid, "id"},
 {Feature_attrib_ordering::Face_range, "faceRange"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Feature_attrib_ordering::Item Helper_Feature_attrib_ordering::c_known[Helper_Feature_attrib_ordering::c_entry_count];
 
-    std::string     to_string(Feature_attrib_ordering enum_val)   {    return Helper_Feature_attrib_ordering::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Feature_attrib_ordering* out)  { return Helper_Feature_attrib_ordering::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Feature_attrib_ordering enum_val) { return Helper_Feature_attrib_ordering::to_string(enum_val); }
+    std::string     to_string(Feature_attrib_ordering enum_val)   {    return std::string(Helper_Feature_attrib_ordering::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Feature_attrib_ordering* out)  { return Helper_Feature_attrib_ordering::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Feature_attrib_ordering& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Feature_attrib_ordering& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -531,7 +579,7 @@ email: contracts@esri.com
       typedef Geometry_header_property Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 3;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Geometry_header_property::Vertex_count, "vertexCount"},
@@ -539,39 +587,39 @@ email: contracts@esri.com
 {Geometry_header_property::Feature_count, "faceCount"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Geometry_header_property::Item Helper_Geometry_header_property::c_known[Helper_Geometry_header_property::c_entry_count];
 
-    std::string     to_string(Geometry_header_property enum_val)   {    return Helper_Geometry_header_property::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Geometry_header_property* out)  { return Helper_Geometry_header_property::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Geometry_header_property enum_val) { return Helper_Geometry_header_property::to_string(enum_val); }
+    std::string     to_string(Geometry_header_property enum_val)   {    return std::string(Helper_Geometry_header_property::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Geometry_header_property* out)  { return Helper_Geometry_header_property::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Geometry_header_property& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Geometry_header_property& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -582,7 +630,7 @@ email: contracts@esri.com
       typedef Mesh_topology Enum_t;
       static constexpr int c_key_count = 3;
       static constexpr int c_entry_count = 4;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Mesh_topology::Triangles, "triangles"},
@@ -591,39 +639,39 @@ email: contracts@esri.com
 {Mesh_topology::Triangles, "triangle"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Mesh_topology::Item Helper_Mesh_topology::c_known[Helper_Mesh_topology::c_entry_count];
 
-    std::string     to_string(Mesh_topology enum_val)   {    return Helper_Mesh_topology::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Mesh_topology* out)  { return Helper_Mesh_topology::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Mesh_topology enum_val) { return Helper_Mesh_topology::to_string(enum_val); }
+    std::string     to_string(Mesh_topology enum_val)   {    return std::string(Helper_Mesh_topology::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Mesh_topology* out)  { return Helper_Mesh_topology::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Mesh_topology& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Mesh_topology& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -634,46 +682,46 @@ email: contracts@esri.com
       typedef Encoding Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Encoding::None, "none"},
 {Encoding::String_utf8, "string-utf8"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Encoding::Item Helper_Encoding::c_known[Helper_Encoding::c_entry_count];
 
-    std::string     to_string(Encoding enum_val)   {    return Helper_Encoding::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Encoding* out)  { return Helper_Encoding::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Encoding enum_val) { return Helper_Encoding::to_string(enum_val); }
+    std::string     to_string(Encoding enum_val)   {    return std::string(Helper_Encoding::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Encoding* out)  { return Helper_Encoding::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Encoding& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Encoding& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -684,7 +732,7 @@ email: contracts@esri.com
       typedef Lod_metric_type Enum_t;
       static constexpr int c_key_count = 5;
       static constexpr int c_entry_count = 5;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Lod_metric_type::Max_screen_area, "maxScreenThresholdSQ"},
@@ -694,39 +742,39 @@ email: contracts@esri.com
 {Lod_metric_type::Screen_space_relative, "screenSpaceRelative"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Lod_metric_type::Item Helper_Lod_metric_type::c_known[Helper_Lod_metric_type::c_entry_count];
 
-    std::string     to_string(Lod_metric_type enum_val)   {    return Helper_Lod_metric_type::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Lod_metric_type* out)  { return Helper_Lod_metric_type::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Lod_metric_type enum_val) { return Helper_Lod_metric_type::to_string(enum_val); }
+    std::string     to_string(Lod_metric_type enum_val)   {    return std::string(Helper_Lod_metric_type::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Lod_metric_type* out)  { return Helper_Lod_metric_type::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Lod_metric_type& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Lod_metric_type& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -737,7 +785,7 @@ email: contracts@esri.com
       typedef Layer_type Enum_t;
       static constexpr int c_key_count = 7;
       static constexpr int c_entry_count = 7;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Layer_type::Mesh_3d, "3DObject"},
@@ -749,39 +797,39 @@ email: contracts@esri.com
 {Layer_type::Group, "group"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Layer_type::Item Helper_Layer_type::c_known[Helper_Layer_type::c_entry_count];
 
-    std::string     to_string(Layer_type enum_val)   {    return Helper_Layer_type::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Layer_type* out)  { return Helper_Layer_type::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Layer_type enum_val) { return Helper_Layer_type::to_string(enum_val); }
+    std::string     to_string(Layer_type enum_val)   {    return std::string(Helper_Layer_type::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Layer_type* out)  { return Helper_Layer_type::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Layer_type& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Layer_type& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -792,7 +840,7 @@ email: contracts@esri.com
       typedef VB_Binding Enum_t;
       static constexpr int c_key_count = 3;
       static constexpr int c_entry_count = 3;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {VB_Binding::Per_vertex, "per-vertex"},
@@ -800,39 +848,39 @@ email: contracts@esri.com
 {VB_Binding::Per_feature, "per-feature"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_VB_Binding::Item Helper_VB_Binding::c_known[Helper_VB_Binding::c_entry_count];
 
-    std::string     to_string(VB_Binding enum_val)   {    return Helper_VB_Binding::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, VB_Binding* out)  { return Helper_VB_Binding::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(VB_Binding enum_val) { return Helper_VB_Binding::to_string(enum_val); }
+    std::string     to_string(VB_Binding enum_val)   {    return std::string(Helper_VB_Binding::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, VB_Binding* out)  { return Helper_VB_Binding::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const VB_Binding& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, VB_Binding& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -843,7 +891,7 @@ email: contracts@esri.com
       typedef Texture_filtering_mode Enum_t;
       static constexpr int c_key_count = 6;
       static constexpr int c_entry_count = 6;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Texture_filtering_mode::Nearest, "nearest"},
@@ -854,39 +902,39 @@ email: contracts@esri.com
 {Texture_filtering_mode::Linear_mipmap_linear, "linear-mipmap-linear"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Texture_filtering_mode::Item Helper_Texture_filtering_mode::c_known[Helper_Texture_filtering_mode::c_entry_count];
 
-    std::string     to_string(Texture_filtering_mode enum_val)   {    return Helper_Texture_filtering_mode::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Texture_filtering_mode* out)  { return Helper_Texture_filtering_mode::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Texture_filtering_mode enum_val) { return Helper_Texture_filtering_mode::to_string(enum_val); }
+    std::string     to_string(Texture_filtering_mode enum_val)   {    return std::string(Helper_Texture_filtering_mode::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Texture_filtering_mode* out)  { return Helper_Texture_filtering_mode::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Texture_filtering_mode& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Texture_filtering_mode& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -897,46 +945,46 @@ email: contracts@esri.com
       typedef Texture_wrap_mode Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Texture_wrap_mode::Clamp, "clamp"},
 {Texture_wrap_mode::Repeat, "repeat"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Texture_wrap_mode::Item Helper_Texture_wrap_mode::c_known[Helper_Texture_wrap_mode::c_entry_count];
 
-    std::string     to_string(Texture_wrap_mode enum_val)   {    return Helper_Texture_wrap_mode::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Texture_wrap_mode* out)  { return Helper_Texture_wrap_mode::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Texture_wrap_mode enum_val) { return Helper_Texture_wrap_mode::to_string(enum_val); }
+    std::string     to_string(Texture_wrap_mode enum_val)   {    return std::string(Helper_Texture_wrap_mode::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Texture_wrap_mode* out)  { return Helper_Texture_wrap_mode::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Texture_wrap_mode& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Texture_wrap_mode& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -947,7 +995,7 @@ email: contracts@esri.com
       typedef Normal_reference_frame Enum_t;
       static constexpr int c_key_count = 3;
       static constexpr int c_entry_count = 3;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Normal_reference_frame::East_north_up, "east-north-up"},
@@ -955,39 +1003,39 @@ email: contracts@esri.com
 {Normal_reference_frame::Vertex_reference_frame, "vertex-reference-frame"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Normal_reference_frame::Item Helper_Normal_reference_frame::c_known[Helper_Normal_reference_frame::c_entry_count];
 
-    std::string     to_string(Normal_reference_frame enum_val)   {    return Helper_Normal_reference_frame::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Normal_reference_frame* out)  { return Helper_Normal_reference_frame::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Normal_reference_frame enum_val) { return Helper_Normal_reference_frame::to_string(enum_val); }
+    std::string     to_string(Normal_reference_frame enum_val)   {    return std::string(Helper_Normal_reference_frame::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Normal_reference_frame* out)  { return Helper_Normal_reference_frame::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Normal_reference_frame& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Normal_reference_frame& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -998,7 +1046,7 @@ email: contracts@esri.com
       typedef Compressed_mesh_attribute Enum_t;
       static constexpr int c_key_count = 7;
       static constexpr int c_entry_count = 7;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Compressed_mesh_attribute::Position, "position"},
@@ -1010,39 +1058,39 @@ email: contracts@esri.com
 {Compressed_mesh_attribute::Flag, "flag"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Compressed_mesh_attribute::Item Helper_Compressed_mesh_attribute::c_known[Helper_Compressed_mesh_attribute::c_entry_count];
 
-    std::string     to_string(Compressed_mesh_attribute enum_val)   {    return Helper_Compressed_mesh_attribute::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Compressed_mesh_attribute* out)  { return Helper_Compressed_mesh_attribute::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Compressed_mesh_attribute enum_val) { return Helper_Compressed_mesh_attribute::to_string(enum_val); }
+    std::string     to_string(Compressed_mesh_attribute enum_val)   {    return std::string(Helper_Compressed_mesh_attribute::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Compressed_mesh_attribute* out)  { return Helper_Compressed_mesh_attribute::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Compressed_mesh_attribute& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Compressed_mesh_attribute& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1053,46 +1101,46 @@ email: contracts@esri.com
       typedef Attrib_header_property Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Attrib_header_property::Count, "count"},
 {Attrib_header_property::Attribute_values_byte_count, "attributeValuesByteCount"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Attrib_header_property::Item Helper_Attrib_header_property::c_known[Helper_Attrib_header_property::c_entry_count];
 
-    std::string     to_string(Attrib_header_property enum_val)   {    return Helper_Attrib_header_property::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Attrib_header_property* out)  { return Helper_Attrib_header_property::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Attrib_header_property enum_val) { return Helper_Attrib_header_property::to_string(enum_val); }
+    std::string     to_string(Attrib_header_property enum_val)   {    return std::string(Helper_Attrib_header_property::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Attrib_header_property* out)  { return Helper_Attrib_header_property::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Attrib_header_property& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Attrib_header_property& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1103,7 +1151,7 @@ email: contracts@esri.com
       typedef Attrib_ordering Enum_t;
       static constexpr int c_key_count = 3;
       static constexpr int c_entry_count = 4;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Attrib_ordering::Attribute_values, "attributeValues"},
@@ -1112,39 +1160,39 @@ email: contracts@esri.com
 {Attrib_ordering::Object_ids, "objectIds"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Attrib_ordering::Item Helper_Attrib_ordering::c_known[Helper_Attrib_ordering::c_entry_count];
 
-    std::string     to_string(Attrib_ordering enum_val)   {    return Helper_Attrib_ordering::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Attrib_ordering* out)  { return Helper_Attrib_ordering::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Attrib_ordering enum_val) { return Helper_Attrib_ordering::to_string(enum_val); }
+    std::string     to_string(Attrib_ordering enum_val)   {    return std::string(Helper_Attrib_ordering::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Attrib_ordering* out)  { return Helper_Attrib_ordering::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Attrib_ordering& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Attrib_ordering& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1155,7 +1203,7 @@ email: contracts@esri.com
       typedef Compressed_geometry_format Enum_t;
       static constexpr int c_key_count = 3;
       static constexpr int c_entry_count = 3;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Compressed_geometry_format::Not_init, "Not_set"},
@@ -1163,39 +1211,39 @@ email: contracts@esri.com
 {Compressed_geometry_format::Lepcc, "lepcc"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Compressed_geometry_format::Item Helper_Compressed_geometry_format::c_known[Helper_Compressed_geometry_format::c_entry_count];
 
-    std::string     to_string(Compressed_geometry_format enum_val)   {    return Helper_Compressed_geometry_format::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Compressed_geometry_format* out)  { return Helper_Compressed_geometry_format::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Compressed_geometry_format enum_val) { return Helper_Compressed_geometry_format::to_string(enum_val); }
+    std::string     to_string(Compressed_geometry_format enum_val)   {    return std::string(Helper_Compressed_geometry_format::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Compressed_geometry_format* out)  { return Helper_Compressed_geometry_format::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Compressed_geometry_format& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Compressed_geometry_format& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1206,7 +1254,7 @@ email: contracts@esri.com
       typedef Legacy_image_channel Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 3;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Legacy_image_channel::Rgba, "rgba"},
@@ -1214,39 +1262,39 @@ email: contracts@esri.com
 {Legacy_image_channel::Rgb, ""}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Legacy_image_channel::Item Helper_Legacy_image_channel::c_known[Helper_Legacy_image_channel::c_entry_count];
 
-    std::string     to_string(Legacy_image_channel enum_val)   {    return Helper_Legacy_image_channel::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Legacy_image_channel* out)  { return Helper_Legacy_image_channel::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Legacy_image_channel enum_val) { return Helper_Legacy_image_channel::to_string(enum_val); }
+    std::string     to_string(Legacy_image_channel enum_val)   {    return std::string(Helper_Legacy_image_channel::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Legacy_image_channel* out)  { return Helper_Legacy_image_channel::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Legacy_image_channel& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Legacy_image_channel& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1257,7 +1305,7 @@ email: contracts@esri.com
       typedef Legacy_wrap_mode Enum_t;
       static constexpr int c_key_count = 3;
       static constexpr int c_entry_count = 3;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Legacy_wrap_mode::None, "none"},
@@ -1265,39 +1313,39 @@ email: contracts@esri.com
 {Legacy_wrap_mode::Mirror, "mirror"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Legacy_wrap_mode::Item Helper_Legacy_wrap_mode::c_known[Helper_Legacy_wrap_mode::c_entry_count];
 
-    std::string     to_string(Legacy_wrap_mode enum_val)   {    return Helper_Legacy_wrap_mode::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Legacy_wrap_mode* out)  { return Helper_Legacy_wrap_mode::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Legacy_wrap_mode enum_val) { return Helper_Legacy_wrap_mode::to_string(enum_val); }
+    std::string     to_string(Legacy_wrap_mode enum_val)   {    return std::string(Helper_Legacy_wrap_mode::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Legacy_wrap_mode* out)  { return Helper_Legacy_wrap_mode::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Legacy_wrap_mode& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Legacy_wrap_mode& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1308,7 +1356,7 @@ email: contracts@esri.com
       typedef Mime_image_format Enum_t;
       static constexpr int c_key_count = 6;
       static constexpr int c_entry_count = 10;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Mime_image_format::Jpg, "image/jpeg"},
@@ -1323,39 +1371,39 @@ email: contracts@esri.com
 {Mime_image_format::Ktx, "data:image/ktx"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Mime_image_format::Item Helper_Mime_image_format::c_known[Helper_Mime_image_format::c_entry_count];
 
-    std::string     to_string(Mime_image_format enum_val)   {    return Helper_Mime_image_format::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Mime_image_format* out)  { return Helper_Mime_image_format::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Mime_image_format enum_val) { return Helper_Mime_image_format::to_string(enum_val); }
+    std::string     to_string(Mime_image_format enum_val)   {    return std::string(Helper_Mime_image_format::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Mime_image_format* out)  { return Helper_Mime_image_format::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Mime_image_format& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Mime_image_format& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1366,45 +1414,45 @@ email: contracts@esri.com
       typedef Legacy_uv_set Enum_t;
       static constexpr int c_key_count = 1;
       static constexpr int c_entry_count = 1;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Legacy_uv_set::Uv0, "uv0"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Legacy_uv_set::Item Helper_Legacy_uv_set::c_known[Helper_Legacy_uv_set::c_entry_count];
 
-    std::string     to_string(Legacy_uv_set enum_val)   {    return Helper_Legacy_uv_set::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Legacy_uv_set* out)  { return Helper_Legacy_uv_set::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Legacy_uv_set enum_val) { return Helper_Legacy_uv_set::to_string(enum_val); }
+    std::string     to_string(Legacy_uv_set enum_val)   {    return std::string(Helper_Legacy_uv_set::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Legacy_uv_set* out)  { return Helper_Legacy_uv_set::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Legacy_uv_set& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Legacy_uv_set& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1415,45 +1463,45 @@ email: contracts@esri.com
       typedef Value_encoding Enum_t;
       static constexpr int c_key_count = 1;
       static constexpr int c_entry_count = 1;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Value_encoding::Utf8, "UTF-8"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Value_encoding::Item Helper_Value_encoding::c_known[Helper_Value_encoding::c_entry_count];
 
-    std::string     to_string(Value_encoding enum_val)   {    return Helper_Value_encoding::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Value_encoding* out)  { return Helper_Value_encoding::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Value_encoding enum_val) { return Helper_Value_encoding::to_string(enum_val); }
+    std::string     to_string(Value_encoding enum_val)   {    return std::string(Helper_Value_encoding::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Value_encoding* out)  { return Helper_Value_encoding::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Value_encoding& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Value_encoding& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1464,45 +1512,45 @@ email: contracts@esri.com
       typedef Time_encoding Enum_t;
       static constexpr int c_key_count = 1;
       static constexpr int c_entry_count = 1;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Time_encoding::Ecma_iso_8601, "ECMA_ISO8601"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Time_encoding::Item Helper_Time_encoding::c_known[Helper_Time_encoding::c_entry_count];
 
-    std::string     to_string(Time_encoding enum_val)   {    return Helper_Time_encoding::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Time_encoding* out)  { return Helper_Time_encoding::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Time_encoding enum_val) { return Helper_Time_encoding::to_string(enum_val); }
+    std::string     to_string(Time_encoding enum_val)   {    return std::string(Helper_Time_encoding::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Time_encoding* out)  { return Helper_Time_encoding::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Time_encoding& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Time_encoding& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1513,7 +1561,7 @@ email: contracts@esri.com
       typedef Attribute_storage_info_encoding Enum_t;
       static constexpr int c_key_count = 4;
       static constexpr int c_entry_count = 4;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Attribute_storage_info_encoding::Embedded_elevation, "embedded-elevation"},
@@ -1522,39 +1570,39 @@ email: contracts@esri.com
 {Attribute_storage_info_encoding::Lepcc_intensity, "lepcc-intensity"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Attribute_storage_info_encoding::Item Helper_Attribute_storage_info_encoding::c_known[Helper_Attribute_storage_info_encoding::c_entry_count];
 
-    std::string     to_string(Attribute_storage_info_encoding enum_val)   {    return Helper_Attribute_storage_info_encoding::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Attribute_storage_info_encoding* out)  { return Helper_Attribute_storage_info_encoding::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Attribute_storage_info_encoding enum_val) { return Helper_Attribute_storage_info_encoding::to_string(enum_val); }
+    std::string     to_string(Attribute_storage_info_encoding enum_val)   {    return std::string(Helper_Attribute_storage_info_encoding::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Attribute_storage_info_encoding* out)  { return Helper_Attribute_storage_info_encoding::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Attribute_storage_info_encoding& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Attribute_storage_info_encoding& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1565,46 +1613,46 @@ email: contracts@esri.com
       typedef Bsl_filter_mode Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Bsl_filter_mode::Solid, "solid"},
 {Bsl_filter_mode::Wireframe, "wireFrame"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Bsl_filter_mode::Item Helper_Bsl_filter_mode::c_known[Helper_Bsl_filter_mode::c_entry_count];
 
-    std::string     to_string(Bsl_filter_mode enum_val)   {    return Helper_Bsl_filter_mode::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Bsl_filter_mode* out)  { return Helper_Bsl_filter_mode::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Bsl_filter_mode enum_val) { return Helper_Bsl_filter_mode::to_string(enum_val); }
+    std::string     to_string(Bsl_filter_mode enum_val)   {    return std::string(Helper_Bsl_filter_mode::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Bsl_filter_mode* out)  { return Helper_Bsl_filter_mode::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Bsl_filter_mode& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Bsl_filter_mode& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1615,7 +1663,7 @@ email: contracts@esri.com
       typedef Height_model Enum_t;
       static constexpr int c_key_count = 3;
       static constexpr int c_entry_count = 3;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Height_model::Gravity_related, "gravity_related_height"},
@@ -1623,39 +1671,39 @@ email: contracts@esri.com
 {Height_model::Orthometric, "orthometric"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Height_model::Item Helper_Height_model::c_known[Helper_Height_model::c_entry_count];
 
-    std::string     to_string(Height_model enum_val)   {    return Helper_Height_model::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Height_model* out)  { return Helper_Height_model::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Height_model enum_val) { return Helper_Height_model::to_string(enum_val); }
+    std::string     to_string(Height_model enum_val)   {    return std::string(Helper_Height_model::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Height_model* out)  { return Helper_Height_model::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Height_model& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Height_model& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1666,7 +1714,7 @@ email: contracts@esri.com
       typedef Height_unit Enum_t;
       static constexpr int c_key_count = 21;
       static constexpr int c_entry_count = 39;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Height_unit::Meter, "meter"},
@@ -1710,39 +1758,39 @@ email: contracts@esri.com
 {Height_unit::Us_yard, "yard_us"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Height_unit::Item Helper_Height_unit::c_known[Helper_Height_unit::c_entry_count];
 
-    std::string     to_string(Height_unit enum_val)   {    return Helper_Height_unit::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Height_unit* out)  { return Helper_Height_unit::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Height_unit enum_val) { return Helper_Height_unit::to_string(enum_val); }
+    std::string     to_string(Height_unit enum_val)   {    return std::string(Helper_Height_unit::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Height_unit* out)  { return Helper_Height_unit::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Height_unit& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Height_unit& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1753,46 +1801,46 @@ email: contracts@esri.com
       typedef Continuity Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Continuity::Continuous, "continuous"},
 {Continuity::Discrete, "discrete"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Continuity::Item Helper_Continuity::c_known[Helper_Continuity::c_entry_count];
 
-    std::string     to_string(Continuity enum_val)   {    return Helper_Continuity::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Continuity* out)  { return Helper_Continuity::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Continuity enum_val) { return Helper_Continuity::to_string(enum_val); }
+    std::string     to_string(Continuity enum_val)   {    return std::string(Helper_Continuity::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Continuity* out)  { return Helper_Continuity::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Continuity& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Continuity& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1803,7 +1851,7 @@ email: contracts@esri.com
       typedef Base_quantity Enum_t;
       static constexpr int c_key_count = 4;
       static constexpr int c_entry_count = 4;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Base_quantity::Horizontal_coordinate, "horizontal-coordinate"},
@@ -1812,39 +1860,39 @@ email: contracts@esri.com
 {Base_quantity::None, "none"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Base_quantity::Item Helper_Base_quantity::c_known[Helper_Base_quantity::c_entry_count];
 
-    std::string     to_string(Base_quantity enum_val)   {    return Helper_Base_quantity::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Base_quantity* out)  { return Helper_Base_quantity::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Base_quantity enum_val) { return Helper_Base_quantity::to_string(enum_val); }
+    std::string     to_string(Base_quantity enum_val)   {    return std::string(Helper_Base_quantity::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Base_quantity* out)  { return Helper_Base_quantity::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Base_quantity& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Base_quantity& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1855,7 +1903,7 @@ email: contracts@esri.com
       typedef Pcsl_attribute_buffer_type Enum_t;
       static constexpr int c_key_count = 12;
       static constexpr int c_entry_count = 12;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Pcsl_attribute_buffer_type::Elevation, "ELEVATION"},
@@ -1872,39 +1920,39 @@ email: contracts@esri.com
 {Pcsl_attribute_buffer_type::Near_infrared, "NEAR_INFRARED"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Pcsl_attribute_buffer_type::Item Helper_Pcsl_attribute_buffer_type::c_known[Helper_Pcsl_attribute_buffer_type::c_entry_count];
 
-    std::string     to_string(Pcsl_attribute_buffer_type enum_val)   {    return Helper_Pcsl_attribute_buffer_type::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Pcsl_attribute_buffer_type* out)  { return Helper_Pcsl_attribute_buffer_type::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Pcsl_attribute_buffer_type enum_val) { return Helper_Pcsl_attribute_buffer_type::to_string(enum_val); }
+    std::string     to_string(Pcsl_attribute_buffer_type enum_val)   {    return std::string(Helper_Pcsl_attribute_buffer_type::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Pcsl_attribute_buffer_type* out)  { return Helper_Pcsl_attribute_buffer_type::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Pcsl_attribute_buffer_type& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Pcsl_attribute_buffer_type& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1915,46 +1963,46 @@ email: contracts@esri.com
       typedef Bounding_volume_type Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Bounding_volume_type::Obb, "obb"},
 {Bounding_volume_type::Mbs, "mbs"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Bounding_volume_type::Item Helper_Bounding_volume_type::c_known[Helper_Bounding_volume_type::c_entry_count];
 
-    std::string     to_string(Bounding_volume_type enum_val)   {    return Helper_Bounding_volume_type::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Bounding_volume_type* out)  { return Helper_Bounding_volume_type::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Bounding_volume_type enum_val) { return Helper_Bounding_volume_type::to_string(enum_val); }
+    std::string     to_string(Bounding_volume_type enum_val)   {    return std::string(Helper_Bounding_volume_type::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Bounding_volume_type* out)  { return Helper_Bounding_volume_type::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Bounding_volume_type& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Bounding_volume_type& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -1965,7 +2013,7 @@ email: contracts@esri.com
       typedef Vxl_variable_semantic Enum_t;
       static constexpr int c_key_count = 4;
       static constexpr int c_entry_count = 4;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Vxl_variable_semantic::Stc_hot_spot_results, "stc-hot-spot-results"},
@@ -1974,39 +2022,39 @@ email: contracts@esri.com
 {Vxl_variable_semantic::Generic_nearest_interpolated, "generic-nearest-interpolated"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Vxl_variable_semantic::Item Helper_Vxl_variable_semantic::c_known[Helper_Vxl_variable_semantic::c_entry_count];
 
-    std::string     to_string(Vxl_variable_semantic enum_val)   {    return Helper_Vxl_variable_semantic::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Vxl_variable_semantic* out)  { return Helper_Vxl_variable_semantic::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Vxl_variable_semantic enum_val) { return Helper_Vxl_variable_semantic::to_string(enum_val); }
+    std::string     to_string(Vxl_variable_semantic enum_val)   {    return std::string(Helper_Vxl_variable_semantic::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Vxl_variable_semantic* out)  { return Helper_Vxl_variable_semantic::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Vxl_variable_semantic& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Vxl_variable_semantic& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -2017,46 +2065,46 @@ email: contracts@esri.com
       typedef Vertical_exag_mode Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Vertical_exag_mode::Scale_position, "scale-position"},
 {Vertical_exag_mode::Scale_height, "scale-height"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Vertical_exag_mode::Item Helper_Vertical_exag_mode::c_known[Helper_Vertical_exag_mode::c_entry_count];
 
-    std::string     to_string(Vertical_exag_mode enum_val)   {    return Helper_Vertical_exag_mode::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Vertical_exag_mode* out)  { return Helper_Vertical_exag_mode::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Vertical_exag_mode enum_val) { return Helper_Vertical_exag_mode::to_string(enum_val); }
+    std::string     to_string(Vertical_exag_mode enum_val)   {    return std::string(Helper_Vertical_exag_mode::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Vertical_exag_mode* out)  { return Helper_Vertical_exag_mode::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Vertical_exag_mode& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Vertical_exag_mode& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -2067,7 +2115,7 @@ email: contracts@esri.com
       typedef Rendering_quality Enum_t;
       static constexpr int c_key_count = 4;
       static constexpr int c_entry_count = 4;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Rendering_quality::Low, "low"},
@@ -2076,39 +2124,39 @@ email: contracts@esri.com
 {Rendering_quality::Custom, "custom"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Rendering_quality::Item Helper_Rendering_quality::c_known[Helper_Rendering_quality::c_entry_count];
 
-    std::string     to_string(Rendering_quality enum_val)   {    return Helper_Rendering_quality::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Rendering_quality* out)  { return Helper_Rendering_quality::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Rendering_quality enum_val) { return Helper_Rendering_quality::to_string(enum_val); }
+    std::string     to_string(Rendering_quality enum_val)   {    return std::string(Helper_Rendering_quality::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Rendering_quality* out)  { return Helper_Rendering_quality::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Rendering_quality& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Rendering_quality& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -2119,46 +2167,46 @@ email: contracts@esri.com
       typedef Interpolation Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Interpolation::Linear, "linear"},
 {Interpolation::Nearest, "nearest"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Interpolation::Item Helper_Interpolation::c_known[Helper_Interpolation::c_entry_count];
 
-    std::string     to_string(Interpolation enum_val)   {    return Helper_Interpolation::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Interpolation* out)  { return Helper_Interpolation::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Interpolation enum_val) { return Helper_Interpolation::to_string(enum_val); }
+    std::string     to_string(Interpolation enum_val)   {    return std::string(Helper_Interpolation::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Interpolation* out)  { return Helper_Interpolation::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Interpolation& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Interpolation& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -2169,46 +2217,46 @@ email: contracts@esri.com
       typedef Vxl_render_mode Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Vxl_render_mode::Volume, "volume"},
 {Vxl_render_mode::Surfaces, "surfaces"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Vxl_render_mode::Item Helper_Vxl_render_mode::c_known[Helper_Vxl_render_mode::c_entry_count];
 
-    std::string     to_string(Vxl_render_mode enum_val)   {    return Helper_Vxl_render_mode::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Vxl_render_mode* out)  { return Helper_Vxl_render_mode::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Vxl_render_mode enum_val) { return Helper_Vxl_render_mode::to_string(enum_val); }
+    std::string     to_string(Vxl_render_mode enum_val)   {    return std::string(Helper_Vxl_render_mode::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Vxl_render_mode* out)  { return Helper_Vxl_render_mode::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Vxl_render_mode& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Vxl_render_mode& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -2219,46 +2267,46 @@ email: contracts@esri.com
       typedef Vxl_rw_stats_status Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Vxl_rw_stats_status::Partial, "partial"},
 {Vxl_rw_stats_status::Final, "final"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Vxl_rw_stats_status::Item Helper_Vxl_rw_stats_status::c_known[Helper_Vxl_rw_stats_status::c_entry_count];
 
-    std::string     to_string(Vxl_rw_stats_status enum_val)   {    return Helper_Vxl_rw_stats_status::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Vxl_rw_stats_status* out)  { return Helper_Vxl_rw_stats_status::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Vxl_rw_stats_status enum_val) { return Helper_Vxl_rw_stats_status::to_string(enum_val); }
+    std::string     to_string(Vxl_rw_stats_status enum_val)   {    return std::string(Helper_Vxl_rw_stats_status::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Vxl_rw_stats_status* out)  { return Helper_Vxl_rw_stats_status::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Vxl_rw_stats_status& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Vxl_rw_stats_status& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -2269,46 +2317,46 @@ email: contracts@esri.com
       typedef Priority Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Priority::High, "High"},
 {Priority::Low, "Low"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Priority::Item Helper_Priority::c_known[Helper_Priority::c_entry_count];
 
-    std::string     to_string(Priority enum_val)   {    return Helper_Priority::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Priority* out)  { return Helper_Priority::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Priority enum_val) { return Helper_Priority::to_string(enum_val); }
+    std::string     to_string(Priority enum_val)   {    return std::string(Helper_Priority::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Priority* out)  { return Helper_Priority::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Priority& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Priority& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -2319,46 +2367,46 @@ email: contracts@esri.com
       typedef Semantic Enum_t;
       static constexpr int c_key_count = 2;
       static constexpr int c_entry_count = 2;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Semantic::None, "None"},
 {Semantic::Labels, "Labels"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Semantic::Item Helper_Semantic::c_known[Helper_Semantic::c_entry_count];
 
-    std::string     to_string(Semantic enum_val)   {    return Helper_Semantic::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Semantic* out)  { return Helper_Semantic::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Semantic enum_val) { return Helper_Semantic::to_string(enum_val); }
+    std::string     to_string(Semantic enum_val)   {    return std::string(Helper_Semantic::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Semantic* out)  { return Helper_Semantic::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Semantic& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Semantic& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
@@ -2369,7 +2417,7 @@ email: contracts@esri.com
       typedef Capability Enum_t;
       static constexpr int c_key_count = 4;
       static constexpr int c_entry_count = 4;
-      typedef std::pair< Enum_t, const char* > Item;
+      typedef std::pair< Enum_t, std::string_view > Item;
       static constexpr Item c_known[c_entry_count] =
       {
           {Capability::View, "View"},
@@ -2378,42 +2426,43 @@ email: contracts@esri.com
 {Capability::Extract, "Extract"}
       };
       static constexpr bool is_linear = (int)c_known[c_key_count - 1].first == c_key_count - 1;
+      static constexpr auto c_hash = _create_perfect_hash< _get_hash_bits(c_entry_count) >(c_known);
 
-      static std::string     to_string(Enum_t what)
+      static constexpr std::string_view to_string(Enum_t what)
       {
         if (is_linear)
-          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string();
+          return (uint32_t)what < c_key_count ? c_known[(uint32_t)what].second : std::string_view();
         else
           return _enum_val_to_string(what, c_known, c_key_count);
       };
-      static bool            from_string(const std::string& txt_utf8, Enum_t* out)
+      static constexpr bool  from_string(std::string_view txt_utf8, Enum_t* out)
       {
-        return _find_by_string(txt_utf8, c_known, c_entry_count, out);
+        return _find_by_string(txt_utf8, c_known, c_hash, out);
       }
     };
     
     /*static*/ constexpr Helper_Capability::Item Helper_Capability::c_known[Helper_Capability::c_entry_count];
 
-    std::string     to_string(Capability enum_val)   {    return Helper_Capability::to_string(enum_val); }
-    bool            from_string(const std::string& txt_utf8, Capability* out)  { return Helper_Capability::from_string(txt_utf8, out);} 
+    std::string_view to_string_view(Capability enum_val) { return Helper_Capability::to_string(enum_val); }
+    std::string     to_string(Capability enum_val)   {    return std::string(Helper_Capability::to_string(enum_val)); }
+    bool            from_string(std::string_view txt_utf8, Capability* out)  { return Helper_Capability::from_string(txt_utf8, out);} 
 
     utl::Archive_out& operator&(utl::Archive_out& ar, const Capability& me)
     {
-      auto tmp = to_string(me);
-      ar & tmp;
+      ar.save_string_view(to_string_view(me));
       return ar;
     }
     utl::Archive_in& operator&(utl::Archive_in& ar, Capability& me)
     {
-      if (ar.has_parse_error()) return ar;
-      std::string tmp;
-      ar & tmp;
+      std::string_view tmp;
+      if (!ar.load_string_view(&tmp)) return ar;
       if (!from_string(tmp, &me))
       {
-          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, tmp );
+          ar.report_parsing_error(utl::Json_parse_error::Error::Unknown_enum, std::string(tmp));
       }
       return ar;
     }
     
+
     }}//endof ::i3s
     
\ No newline at end of file
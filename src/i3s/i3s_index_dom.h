@@ -286,6 +286,41 @@ struct Node_page_desc_v17
   }
 };
 
+//! PCSL ( v2.0+ ) node. Children of a node are contiguous in the node pages.
+struct Pcsl_node_desc
+{
+  // --- fields:
+  uint32_t      resource_id = 0;
+  uint32_t      first_child = 0;
+  uint32_t      child_count = 0;
+  uint32_t      vertex_count = 0;
+  utl::Obb_abs  obb;
+  double        lod_threshold = 0.0;
+  // --- 
+  SERIALIZABLE(Pcsl_node_desc);
+  template< class Ar > void serialize(Ar& ar)
+  {
+    ar & utl::nvp("resourceId", resource_id);
+    ar & utl::nvp("firstChild", first_child);
+    ar & utl::nvp("childCount", child_count);
+    ar & utl::nvp("vertexCount", vertex_count);
+    ar & utl::nvp("obb", obb);
+    ar & utl::nvp("lodThreshold", lod_threshold);
+  }
+};
+
+struct Pcsl_node_page_desc
+{
+  // --- fields:
+  std::vector< Pcsl_node_desc > nodes;
+  //----
+  SERIALIZABLE(Pcsl_node_page_desc);
+  template< class Ar > void serialize(Ar& ar)
+  {
+    ar & utl::nvp("nodes", utl::seq(nodes));
+  }
+};
+
 }//endof i3s
 
 } // namespace i3slib
@@ -83,7 +83,7 @@ size_t          size_of(Type f)
   }
 }
 
-std::string     to_string(Image_format enc)
+std::string_view to_string_view(Image_format enc)
 {
   //static const int c_count = 6;
   //static const char* c_txt[c_count] = { "jpg", "png", "dds", "ktx" };
@@ -101,14 +101,19 @@ std::string     to_string(Image_format enc)
   }
 }
 
-bool            from_string(const std::string& txt_utf8, Image_format* out)
+std::string     to_string(Image_format enc)
+{
+  return std::string(to_string_view(enc));
+}
+
+bool            from_string(std::string_view txt_utf8, Image_format* out)
 {
-  static const int c_count = 7;
-  static const char*  c_txt[c_count] = { "jpg", "png", "dds", "ktx", "ktx-etc2", "basis", "ktx2" };
-  static const Image_format c_val[c_count] = { Image_format::Jpg,Image_format::Png, Image_format::Dds, Image_format::Ktx, Image_format::Ktx, Image_format::Basis, Image_format::Ktx2 };
+  static constexpr int c_count = 7;
+  static constexpr std::string_view c_txt[c_count] = { "jpg", "png", "dds", "ktx", "ktx-etc2", "basis", "ktx2" };
+  static constexpr Image_format c_val[c_count] = { Image_format::Jpg,Image_format::Png, Image_format::Dds, Image_format::Ktx, Image_format::Ktx, Image_format::Basis, Image_format::Ktx2 };
   for (int i = 0; i < c_count; ++i)
   {
-    if (strcmp(txt_utf8.c_str(), c_txt[i]) == 0)
+    if (txt_utf8 == c_txt[i])
     {
       *out = c_val[i];
       return true;
@@ -390,6 +390,56 @@ struct Pcsl_paged_index_desc
   };
 };
 
+//! PCSL ( v2.0+ ) store.defaultGeometrySchema
+struct Pcsl_geometry_schema_desc
+{
+  // --- fields:
+  Attribute_storage_info_encoding encoding = Attribute_storage_info_encoding::Lepcc_xyz;
+  Vertex_attributes_desc          vertex_attributes;
+  // ---- 
+  friend bool operator==(const Pcsl_geometry_schema_desc& a, const Pcsl_geometry_schema_desc& b) {
+    return a.encoding == b.encoding && a.vertex_attributes == b.vertex_attributes;
+  }
+  SERIALIZABLE(Pcsl_geometry_schema_desc);
+  Pcsl_geometry_schema_desc() { vertex_attributes.position = { Type::Float64, 3 }; }
+  template< class Ar >void serialize(Ar& ar)
+  {
+    auto geometry_type = Mesh_topology::Points;
+    auto topology = Legacy_topology::Per_attribute_array;
+    std::vector< Binary_header_desc > hdrs; // no header: LEPCC buffers are self-describing
+    std::vector< Vertex_attrib_ordering > orderings{ Vertex_attrib_ordering::Position };
+    ar & utl::nvp("geometryType", utl::enum_str(geometry_type));
+    ar & utl::nvp("header", utl::seq(hdrs));
+    ar & utl::nvp("topology", utl::enum_str(topology));
+    ar & utl::nvp("ordering", utl::seq(orderings));
+    ar & utl::nvp("encoding", utl::enum_str(encoding));
+    ar & utl::nvp("vertexAttributes", vertex_attributes);
+  }
+};
+
+//! PCSL ( v2.0+ ) store
+struct Pcsl_store_desc
+{
+  // --- fields:
+  std::string               id;
+  std::string               version{ "2.0" };
+  utl::Vec4d                extent;
+  Pcsl_paged_index_desc     index;
+  Pcsl_geometry_schema_desc geometry_schema;
+  // --- serialization:
+  SERIALIZABLE(Pcsl_store_desc);
+  template< class Ar > void serialize(Ar& ar)
+  {
+    std::string profile("PointCloud");
+    ar & utl::opt("id", id, std::string());
+    ar & utl::nvp("profile", profile); //required
+    ar & utl::nvp("version", version); //required
+    ar & utl::nvp("extent", seq(extent));
+    ar & utl::nvp("index", index);
+    ar & utl::nvp("defaultGeometrySchema", geometry_schema);
+  }
+};
+
 struct Store_desc
 {
   // --- fields:
@@ -674,6 +724,47 @@ struct Layer_desc
   }
 };
 
+//! 3DSceneLayer.json of a point cloud scene layer ( PCSL v2.0+ )
+struct Pcsl_layer_desc
+{
+  // --- fields:
+  int id = 0;
+  std::string name;
+  std::string alias;
+  std::string description;
+  std::string copyright;
+  Full_extent full_extent;
+  Spatial_reference_desc spatial_ref;
+  Height_model_info_desc height_model_info;
+  std::vector< Capability > capabilities{ Capability::View, Capability::Query };
+  Pcsl_store_desc store;
+  std::vector< Field_desc > fields;
+  std::vector< Attribute_storage_info_desc > attribute_storage_info;
+  utl::Unparsed_field drawing_info;   //pass-thru. don't interpret
+  utl::Unparsed_field elevation_info; //pass-thru. don't interpret
+  // --- serialization:
+  SERIALIZABLE(Pcsl_layer_desc);
+  template< class Ar > void serialize(Ar& ar)
+  {
+    auto layer_type = Layer_type::Point_cloud;
+    ar & utl::nvp("id", id);
+    ar & utl::nvp("layerType", utl::enum_str(layer_type)); //required
+    ar & utl::opt("name", name, std::string());
+    ar & utl::opt("alias", alias, std::string());
+    ar & utl::opt("desc", description, std::string());
+    ar & utl::opt("copyrightText", copyright, std::string());
+    ar & utl::opt("fullExtent", full_extent, Full_extent());
+    ar & utl::nvp("spatialReference", spatial_ref);
+    ar & utl::opt("heightModelInfo", height_model_info, Height_model_info_desc());
+    ar & utl::nvp("capabilities", utl::seq(capabilities)); //required
+    ar & utl::nvp("store", store); //required
+    ar & utl::opt("fields", utl::seq(fields));
+    ar & utl::nvp("attributeStorageInfo", utl::seq(attribute_storage_info)); //required
+    ar & utl::opt("drawingInfo", drawing_info, utl::Unparsed_field());
+    ar & utl::opt("elevationInfo", elevation_info, utl::Unparsed_field());
+  }
+};
+
 struct Service_desc
 {
   // --- fields:
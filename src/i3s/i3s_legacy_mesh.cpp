@@ -27,6 +27,8 @@ email: contracts@esri.com
 #include "utils/utl_json_helper.h"
 #include <optional>
 #include <algorithm>
+#include <charconv>
+#include <sstream>
 
 template<> struct std::hash<i3slib::utl::Vec4<uint16_t>>
 {
@@ -330,16 +332,93 @@ Mesh_abstract*   parse_points_from_i3s(const utl::Vec3d& origin, const std::stri
   return nullptr;
 }
 
-void   encode_points_to_i3s(int count, const utl::Vec3d* xyz, const uint64_t* fids, std::string* feature_data_json, utl::Basic_tracker* )
+namespace
 {
-  Point_feature_data_desc desc;
-  desc.points.resize(count);
+
+// Same detection as in utl_variant.cpp: libstdc++ ( before GCC 11 ) and XCode don't provide std::to_chars for floating-point types.
+[[maybe_unused]] constexpr bool has_to_chars_fp_(...) { return false; }
+
+template<
+  typename T,
+  std::to_chars_result(*F)(char*, char*, T) = std::to_chars,
+  typename = std::void_t<decltype(std::to_chars(nullptr, nullptr, T{}))>
+>
+constexpr bool has_to_chars_fp_(T) { return true; }
+
+//! Writes the legacy featureData JSON of a point node straight into a buffer ( no DOM, no stream ).
+//! Output is compact but equivalent to utl::to_json(Point_feature_data_desc).
+class Point_feature_json_writer
+{
+public:
+  explicit Point_feature_json_writer(int count)
+    : m_out(utl::Buffer::create_writable_typed_view<char>(count * c_max_point_size + c_max_overhead))
+    , m_ptr(m_out.data())
+  {
+  }
+
+  void append(const char* str, size_t len) { std::memcpy(m_ptr, str, len); m_ptr += len; }
+  template< size_t N > void append(const char(&str)[N]) { append(str, N - 1); }
+  void append(int64_t v) { m_ptr = std::to_chars(m_ptr, m_ptr + c_max_number_size, v).ptr; }
+  // template, so that the to_chars branch is discarded when not available:
+  template< class T > void append_fp(T v)
+  {
+    if constexpr (has_to_chars_fp_(T{}))
+      m_ptr = std::to_chars(m_ptr, m_ptr + c_max_number_size, v).ptr;
+    else
+    {
+      if (!m_fallback)
+      {
+        m_fallback = std::make_unique<std::ostringstream>();
+        m_fallback->imbue(std::locale::classic());
+        m_fallback->precision(std::numeric_limits<T>::max_digits10);
+      }
+      m_fallback->str(std::string());
+      *m_fallback << v;
+      const auto str = m_fallback->str();
+      append(str.data(), std::min(str.size(), c_max_number_size));
+    }
+  }
+
+  utl::Raw_buffer_view finish()
+  {
+    I3S_ASSERT(m_ptr <= m_out.end());
+    m_out.shrink(static_cast<int>(m_ptr - m_out.data()));
+    return m_out;
+  }
+
+private:
+  // Shortest round-trip of a double is at most 24 characters ( e.g. "-2.2250738585072014e-308" ), int64 is at most 20:
+  static constexpr size_t c_max_number_size = 32;
+  static constexpr int    c_max_point_size = static_cast<int>(sizeof("{\"position\":[,,],\"id\":},") + 4 * c_max_number_size);
+  static constexpr int    c_max_overhead = static_cast<int>(sizeof("{\"featureData\":[]}"));
+
+  utl::Buffer_view<char>              m_out;
+  char*                               m_ptr;
+  std::unique_ptr<std::ostringstream> m_fallback;
+};
+
+}
+
+utl::Raw_buffer_view encode_points_to_i3s(int count, const utl::Vec3d* xyz, const uint64_t* fids, utl::Basic_tracker* )
+{
+  Point_feature_json_writer out(count);
+  out.append("{\"featureData\":[");
   for (int i = 0; i < count; ++i)
   {
-    desc.points[i].position = xyz[i];
-    desc.points[i].fid = fids[i];
+    if (i)
+      out.append(",");
+    out.append("{\"position\":[");
+    out.append_fp(xyz[i].x);
+    out.append(",");
+    out.append_fp(xyz[i].y);
+    out.append(",");
+    out.append_fp(xyz[i].z);
+    out.append("],\"id\":");
+    out.append(static_cast<int64_t>(fids[i])); // same as Point_feature_desc::fid
+    out.append("}");
   }
-  *feature_data_json = utl::to_json(desc);
+  out.append("]}");
+  return out.finish();
 }
 
 
@@ -663,11 +742,29 @@ Texture_meta::Wrap_mode Mesh_buffer_impl::get_wrap_mode(int uv_set) const
 // -----------------------------------------------------------------------------------
 //            struct Legacy_geometry_buffer_encoder
 // -----------------------------------------------------------------------------------
+
+//! De-indexes val into dst. Plain loops on raw pointers ( no per-element Mesh_attrb::operator[] ), so that the
+//! compiler can vectorize them: legacy buffer creation is bound by memory bandwidth.
+template< class T > static void gather_attribute(T* dst, const Mesh_attrb<T>& val)
+{
+  const T* src = val.values.data();
+  if (!val.index.size())
+  {
+    std::memcpy(dst, src, val.values.size() * sizeof(T));
+    return;
+  }
+  const uint32_t* index = val.index.data();
+  const int count = val.index.size();
+  for (int i = 0; i < count; ++i)
+    dst[i] = src[index[i]];
+}
+
 struct Legacy_geometry_buffer_encoder
 {
 private:
   enum class Legacy_attr : int { pos = 0, normal, uv, color, region, fid, face_range, _count };
-  template< class T, class Y = T > bool _encode(Legacy_attr what, const Mesh_attrb<T>& val);
+  template< class T > bool _encode(Legacy_attr what, const Mesh_attrb<T>& val);
+  char* _get_dst(Legacy_attr what) { m_is_written[(int)what] = true; return m_buffer.data() + m_offsets[(int)what]; }
 public:
   Legacy_geometry_buffer_encoder(int vtx_count, int fid_count, uint32_t attrib_mask, int face_range_count);
 
@@ -678,11 +775,12 @@ public:
   bool encode_regions(const Mesh_attrb< Uv_region>& val) { return _encode(Legacy_attr::region, val); }
   bool encode_feature_indices(const Mesh_attrb< uint64_t>& val);
 
-  utl::Raw_buffer_view finalize() const { utl::Raw_buffer_view  tmp; tmp.operator=(m_buffer); return tmp; }
+  utl::Raw_buffer_view finalize();
 
 private:
   static const int c_bpv[(int)Legacy_attr::_count];
-  std::array< int, (int)Legacy_attr::_count> m_offsets;
+  std::array< int, (int)Legacy_attr::_count + 1> m_offsets;
+  std::array< bool, (int)Legacy_attr::_count> m_is_written{}; // the other attributes are zeroed by finalize()
   int m_n, m_m;
   int fr_count;
   //bool m_has_region;
@@ -702,8 +800,8 @@ Legacy_geometry_buffer_encoder::Legacy_geometry_buffer_encoder(int vtx_count, in
   const int attr_size = (is_set(attrib_mask, Attrib_flag::Pos) ? 3 : 0) + (is_set(attrib_mask, Attrib_flag::Normal) ? 3 : 0) + (is_set(attrib_mask, Attrib_flag::Uv0) ? 2 : 0) +
     (is_set(attrib_mask, Attrib_flag::Color) ? 1 : 0) + (is_set(attrib_mask, Attrib_flag::Region) ? 2 : 0);
   const int expected_size = hdr_size + m_n * sizeof(float) * attr_size + m_m * sizeof(int64_t) + fr_count * 2 * sizeof(int);
+  // Single allocation, not initialized: every byte is written by the encode_xxx() calls or by finalize().
   m_buffer = utl::Buffer::create_writable_view(nullptr, expected_size);
-  memset(m_buffer.data(), 0x00, expected_size); //some attribute may not get written, so we should zero the buffer first.
   int iter = hdr_size;
 
   for (int i = 0; i < (int)Legacy_attr::_count; ++i)
@@ -720,16 +818,17 @@ Legacy_geometry_buffer_encoder::Legacy_geometry_buffer_encoder(int vtx_count, in
 
     iter += c_bpv[i] * (i < (int)Legacy_attr::fid ? m_n : (i < (int)Legacy_attr::face_range ? m_m : fr_count));
   }
+  m_offsets[(int)Legacy_attr::_count] = iter;
   int* hdr = reinterpret_cast<int*>(m_buffer.data());
   hdr[0] = m_n;
   hdr[1] = m_m;
   I3S_ASSERT(iter == expected_size);
 }
 
-template< class T, class Y > bool Legacy_geometry_buffer_encoder::_encode(Legacy_attr what, const Mesh_attrb<T>& val)
+template< class T > bool Legacy_geometry_buffer_encoder::_encode(Legacy_attr what, const Mesh_attrb<T>& val)
 {
   I3S_ASSERT((int)what < (int)Legacy_attr::_count);
-  I3S_ASSERT_EXT(c_bpv[(int)what] == sizeof(Y)); //static assert
+  I3S_ASSERT_EXT(c_bpv[(int)what] == sizeof(T)); //static assert
   const int count = val.size();
   if (!count)
     return true;
@@ -739,24 +838,12 @@ template< class T, class Y > bool Legacy_geometry_buffer_encoder::_encode(Legacy
     return false;
   }
   int expected_bytes = m_offsets[(int)what + 1] - m_offsets[(int)what];
-  if (expected_bytes > 0 && expected_bytes != sizeof(Y) * count)
+  if (expected_bytes > 0 && expected_bytes != sizeof(T) * count)
   {
     I3S_ASSERT(false);
     return false;
   }
-  Y* dst = reinterpret_cast<Y*>(m_buffer.data() + m_offsets[(int)what]);
-
-  if (!val.index.size() && sizeof(T) == sizeof(Y))
-  {
-    memcpy(dst, val.values.data(), val.values.size() * sizeof(T));
-  }
-  else
-  {
-    for (int i = 0; i < count; ++i)
-    {
-      dst[i] = static_cast<Y>(val[i]);
-    }
-  }
+  gather_attribute(reinterpret_cast<T*>(_get_dst(what)), val);
   return true;
 }
 
@@ -770,37 +857,22 @@ bool Legacy_geometry_buffer_encoder::encode_colors(const Mesh_attrb<utl::Vec4<ui
     return false;
   }
 
-  auto dst = reinterpret_cast<Rgba8*>(m_buffer.data() + m_offsets[attr]);
-  const auto count = val.size();
-  if (count == 0)
+  if (val.size() == 0)
   {
     // Fill with default color.
     constexpr Rgba8 default_color(0xff, 0xff, 0xff, 0xff);
-    std::fill_n(dst, m_n, default_color);
+    std::fill_n(reinterpret_cast<Rgba8*>(_get_dst(Legacy_attr::color)), m_n, default_color);
     return true;
   }
 
-  if (count != m_n)
-  {
-    I3S_ASSERT(false);
-    return false;
-  }
-
-  if (val.index.size() == 0)
-    std::copy_n(val.values.data(), m_n, dst);
-  else
-  {
-    for (int i = 0; i < count; ++i)
-      dst[i] = val.values[val.index[i]];
-  }
-
-  return true;
+  return _encode(Legacy_attr::color, val);
 }
 
 bool Legacy_geometry_buffer_encoder::encode_feature_indices(const Mesh_attrb< uint64_t>& val)
 {
-  int64_t* dst_fid = reinterpret_cast<int64_t*>(m_buffer.data() + m_offsets[(int)Legacy_attr::fid]);
-  utl::Vec2i* dst_fr = reinterpret_cast<utl::Vec2i*>(m_buffer.data() + m_offsets[(int)Legacy_attr::face_range]);
+  //Note: these pointers could be misaligned, hence the memcpy:
+  char* dst_fid = _get_dst(Legacy_attr::fid);
+  char* dst_fr = _get_dst(Legacy_attr::face_range);
 
   if (m_m == 1 && val.index.size() == 0)
   {
@@ -818,9 +890,8 @@ bool Legacy_geometry_buffer_encoder::encode_feature_indices(const Mesh_attrb< ui
     return false;
   }
 
-  // this one is different, we have to rebuild the face-range:
-  std::vector< utl::Vec2i> fr;
-  fr.reserve(m_m);
+  // this one is different, we have to rebuild the face-range ( written in place ):
+  int written_fr = 0;
   const int* i0 = reinterpret_cast<const int*>(val.index.data());
   const int* i1 = i0;
   const int* i2 = i0;
@@ -836,7 +907,7 @@ bool Legacy_geometry_buffer_encoder::encode_feature_indices(const Mesh_attrb< ui
       }
       ++i2;
     }
-    if (((i1 - i0) % 3) != 0 || ((i2 - i0) % 3) != 0)
+    if (((i1 - i0) % 3) != 0 || ((i2 - i0) % 3) != 0 || written_fr == fr_count)
     {
       I3S_ASSERT(false); //not a valid face range...
       return false;
@@ -844,23 +915,33 @@ bool Legacy_geometry_buffer_encoder::encode_feature_indices(const Mesh_attrb< ui
     }
     auto tri_a = (i1 - i0) / 3;
     auto tri_b = (i2 - 1 - i0) / 3;
-    fr.push_back(utl::Vec2i((int)tri_a, (int)tri_b));
+    const utl::Vec2i fr((int)tri_a, (int)tri_b);
+    memcpy(dst_fr + sizeof(fr) * written_fr++, &fr, sizeof(fr));
     i1 = i2;
     //++i2;
   } while (i2 < end);
-  if (fr.size() != fr_count)
+  if (written_fr != fr_count)
   {
     I3S_ASSERT_EXT(false); //not a valid face range
     return false;
   }
-  //write the fid:
-  //Note: this pointer could be misaligned:
-  for (int i = 0; i < val.values.size(); i++)
+  //write the fid ( uint64 -> int64 conversion doesn't change the bits ):
+  static_assert(sizeof(int64_t) == sizeof(uint64_t), "unexpected size");
+  memcpy(dst_fid, val.values.data(), val.values.size() * sizeof(int64_t));
+  return true;
+}
+
+utl::Raw_buffer_view Legacy_geometry_buffer_encoder::finalize()
+{
+  // Missing attributes are zero:
+  for (int i = 0; i < (int)Legacy_attr::_count; ++i)
   {
-    dst_fid[i] = static_cast<int64_t>(val.values[i]);
+    if (!m_is_written[i])
+      memset(m_buffer.data() + m_offsets[i], 0x00, m_offsets[i + 1] - m_offsets[i]);
   }
-  copy_elements(dst_fr, fr.data(), fr.size());
-  return true;
+  utl::Raw_buffer_view  tmp;
+  tmp.operator=(m_buffer);
+  return tmp;
 }
 
 
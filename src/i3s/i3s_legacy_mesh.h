@@ -37,7 +37,8 @@ I3S_EXPORT Mesh_abstract*   parse_mesh_from_bulk(const Mesh_bulk_data& data);
 I3S_EXPORT Mesh_abstract::Ptr create_empty_mesh();
 
 I3S_EXPORT Mesh_abstract*   parse_points_from_i3s(const  utl::Vec3d& origin,const std::string&  feature_data_json, const std::string& path, utl::Basic_tracker* trk);
-void             encode_points_to_i3s(int count, const utl::Vec3d* xyz, const uint64_t* fids, std::string* feature_data_json, utl::Basic_tracker*);
+//! Returns the legacy featureData JSON document of the points ( see Point_feature_data_desc ).
+utl::Raw_buffer_view encode_points_to_i3s(int count, const utl::Vec3d* xyz, const uint64_t* fids, utl::Basic_tracker*);
 
 I3S_EXPORT utl::Raw_buffer_view encode_legacy_buffer(const Mesh_abstract&  mesh, Attrib_flags * out_actual_attributes_mask=nullptr);
 
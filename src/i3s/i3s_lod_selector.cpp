@@ -0,0 +1,571 @@
+/*
+Copyright 2020 Esri
+
+Licensed under the Apache License, Version 2.0 (the "License"); you may not use
+this file except in compliance with the License. You may obtain a copy of
+the License at http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software distributed
+under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+CONDITIONS OF ANY KIND, either express or implied. See the License for the
+specific language governing permissions and limitations under the License.
+
+For additional information, contact:
+Environmental Systems Research Institute, Inc.
+Attn: Contracts Dept
+380 New York Street
+Redlands, California, USA 92373
+email: contracts@esri.com
+*/
+
+#include "pch.h"
+#include "i3s/i3s_lod_selector.h"
+#include "i3s/i3s_index_dom.h"
+#include "utils/utl_i3s_resource_defines.h"
+#include "utils/utl_json_helper.h"
+#include "utils/utl_quaternion.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
+
+namespace i3slib
+{
+
+namespace i3s
+{
+
+namespace
+{
+
+template<typename... Args>
+status_t log_error_s(utl::Basic_tracker* tracker, int code, Args&&... args)
+{
+  utl::Basic_tracker::log(tracker, utl::Log_level::Critical, code, std::forward<Args>(args)...);
+  return status_t(code);
+}
+
+constexpr uint8_t c_node_loaded = 1;    // the page of the node has been added
+constexpr uint8_t c_node_content = 2;   // the node has a mesh or points
+constexpr uint8_t c_node_resident = 4;  // see Lod_selector::set_resident()
+
+// Frustum test results:
+constexpr uint8_t c_outside = 0;
+constexpr uint8_t c_crossing = 1;
+constexpr uint8_t c_inside = 2;
+
+//! OBBs ( SoA ) tested against the frustum.
+struct Box_batch
+{
+  std::array< std::vector< double >, 3 > center;
+  std::array< std::vector< double >, 9 > axes;    // half axes ( extents * unit axes )
+
+  void resize(size_t count)
+  {
+    for (auto& v : center)
+      v.resize(count);
+    for (auto& v : axes)
+      v.resize(count);
+  }
+};
+
+//! Node fields needed by the selection.
+struct Node_entry
+{
+  uint32_t                index;
+  utl::Obb_abs            obb;
+  double                  lod_threshold;
+  bool                    has_content;
+  std::vector< uint32_t > children;
+};
+
+//! A box is outside if it is entirely behind one of the planes, inside if it is in front of all of them.
+//! This test is conservative: a few boxes near the corners of the frustum are reported as crossing it.
+void cull_boxes(const std::array< utl::Vec4d, 6 >& planes, const Box_batch& boxes, int count, uint8_t* state)
+{
+  const auto& c = boxes.center;
+  const auto& a = boxes.axes;
+  int i = 0;
+#if defined(__AVX2__)
+  const __m256d sign_mask = _mm256_set1_pd(-0.0);
+  for (; i + 4 <= count; i += 4)
+  {
+    const __m256d cx = _mm256_loadu_pd(&c[0][i]), cy = _mm256_loadu_pd(&c[1][i]), cz = _mm256_loadu_pd(&c[2][i]);
+    __m256d ax[9];
+    for (int k = 0; k < 9; ++k)
+      ax[k] = _mm256_loadu_pd(&a[k][i]);
+
+    __m256d outside = _mm256_setzero_pd(), crossing = _mm256_setzero_pd();
+    for (const auto& plane : planes)
+    {
+      const __m256d nx = _mm256_set1_pd(plane.x), ny = _mm256_set1_pd(plane.y), nz = _mm256_set1_pd(plane.z);
+      const __m256d dist = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(nx, cx), _mm256_mul_pd(ny, cy)),
+        _mm256_add_pd(_mm256_mul_pd(nz, cz), _mm256_set1_pd(plane.w)));
+      __m256d radius = _mm256_setzero_pd();
+      for (int k = 0; k < 9; k += 3)
+      {
+        const __m256d proj = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(nx, ax[k]), _mm256_mul_pd(ny, ax[k + 1])), _mm256_mul_pd(nz, ax[k + 2]));
+        radius = _mm256_add_pd(radius, _mm256_andnot_pd(sign_mask, proj));
+      }
+      outside = _mm256_or_pd(outside, _mm256_cmp_pd(dist, _mm256_xor_pd(radius, sign_mask), _CMP_LT_OQ));
+      crossing = _mm256_or_pd(crossing, _mm256_cmp_pd(dist, radius, _CMP_LT_OQ));
+    }
+    const int outside_mask = _mm256_movemask_pd(outside);
+    const int crossing_mask = _mm256_movemask_pd(crossing);
+    for (int k = 0; k < 4; ++k)
+      state[i + k] = (outside_mask >> k) & 1 ? c_outside : (crossing_mask >> k) & 1 ? c_crossing : c_inside;
+  }
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  const __m128d sign_mask = _mm_set1_pd(-0.0);
+  for (; i + 2 <= count; i += 2)
+  {
+    const __m128d cx = _mm_loadu_pd(&c[0][i]), cy = _mm_loadu_pd(&c[1][i]), cz = _mm_loadu_pd(&c[2][i]);
+    __m128d ax[9];
+    for (int k = 0; k < 9; ++k)
+      ax[k] = _mm_loadu_pd(&a[k][i]);
+
+    __m128d outside = _mm_setzero_pd(), crossing = _mm_setzero_pd();
+    for (const auto& plane : planes)
+    {
+      const __m128d nx = _mm_set1_pd(plane.x), ny = _mm_set1_pd(plane.y), nz = _mm_set1_pd(plane.z);
+      const __m128d dist = _mm_add_pd(_mm_add_pd(_mm_mul_pd(nx, cx), _mm_mul_pd(ny, cy)),
+        _mm_add_pd(_mm_mul_pd(nz, cz), _mm_set1_pd(plane.w)));
+      __m128d radius = _mm_setzero_pd();
+      for (int k = 0; k < 9; k += 3)
+      {
+        const __m128d proj = _mm_add_pd(_mm_add_pd(_mm_mul_pd(nx, ax[k]), _mm_mul_pd(ny, ax[k + 1])), _mm_mul_pd(nz, ax[k + 2]));
+        radius = _mm_add_pd(radius, _mm_andnot_pd(sign_mask, proj));
+      }
+      outside = _mm_or_pd(outside, _mm_cmplt_pd(dist, _mm_xor_pd(radius, sign_mask)));
+      crossing = _mm_or_pd(crossing, _mm_cmplt_pd(dist, radius));
+    }
+    const int outside_mask = _mm_movemask_pd(outside);
+    const int crossing_mask = _mm_movemask_pd(crossing);
+    for (int k = 0; k < 2; ++k)
+      state[i + k] = (outside_mask >> k) & 1 ? c_outside : (crossing_mask >> k) & 1 ? c_crossing : c_inside;
+  }
+#endif
+  for (; i < count; ++i)
+  {
+    state[i] = c_inside;
+    for (const auto& plane : planes)
+    {
+      const double dist = plane.x * c[0][i] + plane.y * c[1][i] + plane.z * c[2][i] + plane.w;
+      double radius = 0.0;
+      for (int k = 0; k < 9; k += 3)
+        radius += std::abs(plane.x * a[k][i] + plane.y * a[k + 1][i] + plane.z * a[k + 2][i]);
+      if (dist < -radius)
+      {
+        state[i] = c_outside;
+        break;
+      }
+      if (dist < radius)
+        state[i] = c_crossing;
+    }
+  }
+}
+
+//! Sort key of a node: the bits of a positive float are in the same order as its value.
+uint64_t get_sort_key(double distance, uint32_t node)
+{
+  const auto value = static_cast<float>(distance);
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return (static_cast<uint64_t>(bits) << 32) | node;
+}
+
+//! Sorts by key ( see get_sort_key() ): LSD radix sort on the two 16-bit digits of the key, the order of equal keys is kept.
+void sort_by_key(std::vector< uint64_t >& items, std::vector< uint64_t >& scratch, std::vector< uint32_t >& histogram)
+{
+  constexpr size_t c_min_radix_count = 4096; // std::sort() is faster below
+  if (items.size() < c_min_radix_count)
+  {
+    std::sort(items.begin(), items.end());
+    return;
+  }
+  histogram.resize(size_t(1) << 16);
+  scratch.resize(items.size());
+  for (int shift = 32; shift < 64; shift += 16)
+  {
+    std::fill(histogram.begin(), histogram.end(), 0);
+    for (auto item : items)
+      ++histogram[(item >> shift) & 0xFFFF];
+    uint32_t offset = 0;
+    for (auto& count : histogram)
+      offset += std::exchange(count, offset);
+    for (auto item : items)
+      scratch[histogram[(item >> shift) & 0xFFFF]++] = item;
+    items.swap(scratch);
+  }
+}
+
+//! Keeps the highest priority request of each id, then the max_count ones of highest priority ( in decreasing order ).
+void sort_requests(std::vector< std::pair< double, uint32_t > >& requests, int max_count, std::vector< uint32_t >& out)
+{
+  std::sort(requests.begin(), requests.end(), [](const auto& a, const auto& b)
+  {
+    return a.second != b.second ? a.second < b.second : a.first > b.first;
+  });
+  requests.erase(std::unique(requests.begin(), requests.end(), [](const auto& a, const auto& b) { return a.second == b.second; }), requests.end());
+  const auto count = std::min(requests.size(), static_cast<size_t>(std::max(max_count, 0)));
+  std::partial_sort(requests.begin(), requests.begin() + count, requests.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+  out.resize(count);
+  for (size_t i = 0; i < count; ++i)
+    out[i] = requests[i].second;
+}
+
+class Lod_selector_impl : public Lod_selector
+{
+public:
+  Lod_selector_impl(const Lod_selector_params& params, Spatial_reference_xform::cptr xform, utl::Basic_tracker* trk)
+    : m_params(params), m_xform(std::move(xform)), m_trk(trk)
+  {
+    I3S_ASSERT(m_params.nodes_per_page > 0);
+  }
+
+  // --- Lod_selector:
+  virtual status_t  add_node_page(uint32_t page_index, const std::string& json) override;
+  virtual bool      has_node_page(uint32_t page_index) const override { return page_index < m_pages.size() && m_pages[page_index]; }
+  virtual void      set_resident(uint32_t node, bool is_resident) override;
+  virtual void      select(const Lod_view& view, Lod_selection* out) override;
+
+private:
+  status_t  _parse_page(uint32_t page_index, const std::string& json, std::vector< Node_entry >& nodes) const;
+  status_t  _add_nodes(uint32_t page_index, const std::vector< Node_entry >& nodes);
+  void      _resize(size_t node_count);
+  bool      _is_loaded(uint32_t node) const { return node < m_flags.size() && (m_flags[node] & c_node_loaded); }
+  bool      _needs_refinement(uint32_t node, double distance, double screen_size, double focal_length) const;
+  void      _cull(const Lod_view& view);
+
+  Lod_selector_params           m_params;
+  Spatial_reference_xform::cptr m_xform;
+  utl::Basic_tracker*           m_trk;
+  std::vector< uint8_t >        m_pages;  // 1 if the page has been added
+
+  // --- nodes ( SoA, indexed by node ):
+  std::array< std::vector< double >, 3 > m_center;  // cartesian
+  std::array< std::vector< float >, 9 >  m_axes;    // half axes ( extents * unit axes )
+  std::vector< float >          m_radius;
+  std::vector< double >         m_lod_threshold;
+  std::vector< uint32_t >       m_first_child;      // in m_children
+  std::vector< uint32_t >       m_child_count;
+  std::vector< uint8_t >        m_flags;
+  std::vector< uint32_t >       m_children;
+  std::vector< uint32_t >       m_visit_frame;      // frame of the last visit: node pages may have cycles or shared children.
+
+  // --- per frame:
+  uint32_t                      m_frame = 0;
+  std::vector< uint32_t >       m_frontier, m_next;
+  std::vector< uint8_t >        m_state, m_next_state;  // frustum test of the frontier ( c_inside is inherited by children )
+  std::vector< double >         m_distance;
+  std::vector< int >            m_batch_entries;        // frontier entries to test
+  std::vector< uint8_t >        m_batch_state;
+  Box_batch                     m_batch;
+  std::vector< uint64_t >       m_render, m_sort_scratch;   // see get_sort_key()
+  std::vector< uint32_t >       m_histogram;
+  std::vector< std::pair< double, uint32_t > > m_fetch, m_page_fetch;
+};
+
+status_t Lod_selector_impl::_parse_page(uint32_t page_index, const std::string& json, std::vector< Node_entry >& nodes) const
+{
+  const auto doc_name = "nodepages/" + std::to_string(page_index);
+  const auto first_node = static_cast<uint64_t>(page_index) * m_params.nodes_per_page;
+  if (m_params.layer_type == Layer_type::Point_cloud)
+  {
+    Pcsl_node_page_desc page;
+    if (!from_json_safe(json, &page, m_trk, doc_name))
+      return IDS_I3S_JSON_PARSING_ERROR;
+    nodes.resize(page.nodes.size());
+    for (size_t i = 0; i < page.nodes.size(); ++i)
+    {
+      const auto& src = page.nodes[i];
+      auto& node = nodes[i];
+      node.index = static_cast<uint32_t>(first_node + i);
+      node.obb = src.obb;
+      node.lod_threshold = src.lod_threshold;
+      node.has_content = src.vertex_count > 0;
+      node.children.resize(src.child_count);
+      for (uint32_t k = 0; k < src.child_count; ++k)
+        node.children[k] = src.first_child + k;
+    }
+  }
+  else
+  {
+    Node_page_desc_v17 page;
+    if (!from_json_safe(json, &page, m_trk, doc_name))
+      return IDS_I3S_JSON_PARSING_ERROR;
+    nodes.resize(page.nodes.size());
+    for (size_t i = 0; i < page.nodes.size(); ++i)
+    {
+      auto& src = page.nodes[i];
+      if (src.index < first_node || src.index >= first_node + m_params.nodes_per_page)
+        return log_error_s(m_trk, IDS_I3S_OUT_OF_RANGE_ID, doc_name + ".nodes.index", std::to_string(src.index), std::to_string(first_node + m_params.nodes_per_page - 1));
+      auto& node = nodes[i];
+      node.index = src.index;
+      node.obb = src.obb;
+      node.lod_threshold = src.lod_threshold;
+      node.has_content = src.mesh.geometry.resource_id != std::numeric_limits<uint32_t>::max();
+      node.children = std::move(src.children);
+    }
+  }
+  if (nodes.size() > m_params.nodes_per_page)
+    return log_error_s(m_trk, IDS_I3S_OUT_OF_RANGE_ID, doc_name + ".nodes.length", std::to_string(nodes.size()), std::to_string(m_params.nodes_per_page));
+  return IDS_I3S_OK;
+}
+
+void Lod_selector_impl::_resize(size_t node_count)
+{
+  if (node_count <= m_flags.size())
+    return;
+  for (auto& v : m_center)
+    v.resize(node_count);
+  for (auto& v : m_axes)
+    v.resize(node_count);
+  m_radius.resize(node_count);
+  m_lod_threshold.resize(node_count);
+  m_first_child.resize(node_count);
+  m_child_count.resize(node_count);
+  m_flags.resize(node_count, 0);
+  m_visit_frame.resize(node_count, 0);
+}
+
+status_t Lod_selector_impl::add_node_page(uint32_t page_index, const std::string& json)
+{
+  // node pages don't change:
+  if (has_node_page(page_index))
+    return IDS_I3S_OK;
+
+  std::vector< Node_entry > nodes;
+  auto status = _parse_page(page_index, json, nodes);
+  if (status != IDS_I3S_OK)
+    return status;
+  return _add_nodes(page_index, nodes);
+}
+
+status_t Lod_selector_impl::_add_nodes(uint32_t page_index, const std::vector< Node_entry >& nodes)
+{
+  // centers to cartesian space, at once:
+  std::vector< utl::Vec3d > centers(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i)
+    centers[i] = nodes[i].obb.center;
+  if (m_xform && m_xform->transform(Spatial_reference_xform::Sr_type::Dst_sr, Spatial_reference_xform::Sr_type::Dst_cartesian,
+    centers.data(), static_cast<int>(centers.size())) != Spatial_reference_xform::Status_t::Ok)
+    return log_error_s(m_trk, IDS_I3S_INTERNAL_ERROR, std::string("cartesian transform of nodepages/") + std::to_string(page_index));
+
+  _resize((static_cast<size_t>(page_index) + 1) * m_params.nodes_per_page);
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    const auto& node = nodes[i];
+    const auto n = node.index;
+    utl::Vec3d axes[3];
+    utl::quaternion_axes(node.obb.orientation, axes[0], axes[1], axes[2]);
+    for (int k = 0; k < 3; ++k)
+    {
+      const auto half_axis = axes[k] * static_cast<double>(node.obb.extents[k]);
+      for (int j = 0; j < 3; ++j)
+        m_axes[3 * k + j][n] = static_cast<float>(half_axis[j]);
+      m_center[k][n] = centers[i][k];
+    }
+    m_radius[n] = node.obb.radius();
+    m_lod_threshold[n] = node.lod_threshold;
+    m_first_child[n] = static_cast<uint32_t>(m_children.size());
+    m_child_count[n] = static_cast<uint32_t>(node.children.size());
+    m_children.insert(m_children.end(), node.children.begin(), node.children.end());
+    m_flags[n] = (m_flags[n] & c_node_resident) | c_node_loaded | (node.has_content ? c_node_content : 0);
+  }
+
+  if (page_index >= m_pages.size())
+    m_pages.resize(page_index + 1, 0);
+  m_pages[page_index] = 1;
+  return IDS_I3S_OK;
+}
+
+void Lod_selector_impl::set_resident(uint32_t node, bool is_resident)
+{
+  if (node >= m_flags.size())
+    _resize((static_cast<size_t>(node / m_params.nodes_per_page) + 1) * m_params.nodes_per_page);
+  if (is_resident)
+    m_flags[node] |= c_node_resident;
+  else
+    m_flags[node] &= ~c_node_resident;
+}
+
+bool Lod_selector_impl::_needs_refinement(uint32_t node, double distance, double screen_size, double focal_length) const
+{
+  const auto threshold = m_lod_threshold[node] * m_params.lod_factor;
+  switch (m_params.metric_type)
+  {
+    case Lod_metric_type::Max_screen_size:
+      return screen_size > threshold;
+    case Lod_metric_type::Max_screen_area:
+      // see screen_size_to_area()
+      return screen_size * screen_size * utl::c_pi * 0.25 > threshold;
+    case Lod_metric_type::Effective_density:
+    {
+      // the threshold is the density of the node in points per m^2:
+      const auto meters_per_pixel = distance / focal_length;
+      return threshold * meters_per_pixel * meters_per_pixel < m_params.target_point_density;
+    }
+    case Lod_metric_type::Distance:
+      return distance * m_params.lod_factor < m_lod_threshold[node];
+    default:
+      return false;
+  }
+}
+
+void Lod_selector_impl::_cull(const Lod_view& view)
+{
+  const auto count = m_frontier.size();
+  m_distance.resize(count);
+  m_batch_entries.clear();
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto n = m_frontier[i];
+    const utl::Vec3d center(m_center[0][n], m_center[1][n], m_center[2][n]);
+    m_distance[i] = center.distance(view.eye);
+    if (m_state[i] != c_inside)
+      m_batch_entries.push_back(static_cast<int>(i));
+  }
+
+  // children of a node inside of the frustum are inside too ( their geometry is in the OBB of the node ):
+  const auto batch_count = m_batch_entries.size();
+  m_batch.resize(batch_count);
+  for (size_t i = 0; i < batch_count; ++i)
+  {
+    const auto n = m_frontier[m_batch_entries[i]];
+    for (int k = 0; k < 3; ++k)
+      m_batch.center[k][i] = m_center[k][n];
+    for (int k = 0; k < 9; ++k)
+      m_batch.axes[k][i] = m_axes[k][n];
+  }
+  m_batch_state.resize(batch_count);
+  cull_boxes(view.planes, m_batch, static_cast<int>(batch_count), m_batch_state.data());
+  for (size_t i = 0; i < batch_count; ++i)
+    m_state[m_batch_entries[i]] = m_batch_state[i];
+}
+
+void Lod_selector_impl::select(const Lod_view& view, Lod_selection* out)
+{
+  out->render.clear();
+  out->fetch.clear();
+  out->page_fetch.clear();
+  out->visited = 0;
+  out->culled = 0;
+  m_render.clear();
+  m_fetch.clear();
+  m_page_fetch.clear();
+
+  constexpr uint32_t c_root = 0;
+  if (!_is_loaded(c_root))
+  {
+    out->page_fetch.push_back(c_root / m_params.nodes_per_page);
+    return;
+  }
+
+  auto request_page = [this](uint32_t node, double priority)
+  {
+    m_page_fetch.emplace_back(priority, node / m_params.nodes_per_page);
+  };
+
+  if (++m_frame == 0)
+  {
+    std::fill(m_visit_frame.begin(), m_visit_frame.end(), 0);
+    m_frame = 1;
+  }
+  m_visit_frame[c_root] = m_frame;
+  m_frontier.assign(1, c_root);
+  m_state.assign(1, c_crossing);
+  while (!m_frontier.empty())
+  {
+    _cull(view);
+    out->visited += m_frontier.size();
+
+    m_next.clear();
+    m_next_state.clear();
+    for (size_t i = 0; i < m_frontier.size(); ++i)
+    {
+      if (m_state[i] == c_outside)
+      {
+        ++out->culled;
+        continue;
+      }
+      const auto n = m_frontier[i];
+      const auto distance = m_distance[i];
+      const double radius = m_radius[n];
+      const auto screen_size = distance > radius ? 2.0 * radius * view.focal_length / distance : std::numeric_limits<double>::max();
+      const bool has_content = (m_flags[n] & c_node_content) != 0;
+      const auto children = m_children.data() + m_first_child[n];
+      const auto child_count = m_child_count[n];
+
+      if (child_count && (distance <= radius || _needs_refinement(n, distance, screen_size, view.focal_length)))
+      {
+        // the node is replaced by its children once they can all be drawn:
+        bool is_ready = true;
+        for (uint32_t k = 0; k < child_count && is_ready; ++k)
+        {
+          const auto flags = _is_loaded(children[k]) ? m_flags[children[k]] : 0;
+          is_ready = (flags & c_node_loaded) && (!(flags & c_node_content) || (flags & c_node_resident));
+        }
+        if (is_ready || !has_content)
+        {
+          for (uint32_t k = 0; k < child_count; ++k)
+          {
+            if (_is_loaded(children[k]))
+            {
+              // a node is visited once per frame:
+              if (m_visit_frame[children[k]] == m_frame)
+                continue;
+              m_visit_frame[children[k]] = m_frame;
+              m_next.push_back(children[k]);
+              m_next_state.push_back(m_state[i]);
+            }
+            else
+              request_page(children[k], screen_size);
+          }
+          continue;
+        }
+        for (uint32_t k = 0; k < child_count; ++k)
+        {
+          if (!_is_loaded(children[k]))
+            request_page(children[k], screen_size);
+          else if ((m_flags[children[k]] & (c_node_content | c_node_resident)) == c_node_content)
+            m_fetch.emplace_back(screen_size, children[k]);
+        }
+      }
+
+      if (!has_content)
+        continue;
+      if (m_flags[n] & c_node_resident)
+        m_render.push_back(get_sort_key(distance, n));
+      else
+        m_fetch.emplace_back(screen_size, n);
+    }
+    m_frontier.swap(m_next);
+    m_state.swap(m_next_state);
+  }
+
+  // front to back:
+  sort_by_key(m_render, m_sort_scratch, m_histogram);
+  out->render.resize(m_render.size());
+  for (size_t i = 0; i < m_render.size(); ++i)
+    out->render[i] = static_cast<uint32_t>(m_render[i]);
+
+  sort_requests(m_fetch, m_params.max_fetch_count, out->fetch);
+  sort_requests(m_page_fetch, m_params.max_page_fetch_count, out->page_fetch);
+}
+
+}
+
+Lod_selector* create_lod_selector(const Lod_selector_params& params, Spatial_reference_xform::cptr xform, utl::Basic_tracker* trk)
+{
+  return new Lod_selector_impl(params, std::move(xform), trk);
+}
+
+}
+
+} // namespace i3slib
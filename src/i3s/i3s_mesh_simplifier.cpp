@@ -0,0 +1,1091 @@
+/*
+Copyright 2020 Esri
+
+Licensed under the Apache License, Version 2.0 (the "License"); you may not use
+this file except in compliance with the License. You may obtain a copy of
+the License at http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software distributed
+under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+CONDITIONS OF ANY KIND, either express or implied. See the License for the
+specific language governing permissions and limitations under the License.
+
+For additional information, contact:
+Environmental Systems Research Institute, Inc.
+Attn: Contracts Dept
+380 New York Street
+Redlands, California, USA 92373
+email: contracts@esri.com
+*/
+
+#include "pch.h"
+#include "i3s/i3s_mesh_simplifier.h"
+#include "i3s/i3s_legacy_mesh.h"
+#include "utils/utl_i3s_assert.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+
+namespace i3slib
+{
+
+namespace i3s
+{
+
+namespace
+{
+
+// Clusters smaller than this are not worth a task of their own.
+constexpr int c_min_cluster_face_count = 16 * 1024;
+
+// A collapse is rejected if it rotates a remaining face by more than ~75 degrees ( not only if it flips it ),
+// otherwise faces may fold over in a few steps.
+constexpr double c_min_normal_cos = 0.25;
+
+// Minimal ratio of twice the area of a face to its squared longest edge after a collapse.
+constexpr double c_min_sliver_ratio = 1e-2;
+
+// Symmetric quadric of the ( area-weighted ) squared distance to a set of planes.
+struct Quadric
+{
+  double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+  double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+  double c = 0.0;
+  double weight = 0.0;
+
+  void add_plane(const utl::Vec3d& n, double d, double w)
+  {
+    a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z;
+    a11 += w * n.y * n.y; a12 += w * n.y * n.z; a22 += w * n.z * n.z;
+    b0 += w * n.x * d; b1 += w * n.y * d; b2 += w * n.z * d;
+    c += w * d * d;
+    weight += w;
+  }
+
+  Quadric& operator+=(const Quadric& q)
+  {
+    a00 += q.a00; a01 += q.a01; a02 += q.a02;
+    a11 += q.a11; a12 += q.a12; a22 += q.a22;
+    b0 += q.b0; b1 += q.b1; b2 += q.b2;
+    c += q.c;
+    weight += q.weight;
+    return *this;
+  }
+
+  // Mean squared distance of p to the planes.
+  double error(const utl::Vec3d& p) const
+  {
+    if (weight <= 0.0)
+      return 0.0;
+
+    const double e =
+      a00 * p.x * p.x + a11 * p.y * p.y + a22 * p.z * p.z
+      + 2.0 * (a01 * p.x * p.y + a02 * p.x * p.z + a12 * p.y * p.z)
+      + 2.0 * (b0 * p.x + b1 * p.y + b2 * p.z) + c;
+    return std::max(e, 0.0) / weight;
+  }
+};
+
+typedef std::array<int, 3> Face;
+
+// Indexed triangle mesh the decimation works on. Vertices are the unique combinations of position and attributes,
+// several vertices may share a position ( seams ).
+struct Decimation_mesh
+{
+  std::vector<utl::Vec3d> positions;     // cartesian, relative to the center of the mesh.
+  std::vector<int>        vertex_position;
+  std::vector<int>        vertex_class;  // a vertex is only collapsed onto a vertex of the same class ( region and feature ).
+  std::vector<Face>       faces;
+};
+
+// Positions that must not move: open borders, non-manifold edges and seams.
+std::vector<char> get_locked_positions(const Decimation_mesh& mesh)
+{
+  std::vector<char> locked(mesh.positions.size(), 0);
+  std::vector<int> position_vertex(mesh.positions.size(), -1);
+  std::unordered_map<uint64_t, int> edge_face_count(mesh.faces.size() * 2);
+  for (const auto& f : mesh.faces)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      const auto v = f[i];
+      const auto p = mesh.vertex_position[v];
+      if (position_vertex[p] < 0)
+        position_vertex[p] = v;
+      else if (position_vertex[p] != v)
+        locked[p] = 1;
+
+      const auto q = mesh.vertex_position[f[(i + 1) % 3]];
+      const auto key = (static_cast<uint64_t>(std::min(p, q)) << 32) | static_cast<uint32_t>(std::max(p, q));
+      ++edge_face_count[key];
+    }
+  }
+
+  for (const auto& [key, count] : edge_face_count)
+  {
+    if (count != 2)
+    {
+      locked[static_cast<size_t>(key >> 32)] = 1;
+      locked[static_cast<size_t>(key & 0xffffffff)] = 1;
+    }
+  }
+  return locked;
+}
+
+// Binary min-heap of vertices, keyed by the cost of their cheapest collapse. Keys are updated in place.
+class Vertex_queue
+{
+public:
+  explicit Vertex_queue(size_t vertex_count) : m_index(vertex_count, -1), m_costs(vertex_count, 0.0) {}
+  bool    empty() const { return m_heap.empty(); }
+  int     top() const { return m_heap.front(); }
+  double  top_cost() const { return m_costs[m_heap.front()]; }
+  void    update(int v, double cost);
+  void    remove(int v);
+
+private:
+  void    _sift_up(int i);
+  void    _sift_down(int i);
+
+private:
+  std::vector<int>    m_heap;
+  std::vector<int>    m_index; // position of the vertices in m_heap, -1 if not queued.
+  std::vector<double> m_costs;
+};
+
+void Vertex_queue::update(int v, double cost)
+{
+  const auto old_cost = m_costs[v];
+  m_costs[v] = cost;
+  if (m_index[v] < 0)
+  {
+    m_index[v] = static_cast<int>(m_heap.size());
+    m_heap.push_back(v);
+    _sift_up(m_index[v]);
+  }
+  else if (cost < old_cost)
+    _sift_up(m_index[v]);
+  else
+    _sift_down(m_index[v]);
+}
+
+void Vertex_queue::remove(int v)
+{
+  const auto i = m_index[v];
+  if (i < 0)
+    return;
+
+  const auto last = m_heap.back();
+  m_heap.pop_back();
+  m_index[v] = -1;
+  if (last != v)
+  {
+    m_heap[i] = last;
+    m_index[last] = i;
+    _sift_up(i);
+    _sift_down(m_index[last]);
+  }
+}
+
+void Vertex_queue::_sift_up(int i)
+{
+  const auto v = m_heap[i];
+  while (i > 0)
+  {
+    const auto parent = (i - 1) / 2;
+    if (m_costs[m_heap[parent]] <= m_costs[v])
+      break;
+    m_heap[i] = m_heap[parent];
+    m_index[m_heap[i]] = i;
+    i = parent;
+  }
+  m_heap[i] = v;
+  m_index[v] = i;
+}
+
+void Vertex_queue::_sift_down(int i)
+{
+  const auto v = m_heap[i];
+  const auto n = static_cast<int>(m_heap.size());
+  for (;;)
+  {
+    auto child = 2 * i + 1;
+    if (child >= n)
+      break;
+    if (child + 1 < n && m_costs[m_heap[child + 1]] < m_costs[m_heap[child]])
+      ++child;
+    if (m_costs[m_heap[child]] >= m_costs[v])
+      break;
+    m_heap[i] = m_heap[child];
+    m_index[m_heap[i]] = i;
+    i = child;
+  }
+  m_heap[i] = v;
+  m_index[v] = i;
+}
+
+// Half-edge collapse decimation, greedy on the quadric error of the remaining position.
+class Decimator
+{
+public:
+  explicit Decimator(Decimation_mesh& mesh);
+  void run(int target_face_count, double max_error);
+  std::vector<Face> get_faces() const;
+
+private:
+  double  _get_cost(int from, int to) const;
+  void    _get_targets(int v);
+  void    _enqueue(int v);
+  bool    _collapse(int from, int to);
+  const std::vector<int>& _get_live_faces(int v);
+
+private:
+  Decimation_mesh&                m_mesh;
+  std::vector<char>               m_locked;
+  std::vector<Quadric>            m_quadrics;             // per position.
+  std::vector<std::vector<int>>   m_vertex_faces;         // may contain dead faces until purged.
+  std::vector<std::vector<int>>   m_position_vertices;
+  std::vector<char>               m_dead_faces;
+  std::vector<char>               m_dead_vertices;
+  Vertex_queue                    m_queue;
+  int                             m_live_face_count = 0;
+  // scratch:
+  std::vector<int>                m_neighbors;
+  std::vector<char>               m_neighbor_seen;
+  std::vector<std::pair<double, int>> m_targets;
+};
+
+Decimator::Decimator(Decimation_mesh& mesh)
+  : m_mesh(mesh)
+  , m_locked(get_locked_positions(mesh))
+  , m_quadrics(mesh.positions.size())
+  , m_vertex_faces(mesh.vertex_position.size())
+  , m_position_vertices(mesh.positions.size())
+  , m_dead_faces(mesh.faces.size(), 0)
+  , m_dead_vertices(mesh.vertex_position.size(), 0)
+  , m_queue(mesh.vertex_position.size())
+  , m_live_face_count(static_cast<int>(mesh.faces.size()))
+{
+  const auto& pos = m_mesh.positions;
+  for (int f = 0; f < static_cast<int>(m_mesh.faces.size()); ++f)
+  {
+    const auto& face = m_mesh.faces[f];
+    const auto p0 = m_mesh.vertex_position[face[0]];
+    const auto p1 = m_mesh.vertex_position[face[1]];
+    const auto p2 = m_mesh.vertex_position[face[2]];
+    auto n = utl::Vec3d::cross(pos[p1] - pos[p0], pos[p2] - pos[p0]);
+    const auto len = n.length();
+    if (len > 0.0)
+    {
+      n /= len;
+      const auto d = -n.dot(pos[p0]);
+      const auto area = len * 0.5;
+      m_quadrics[p0].add_plane(n, d, area);
+      m_quadrics[p1].add_plane(n, d, area);
+      m_quadrics[p2].add_plane(n, d, area);
+    }
+    for (auto v : face)
+      m_vertex_faces[v].push_back(f);
+  }
+
+  for (int v = 0; v < static_cast<int>(m_mesh.vertex_position.size()); ++v)
+  {
+    if (!m_vertex_faces[v].empty())
+      m_position_vertices[m_mesh.vertex_position[v]].push_back(v);
+  }
+}
+
+double Decimator::_get_cost(int from, int to) const
+{
+  const auto p_from = m_mesh.vertex_position[from];
+  const auto p_to = m_mesh.vertex_position[to];
+  Quadric q = m_quadrics[p_from];
+  q += m_quadrics[p_to];
+  return q.error(m_mesh.positions[p_to]);
+}
+
+// Neighbors v may be collapsed onto, by increasing cost ( in m_targets ).
+void Decimator::_get_targets(int v)
+{
+  m_targets.clear();
+  for (auto f : _get_live_faces(v))
+  {
+    for (auto w : m_mesh.faces[f])
+    {
+      if (w != v && m_mesh.vertex_class[w] == m_mesh.vertex_class[v]
+          && std::find_if(m_targets.begin(), m_targets.end(), [w](const auto& t) { return t.second == w; }) == m_targets.end())
+        m_targets.emplace_back(_get_cost(v, w), w);
+    }
+  }
+  std::sort(m_targets.begin(), m_targets.end());
+}
+
+// ( Re-)queues v with the cost of its cheapest collapse.
+void Decimator::_enqueue(int v)
+{
+  if (m_dead_vertices[v] || m_locked[m_mesh.vertex_position[v]])
+    return;
+
+  _get_targets(v);
+  if (m_targets.empty())
+    m_queue.remove(v);
+  else
+    m_queue.update(v, m_targets.front().first);
+}
+
+const std::vector<int>& Decimator::_get_live_faces(int v)
+{
+  auto& faces = m_vertex_faces[v];
+  faces.erase(std::remove_if(faces.begin(), faces.end(), [this](int f) { return m_dead_faces[f] != 0; }), faces.end());
+  return faces;
+}
+
+bool Decimator::_collapse(int from, int to)
+{
+  const auto p_from = m_mesh.vertex_position[from];
+  const auto p_to = m_mesh.vertex_position[to];
+  const auto& pos = m_mesh.positions;
+
+  // Faces on the edge are removed. They must all use the target vertex ( i.e. the edge is not a seam ).
+  const auto& from_faces = _get_live_faces(from);
+  int shared_count = 0;
+  m_neighbors.clear();
+  for (auto f : from_faces)
+  {
+    for (auto w : m_mesh.faces[f])
+    {
+      if (m_mesh.vertex_position[w] == p_to)
+      {
+        if (w != to)
+          return false;
+        ++shared_count;
+      }
+      else if (w != from)
+        m_neighbors.push_back(m_mesh.vertex_position[w]);
+    }
+  }
+  if (shared_count == 0)
+    return false;
+
+  // Link condition: positions adjacent to both ends must be the apexes of the removed faces,
+  // otherwise the collapse would create non-manifold edges.
+  std::sort(m_neighbors.begin(), m_neighbors.end());
+  m_neighbors.erase(std::unique(m_neighbors.begin(), m_neighbors.end()), m_neighbors.end());
+  m_neighbor_seen.assign(m_neighbors.size(), 0);
+  int common_count = 0;
+  for (auto v : m_position_vertices[p_to])
+  {
+    if (m_dead_vertices[v])
+      continue;
+    for (auto f : m_vertex_faces[v])
+    {
+      if (m_dead_faces[f])
+        continue;
+      for (auto w : m_mesh.faces[f])
+      {
+        const auto p = m_mesh.vertex_position[w];
+        const auto it = std::lower_bound(m_neighbors.begin(), m_neighbors.end(), p);
+        if (it != m_neighbors.end() && *it == p && !m_neighbor_seen[it - m_neighbors.begin()])
+        {
+          m_neighbor_seen[it - m_neighbors.begin()] = 1;
+          ++common_count;
+        }
+      }
+    }
+  }
+  if (common_count != shared_count)
+    return false;
+
+  // Remaining faces must not flip or degenerate.
+  for (auto f : from_faces)
+  {
+    const auto& face = m_mesh.faces[f];
+    if (std::find(face.begin(), face.end(), to) != face.end())
+      continue;
+
+    std::array<utl::Vec3d, 3> before, after;
+    for (int i = 0; i < 3; ++i)
+    {
+      before[i] = pos[m_mesh.vertex_position[face[i]]];
+      after[i] = face[i] == from ? pos[p_to] : before[i];
+    }
+    const auto n0 = utl::Vec3d::cross(before[1] - before[0], before[2] - before[0]);
+    const auto n1 = utl::Vec3d::cross(after[1] - after[0], after[2] - after[0]);
+    if (n0.dot(n1) <= c_min_normal_cos * n0.length() * n1.length())
+      return false;
+
+    const auto max_edge_sqr = std::max({ (after[1] - after[0]).length_sqr(), (after[2] - after[1]).length_sqr(), (after[0] - after[2]).length_sqr() });
+    if (n1.length() <= c_min_sliver_ratio * max_edge_sqr)
+      return false;
+  }
+
+  // Collapse:
+  for (auto f : from_faces)
+  {
+    auto& face = m_mesh.faces[f];
+    if (std::find(face.begin(), face.end(), to) != face.end())
+    {
+      m_dead_faces[f] = 1;
+      --m_live_face_count;
+      continue;
+    }
+    for (auto& v : face)
+    {
+      if (v == from)
+        v = to;
+    }
+    m_vertex_faces[to].push_back(f);
+  }
+  m_vertex_faces[from].clear();
+  m_dead_vertices[from] = 1;
+  m_quadrics[p_to] += m_quadrics[p_from];
+  return true;
+}
+
+void Decimator::run(int target_face_count, double max_error)
+{
+  for (int v = 0; v < static_cast<int>(m_vertex_faces.size()); ++v)
+  {
+    if (!m_vertex_faces[v].empty())
+      _enqueue(v);
+  }
+
+  const double max_cost = max_error >= 0.0 ? max_error * max_error : std::numeric_limits<double>::max();
+  while (m_live_face_count > target_face_count && !m_queue.empty())
+  {
+    const auto v = m_queue.top();
+    if (m_queue.top_cost() > max_cost)
+      break;
+
+    // The cheapest valid collapse is applied. If there is none, v is left alone until its neighborhood changes.
+    m_queue.remove(v);
+    _get_targets(v);
+    const auto targets = m_targets;
+    for (const auto& [cost, to] : targets)
+    {
+      if (cost > max_cost)
+        break;
+      if (_collapse(v, to))
+      {
+        // Costs of the collapses around the target have changed:
+        _enqueue(to);
+        m_neighbors.clear();
+        for (auto f : _get_live_faces(to))
+          m_neighbors.insert(m_neighbors.end(), m_mesh.faces[f].begin(), m_mesh.faces[f].end());
+        std::sort(m_neighbors.begin(), m_neighbors.end());
+        m_neighbors.erase(std::unique(m_neighbors.begin(), m_neighbors.end()), m_neighbors.end());
+        for (auto w : m_neighbors)
+        {
+          if (w != to)
+            _enqueue(w);
+        }
+        break;
+      }
+    }
+  }
+}
+
+std::vector<Face> Decimator::get_faces() const
+{
+  std::vector<Face> faces;
+  faces.reserve(m_live_face_count);
+  for (size_t f = 0; f < m_mesh.faces.size(); ++f)
+  {
+    if (!m_dead_faces[f])
+      faces.push_back(m_mesh.faces[f]);
+  }
+  return faces;
+}
+
+// Sub-mesh made of the given faces, with compact positions and vertices.
+Decimation_mesh extract_cluster(const Decimation_mesh& src, const std::vector<int>& face_ids, std::vector<int>& local_to_src_vertex)
+{
+  Decimation_mesh dst;
+  std::unordered_map<int, int> vertex_map(face_ids.size());
+  std::unordered_map<int, int> position_map(face_ids.size());
+  dst.faces.reserve(face_ids.size());
+  local_to_src_vertex.clear();
+  for (auto f : face_ids)
+  {
+    Face face;
+    for (int i = 0; i < 3; ++i)
+    {
+      const auto v = src.faces[f][i];
+      auto it = vertex_map.insert({ v, static_cast<int>(local_to_src_vertex.size()) });
+      if (it.second)
+      {
+        const auto p = src.vertex_position[v];
+        auto it_pos = position_map.insert({ p, static_cast<int>(dst.positions.size()) });
+        if (it_pos.second)
+          dst.positions.push_back(src.positions[p]);
+        local_to_src_vertex.push_back(v);
+        dst.vertex_position.push_back(it_pos.first->second);
+        dst.vertex_class.push_back(src.vertex_class[v]);
+      }
+      face[i] = it.first->second;
+    }
+    dst.faces.push_back(face);
+  }
+  return dst;
+}
+
+// Splits faces in cluster_count spatially coherent sets of similar size ( recursive median split of the face centers ).
+void split_faces(const Decimation_mesh& mesh, std::vector<int>::iterator begin, std::vector<int>::iterator end,
+                 int cluster_count, std::vector<std::vector<int>>& clusters)
+{
+  if (cluster_count <= 1)
+  {
+    clusters.emplace_back(begin, end);
+    return;
+  }
+
+  const auto get_center = [&mesh](int f)
+  {
+    const auto& face = mesh.faces[f];
+    return mesh.positions[mesh.vertex_position[face[0]]]
+      + mesh.positions[mesh.vertex_position[face[1]]]
+      + mesh.positions[mesh.vertex_position[face[2]]];
+  };
+
+  utl::Vec3d lo(std::numeric_limits<double>::max()), hi(std::numeric_limits<double>::lowest());
+  for (auto it = begin; it != end; ++it)
+  {
+    const auto c = get_center(*it);
+    lo = utl::Vec3d(std::min(lo.x, c.x), std::min(lo.y, c.y), std::min(lo.z, c.z));
+    hi = utl::Vec3d(std::max(hi.x, c.x), std::max(hi.y, c.y), std::max(hi.z, c.z));
+  }
+  const auto extent = hi - lo;
+  const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+
+  const auto left_count = cluster_count / 2;
+  const auto mid = begin + (end - begin) * left_count / cluster_count;
+  const auto get_coord = [axis](const utl::Vec3d& p) { return axis == 0 ? p.x : (axis == 1 ? p.y : p.z); };
+  std::nth_element(begin, mid, end, [&](int a, int b) { return get_coord(get_center(a)) < get_coord(get_center(b)); });
+  split_faces(mesh, begin, mid, left_count, clusters);
+  split_faces(mesh, mid, end, cluster_count - left_count, clusters);
+}
+
+// Decimates clusters of the mesh concurrently, with cluster borders locked. Returns the remaining faces.
+std::vector<Face> decimate_clusters(const Decimation_mesh& mesh, int cluster_count, int target_face_count, double max_error)
+{
+  std::vector<int> face_ids(mesh.faces.size());
+  std::iota(face_ids.begin(), face_ids.end(), 0);
+  std::vector<std::vector<int>> clusters;
+  split_faces(mesh, face_ids.begin(), face_ids.end(), cluster_count, clusters);
+
+  const auto total = static_cast<double>(mesh.faces.size());
+  std::vector<std::future<std::vector<Face>>> tasks;
+  for (const auto& cluster : clusters)
+  {
+    tasks.push_back(std::async(std::launch::async, [&mesh, &cluster, total, target_face_count, max_error]()
+    {
+      std::vector<int> local_to_src;
+      auto local = extract_cluster(mesh, cluster, local_to_src);
+      const auto target = static_cast<int>(std::ceil(target_face_count * (cluster.size() / total)));
+      Decimator decimator(local);
+      decimator.run(target, max_error);
+      auto faces = decimator.get_faces();
+      for (auto& face : faces)
+      {
+        for (auto& v : face)
+          v = local_to_src[v];
+      }
+      return faces;
+    }));
+  }
+
+  std::vector<Face> faces;
+  for (auto& task : tasks)
+  {
+    auto cluster_faces = task.get();
+    faces.insert(faces.end(), cluster_faces.begin(), cluster_faces.end());
+  }
+  return faces;
+}
+
+// Unique combination of the attributes of a triangle corner.
+struct Corner_key
+{
+  utl::Vec3f  pos{ 0.0f };
+  utl::Vec3f  normal{ 0.0f };
+  utl::Vec2f  uv{ 0.0f };
+  Uv_region   region{ 0 };
+  Rgba8       color{ 0 };
+  uint32_t    padding = 0;
+  uint64_t    fid = 0;
+
+  friend bool operator==(const Corner_key& a, const Corner_key& b) { return std::memcmp(&a, &b, sizeof(Corner_key)) == 0; }
+};
+static_assert(sizeof(Corner_key) == 56, "Corner_key must not have implicit padding");
+
+struct Corner_key_hash
+{
+  size_t operator()(const Corner_key& k) const noexcept
+  {
+    uint64_t words[sizeof(Corner_key) / 8];
+    std::memcpy(words, &k, sizeof(Corner_key));
+    uint64_t h = 0;
+    for (auto w : words)
+    {
+      // splitmix64 finalizer, so that all bits of the ( mostly float ) words contribute to the low bits of the hash.
+      uint64_t x = w + h + 0x9e3779b97f4a7c15ull;
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+      h = x ^ (x >> 31);
+    }
+    return static_cast<size_t>(h);
+  }
+};
+
+template< class T > bool has_per_corner(const Mesh_attrb<T>& attr, int corner_count)
+{
+  return attr.size() == corner_count;
+}
+
+template< class T > utl::Buffer_view<T> gather(const Mesh_attrb<T>& attr, const std::vector<int>& corners)
+{
+  auto values = utl::Buffer::create_writable_typed_view<std::remove_const_t<T>>(static_cast<int>(corners.size()));
+  for (int i = 0; i < values.size(); ++i)
+    values[i] = attr[corners[i]];
+  return values;
+}
+
+// Welds the corners of a triangle mesh with identical attributes into vertices.
+void weld_corners(const Mesh_abstract& src, std::vector<int>* corner_vertex, std::vector<int>* vertex_corner)
+{
+  const auto corner_count = src.get_vertex_count();
+  const auto& rel_pos = src.get_relative_positions();
+  const auto& normals = src.get_normals();
+  const auto& uvs = src.get_uvs(0);
+  const auto& colors = src.get_colors();
+  const auto& regions = src.get_regions();
+  const auto& fids = src.get_feature_ids();
+  const bool has_normals = has_per_corner(normals, corner_count);
+  const bool has_uvs = has_per_corner(uvs, corner_count);
+  const bool has_colors = has_per_corner(colors, corner_count);
+  const bool has_regions = has_per_corner(regions, corner_count);
+  const bool has_fids = has_per_corner(fids, corner_count);
+
+  std::unordered_map<Corner_key, int, Corner_key_hash> vertex_map(corner_count);
+  corner_vertex->resize(corner_count);
+  vertex_corner->clear();
+  for (int i = 0; i < corner_count; ++i)
+  {
+    Corner_key key;
+    key.pos = rel_pos[i];
+    if (has_normals)
+      key.normal = normals[i];
+    if (has_uvs)
+      key.uv = uvs[i];
+    if (has_regions)
+      key.region = regions[i];
+    if (has_colors)
+      key.color = colors[i];
+    if (has_fids)
+      key.fid = fids[i];
+
+    auto it = vertex_map.insert({ key, static_cast<int>(vertex_corner->size()) });
+    if (it.second)
+      vertex_corner->push_back(i);
+    (*corner_vertex)[i] = it.first->second;
+  }
+}
+
+// Indexed copy of faces ( vertices of src ). Vertices are stored in the order of their first use ( vertex fetch order ).
+Mesh_abstract::Ptr create_indexed_mesh(const Mesh_abstract& src, const std::vector<Face>& faces, const std::vector<int>& vertex_corner)
+{
+  const auto corner_count = src.get_vertex_count();
+  const auto& rel_pos = src.get_relative_positions();
+  const auto& normals = src.get_normals();
+  const auto& uvs = src.get_uvs(0);
+  const auto& colors = src.get_colors();
+  const auto& regions = src.get_regions();
+  const auto& fids = src.get_feature_ids();
+
+  std::vector<int> vertex_map(vertex_corner.size(), -1);
+  std::vector<int> out_corners;
+  auto indices = utl::Buffer::create_writable_typed_view<uint32_t>(static_cast<int>(faces.size() * 3));
+  int k = 0;
+  for (const auto& face : faces)
+  {
+    for (auto v : face)
+    {
+      if (vertex_map[v] < 0)
+      {
+        vertex_map[v] = static_cast<int>(out_corners.size());
+        out_corners.push_back(vertex_corner[v]);
+      }
+      indices[k++] = static_cast<uint32_t>(vertex_map[v]);
+    }
+  }
+
+  Mesh_bulk_data bulk;
+  bulk.origin = src.get_origin();
+  bulk.rel_pos.values = gather(rel_pos, out_corners);
+  bulk.rel_pos.index = indices;
+  if (has_per_corner(normals, corner_count))
+  {
+    bulk.normals.values = gather(normals, out_corners);
+    bulk.normals.index = indices;
+  }
+  if (has_per_corner(uvs, corner_count))
+  {
+    bulk.uvs.values = gather(uvs, out_corners);
+    bulk.uvs.index = indices;
+  }
+  if (has_per_corner(colors, corner_count))
+  {
+    bulk.colors.values = gather(colors, out_corners);
+    bulk.colors.index = indices;
+  }
+  if (has_per_corner(regions, corner_count))
+  {
+    bulk.uv_region.values = gather(regions, out_corners);
+    bulk.uv_region.index = indices;
+  }
+  if (has_per_corner(fids, corner_count))
+  {
+    if (fids.index.size())
+    {
+      // Keep the feature values ( and their order ) of the source mesh:
+      auto fid_indices = utl::Buffer::create_writable_typed_view<uint32_t>(indices.size());
+      for (int i = 0; i < indices.size(); ++i)
+        fid_indices[i] = fids.get_mapped_index(out_corners[indices[i]]);
+      bulk.fids.values = fids.values;
+      bulk.fids.index = fid_indices;
+    }
+    else
+    {
+      bulk.fids.values = gather(fids, out_corners);
+      bulk.fids.index = indices;
+    }
+  }
+
+  return Mesh_abstract::Ptr(parse_mesh_from_bulk(bulk));
+}
+
+// Size of the simulated LRU cache of the vertex cache optimization.
+constexpr int c_cache_size = 32;
+
+// Score of a vertex in Tom Forsyth's "Linear-speed vertex cache optimisation": vertices recently used
+// and vertices with few remaining faces are favored.
+float get_vertex_score(int cache_position, int remaining_face_count)
+{
+  if (remaining_face_count == 0)
+    return -1.0f;
+
+  constexpr float c_last_face_score = 0.75f;
+  constexpr float c_cache_decay_power = 1.5f;
+  constexpr float c_valence_boost_scale = 2.0f;
+  constexpr float c_valence_boost_power = 0.5f;
+
+  float score = 0.0f;
+  if (cache_position >= 0)
+  {
+    // The vertices of the last face have a fixed score, so that the next face doesn't depend on their order.
+    if (cache_position < 3)
+      score = c_last_face_score;
+    else
+      score = std::pow(1.0f - static_cast<float>(cache_position - 3) / (c_cache_size - 3), c_cache_decay_power);
+  }
+  return score + c_valence_boost_scale * std::pow(static_cast<float>(remaining_face_count), -c_valence_boost_power);
+}
+
+// Greedy face ordering: the next face is the one of highest score among the faces of the cached vertices.
+std::vector<Face> optimize_face_order(const std::vector<Face>& faces, int vertex_count)
+{
+  const int face_count = static_cast<int>(faces.size());
+
+  // Faces of each vertex. The remaining ones are the first remaining_count[v] of its range:
+  std::vector<int> first_face(vertex_count + 1, 0);
+  for (const auto& face : faces)
+  {
+    for (auto v : face)
+      ++first_face[v + 1];
+  }
+  std::partial_sum(first_face.begin(), first_face.end(), first_face.begin());
+  std::vector<int> vertex_faces(first_face.back());
+  std::vector<int> remaining_count(vertex_count, 0);
+  for (int f = 0; f < face_count; ++f)
+  {
+    for (auto v : faces[f])
+      vertex_faces[first_face[v] + remaining_count[v]++] = f;
+  }
+
+  std::vector<int> cache_position(vertex_count, -1);
+  std::vector<float> vertex_score(vertex_count);
+  for (int v = 0; v < vertex_count; ++v)
+    vertex_score[v] = get_vertex_score(-1, remaining_count[v]);
+
+  auto get_face_score = [&faces, &vertex_score](int f)
+  {
+    return vertex_score[faces[f][0]] + vertex_score[faces[f][1]] + vertex_score[faces[f][2]];
+  };
+
+  int best = -1;
+  float best_score = -1.0f;
+  for (int f = 0; f < face_count; ++f)
+  {
+    if (get_face_score(f) > best_score)
+    {
+      best = f;
+      best_score = get_face_score(f);
+    }
+  }
+
+  std::vector<Face> out;
+  out.reserve(face_count);
+  std::vector<char> is_emitted(face_count, 0);
+  std::vector<int> cache, next_cache;
+  int next_unemitted = 0;
+  while (static_cast<int>(out.size()) < face_count)
+  {
+    if (best < 0)
+    {
+      // No face left around the cached vertices:
+      while (is_emitted[next_unemitted])
+        ++next_unemitted;
+      best = next_unemitted;
+    }
+
+    const auto& face = faces[best];
+    out.push_back(face);
+    is_emitted[best] = 1;
+    for (auto v : face)
+    {
+      auto begin = vertex_faces.begin() + first_face[v];
+      auto end = begin + remaining_count[v];
+      std::iter_swap(std::find(begin, end, best), end - 1);
+      --remaining_count[v];
+    }
+
+    // The vertices of the face move to the front of the cache:
+    next_cache.assign(face.begin(), face.end());
+    for (auto v : cache)
+    {
+      if (v != face[0] && v != face[1] && v != face[2])
+        next_cache.push_back(v);
+    }
+    for (size_t i = 0; i < next_cache.size(); ++i)
+    {
+      const auto v = next_cache[i];
+      cache_position[v] = i < c_cache_size ? static_cast<int>(i) : -1;
+      vertex_score[v] = get_vertex_score(cache_position[v], remaining_count[v]);
+    }
+    if (next_cache.size() > c_cache_size)
+      next_cache.resize(c_cache_size);
+    cache.swap(next_cache);
+
+    best = -1;
+    best_score = -1.0f;
+    for (auto v : cache)
+    {
+      for (int i = first_face[v]; i < first_face[v] + remaining_count[v]; ++i)
+      {
+        const auto score = get_face_score(vertex_faces[i]);
+        if (score > best_score)
+        {
+          best = vertex_faces[i];
+          best_score = score;
+        }
+      }
+    }
+  }
+  return out;
+}
+
+}
+
+Mesh_abstract::Ptr simplify_mesh(
+  const Mesh_abstract& src,
+  const Mesh_simplification_params& params,
+  const To_cartesian_fct& to_cartesian)
+{
+  const auto corner_count = src.get_vertex_count();
+  if (src.get_topology() != Mesh_topology::Triangles || corner_count % 3 != 0)
+    return nullptr;
+
+  std::vector<int> corner_vertex, vertex_corner;
+  weld_corners(src, &corner_vertex, &vertex_corner);
+
+  // Vertices sharing a position ( seams ) or a class:
+  const auto& rel_pos = src.get_relative_positions();
+  const auto& regions = src.get_regions();
+  const auto& fids = src.get_feature_ids();
+  const bool has_regions = has_per_corner(regions, corner_count);
+  const bool has_fids = has_per_corner(fids, corner_count);
+  Decimation_mesh mesh;
+  {
+    std::unordered_map<Corner_key, int, Corner_key_hash> position_map(vertex_corner.size());
+    std::unordered_map<Corner_key, int, Corner_key_hash> class_map;
+    for (auto corner : vertex_corner)
+    {
+      Corner_key position_key;
+      position_key.pos = rel_pos[corner];
+      auto it_pos = position_map.insert({ position_key, static_cast<int>(mesh.positions.size()) });
+      if (it_pos.second)
+        mesh.positions.push_back(src.get_origin() + utl::Vec3d(position_key.pos));
+      mesh.vertex_position.push_back(it_pos.first->second);
+
+      Corner_key class_key;
+      if (has_regions)
+        class_key.region = regions[corner];
+      if (has_fids)
+        class_key.fid = fids[corner];
+      mesh.vertex_class.push_back(class_map.insert({ class_key, static_cast<int>(class_map.size()) }).first->second);
+    }
+
+    for (int i = 0; i < corner_count; i += 3)
+    {
+      const Face face{ corner_vertex[i], corner_vertex[i + 1], corner_vertex[i + 2] };
+      const auto p0 = mesh.vertex_position[face[0]];
+      const auto p1 = mesh.vertex_position[face[1]];
+      const auto p2 = mesh.vertex_position[face[2]];
+      // Degenerated faces are dropped:
+      if (p0 != p1 && p1 != p2 && p2 != p0)
+        mesh.faces.push_back(face);
+    }
+  }
+
+  if (to_cartesian && !mesh.positions.empty() && !to_cartesian(mesh.positions.data(), static_cast<int>(mesh.positions.size())))
+    return nullptr;
+
+  // Quadrics are evaluated relative to the center of the mesh, not to lose precision on geocentric coordinates:
+  if (!mesh.positions.empty())
+  {
+    utl::Vec3d center(0.0);
+    for (const auto& p : mesh.positions)
+      center += p;
+    center /= static_cast<double>(mesh.positions.size());
+    for (auto& p : mesh.positions)
+      p -= center;
+  }
+
+  auto faces = std::move(mesh.faces);
+  const auto target_face_count = std::max(params.target_face_count, 0);
+  if (static_cast<int>(faces.size()) > target_face_count)
+  {
+    const int thread_count = params.thread_count > 0 ? params.thread_count : static_cast<int>(std::thread::hardware_concurrency());
+    const int cluster_count = std::min(thread_count, static_cast<int>(faces.size()) / c_min_cluster_face_count);
+    if (cluster_count > 1)
+    {
+      mesh.faces = std::move(faces);
+      faces = decimate_clusters(mesh, cluster_count, target_face_count, params.max_error);
+    }
+
+    // Cluster borders are unlocked for the final pass.
+    if (static_cast<int>(faces.size()) > target_face_count)
+    {
+      mesh.faces = std::move(faces);
+      Decimator decimator(mesh);
+      decimator.run(target_face_count, params.max_error);
+      faces = decimator.get_faces();
+    }
+  }
+
+  return create_indexed_mesh(src, faces, vertex_corner);
+}
+
+Mesh_abstract::Ptr optimize_vertex_cache(const Mesh_abstract& src)
+{
+  const auto corner_count = src.get_vertex_count();
+  if (src.get_topology() != Mesh_topology::Triangles || corner_count % 3 != 0)
+    return nullptr;
+
+  std::vector<int> corner_vertex, vertex_corner;
+  weld_corners(src, &corner_vertex, &vertex_corner);
+
+  std::vector<Face> faces(corner_count / 3);
+  for (int i = 0; i < corner_count; i += 3)
+    faces[i / 3] = { corner_vertex[i], corner_vertex[i + 1], corner_vertex[i + 2] };
+
+  return create_indexed_mesh(src, optimize_face_order(faces, static_cast<int>(vertex_corner.size())), vertex_corner);
+}
+
+Mesh_abstract::Ptr merge_meshes(const std::vector<const Mesh_abstract*>& meshes, const utl::Vec3d& origin)
+{
+  int corner_count = 0;
+  bool has_normals = true, has_uvs = true, has_colors = true, has_regions = true, has_fids = true;
+  for (auto mesh : meshes)
+  {
+    const auto count = mesh->get_vertex_count();
+    if (mesh->get_topology() != Mesh_topology::Triangles || count % 3 != 0)
+      return nullptr;
+
+    corner_count += count;
+    has_normals = has_normals && has_per_corner(mesh->get_normals(), count);
+    has_uvs = has_uvs && has_per_corner(mesh->get_uvs(0), count);
+    has_colors = has_colors && has_per_corner(mesh->get_colors(), count);
+    has_regions = has_regions && has_per_corner(mesh->get_regions(), count);
+    has_fids = has_fids && has_per_corner(mesh->get_feature_ids(), count);
+  }
+
+  Mesh_bulk_data bulk;
+  bulk.origin = origin;
+  auto rel_pos = utl::Buffer::create_writable_typed_view<utl::Vec3f>(corner_count);
+  utl::Buffer_view<utl::Vec3f> normals;
+  utl::Buffer_view<utl::Vec2f> uvs;
+  utl::Buffer_view<Rgba8> colors;
+  utl::Buffer_view<Uv_region> regions;
+  utl::Buffer_view<uint32_t> fid_indices;
+  if (has_normals)
+    normals = utl::Buffer::create_writable_typed_view<utl::Vec3f>(corner_count);
+  if (has_uvs)
+    uvs = utl::Buffer::create_writable_typed_view<utl::Vec2f>(corner_count);
+  if (has_colors)
+    colors = utl::Buffer::create_writable_typed_view<Rgba8>(corner_count);
+  if (has_regions)
+    regions = utl::Buffer::create_writable_typed_view<Uv_region>(corner_count);
+  if (has_fids)
+    fid_indices = utl::Buffer::create_writable_typed_view<uint32_t>(corner_count);
+
+  std::unordered_map<uint64_t, uint32_t> fid_map;
+  std::vector<uint64_t> fid_values;
+  int k = 0;
+  for (auto mesh : meshes)
+  {
+    const auto& src_pos = mesh->get_relative_positions();
+    const auto shift = mesh->get_origin() - origin;
+    for (int i = 0; i < mesh->get_vertex_count(); ++i, ++k)
+    {
+      rel_pos[k] = utl::Vec3f(utl::Vec3d(src_pos[i]) + shift);
+      if (has_normals)
+        normals[k] = mesh->get_normals()[i];
+      if (has_uvs)
+        uvs[k] = mesh->get_uvs(0)[i];
+      if (has_colors)
+        colors[k] = mesh->get_colors()[i];
+      if (has_regions)
+        regions[k] = mesh->get_regions()[i];
+      if (has_fids)
+      {
+        const auto fid = mesh->get_feature_ids()[i];
+        auto it = fid_map.insert({ fid, static_cast<uint32_t>(fid_values.size()) });
+        if (it.second)
+          fid_values.push_back(fid);
+        fid_indices[k] = it.first->second;
+      }
+    }
+  }
+
+  bulk.rel_pos.values = rel_pos;
+  bulk.normals.values = normals;
+  bulk.uvs.values = uvs;
+  bulk.colors.values = colors;
+  bulk.uv_region.values = regions;
+  if (has_fids)
+  {
+    bulk.fids.values = utl::Buffer::create_deep_copy(fid_values.data(), static_cast<int>(fid_values.size()));
+    bulk.fids.index = fid_indices;
+  }
+  return Mesh_abstract::Ptr(parse_mesh_from_bulk(bulk));
+}
+
+}
+
+} // namespace i3slib
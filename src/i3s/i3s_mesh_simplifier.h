@@ -0,0 +1,60 @@
+/*
+Copyright 2020 Esri
+
+Licensed under the Apache License, Version 2.0 (the "License"); you may not use
+this file except in compliance with the License. You may obtain a copy of
+the License at http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software distributed
+under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+CONDITIONS OF ANY KIND, either express or implied. See the License for the
+specific language governing permissions and limitations under the License.
+
+For additional information, contact:
+Environmental Systems Research Institute, Inc.
+Attn: Contracts Dept
+380 New York Street
+Redlands, California, USA 92373
+email: contracts@esri.com
+*/
+
+#pragma once
+
+#include "i3s/i3s_common_.h"
+#include "i3s/i3s_writer.h"
+#include "utils/utl_i3s_export.h"
+#include <functional>
+#include <vector>
+
+namespace i3slib
+{
+
+namespace i3s
+{
+
+//! Converts absolute positions ( in place ) to a cartesian frame in which the geometric error is measured.
+typedef std::function<bool(utl::Vec3d* xyz, int count)> To_cartesian_fct;
+
+//! Decimates a triangle mesh with quadric error metric half-edge collapses, until it has at most
+//! params.target_face_count triangles or the error exceeds params.max_error.
+//! Vertices are collapsed onto one of their neighbors, so the remaining ones keep their position and attributes.
+//! Vertices on open borders, non-manifold edges and attribute seams ( UV, normal, color, region or feature id ) are never removed,
+//! and a vertex is only collapsed onto a vertex of the same region and feature.
+//! Feature id values are kept in the same order, so that attribute buffers of the source mesh still apply.
+//! Returns nullptr if the mesh is not a triangle mesh or if the cartesian conversion fails.
+I3S_EXPORT Mesh_abstract::Ptr simplify_mesh(
+  const Mesh_abstract& src,
+  const Mesh_simplification_params& params,
+  const To_cartesian_fct& to_cartesian = nullptr);
+
+//! Reorders the triangles of a mesh for the post-transform vertex cache ( Forsyth ), then its vertices in the order of their
+//! first use ( vertex fetch ). Corners with identical attributes are welded: the returned mesh is indexed.
+//! Returns nullptr if the mesh is not a triangle mesh.
+I3S_EXPORT Mesh_abstract::Ptr optimize_vertex_cache(const Mesh_abstract& src);
+
+//! Concatenates the triangles of meshes, with positions relative to origin.
+//! Vertex attributes which are not available in every mesh are dropped.
+I3S_EXPORT Mesh_abstract::Ptr merge_meshes(const std::vector<const Mesh_abstract*>& meshes, const utl::Vec3d& origin);
+
+}
+
+} // namespace i3slib
@@ -0,0 +1,122 @@
+/*
+Copyright 2020 Esri
+
+Licensed under the Apache License, Version 2.0 (the "License"); you may not use
+this file except in compliance with the License. You may obtain a copy of
+the License at http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software distributed
+under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+CONDITIONS OF ANY KIND, either express or implied. See the License for the
+specific language governing permissions and limitations under the License.
+
+For additional information, contact:
+Environmental Systems Research Institute, Inc.
+Attn: Contracts Dept
+380 New York Street
+Redlands, California, USA 92373
+email: contracts@esri.com
+*/
+
+#include "pch.h"
+
+#include "i3s/i3s_node_store.h"
+
+#include <algorithm>
+
+namespace i3slib::i3s
+{
+
+bool Node_desc_store::set(const Node_desc_v17& desc)
+{
+  auto* chunk = m_nodes.get_or_create(desc.index >> c_chunk_bits);
+  const auto i = desc.index & ((1u << c_chunk_bits) - 1);
+  uint8_t state = Empty;
+  if (!chunk->state[i].compare_exchange_strong(state, Claimed, std::memory_order_relaxed))
+    return false;
+
+  auto& node = chunk->nodes[i];
+  node.index = desc.index;
+  node.parent_index = desc.parent_index;
+  node.lod_threshold = desc.lod_threshold;
+  node.obb = desc.obb;
+  node.mesh = desc.mesh;
+  node.child_count = static_cast<uint32_t>(desc.children.size());
+  if (node.child_count)
+  {
+    node.first_child = _reserve_children(node.child_count);
+    std::copy(desc.children.begin(), desc.children.end(), _get_pool_indices(node.first_child));
+  }
+  chunk->state[i].store(Published, std::memory_order_release);
+
+  const size_t size = static_cast<size_t>(desc.index) + 1;
+  auto current = m_size.load(std::memory_order_relaxed);
+  while (current < size && !m_size.compare_exchange_weak(current, size, std::memory_order_acq_rel))
+    ;
+  return true;
+}
+
+Node_desc_compact* Node_desc_store::get(uint32_t index)
+{
+  auto* chunk = m_nodes.get(index >> c_chunk_bits);
+  const auto i = index & ((1u << c_chunk_bits) - 1);
+  return chunk && chunk->state[i].load(std::memory_order_acquire) == Published ? &chunk->nodes[i] : nullptr;
+}
+
+const Node_desc_compact* Node_desc_store::get(uint32_t index) const
+{
+  return const_cast<Node_desc_store*>(this)->get(index);
+}
+
+Node_children Node_desc_store::get_children(const Node_desc_compact& node)
+{
+  if (!node.child_count)
+    return { nullptr, nullptr };
+  auto* first = _get_pool_indices(node.first_child);
+  return { first, first + node.child_count };
+}
+
+void Node_desc_store::get(const Node_desc_compact& node, Node_desc_v17* out) const
+{
+  out->index = node.index;
+  out->parent_index = node.parent_index;
+  out->lod_threshold = node.lod_threshold;
+  out->obb = node.obb;
+  out->mesh = node.mesh;
+  out->shared_resource = Shared_resource_ref_desc();
+  if (node.child_count)
+  {
+    const auto* first = _get_pool_indices(node.first_child);
+    out->children.assign(first, first + node.child_count);
+  }
+  else
+    out->children.clear();
+}
+
+//! The children of a node are contiguous: a range that doesn't fit in the current pool chunk starts the next one.
+uint64_t Node_desc_store::_reserve_children(uint32_t count)
+{
+  uint64_t first, next;
+  auto cursor = m_pool_cursor.load(std::memory_order_relaxed);
+  do
+  {
+    const auto chunk = cursor >> 32;
+    if ((cursor & 0xFFFFFFFF) + count <= c_pool_chunk_size)
+      first = cursor;
+    else
+      first = (chunk + 1) << 32;
+    // a range larger than a chunk has its own:
+    next = count <= c_pool_chunk_size ? first + count : first + (uint64_t(1) << 32);
+  } while (!m_pool_cursor.compare_exchange_weak(cursor, next, std::memory_order_relaxed));
+
+  m_pool.get_or_create(first >> 32, std::max(count, c_pool_chunk_size));
+  return first;
+}
+
+uint32_t* Node_desc_store::_get_pool_indices(uint64_t first_child) const
+{
+  auto* chunk = m_pool.get(first_child >> 32);
+  I3S_ASSERT(chunk);
+  return chunk->indices.get() + (first_child & 0xFFFFFFFF);
+}
+
+}
@@ -0,0 +1,196 @@
+/*
+Copyright 2020 Esri
+
+Licensed under the Apache License, Version 2.0 (the "License"); you may not use
+this file except in compliance with the License. You may obtain a copy of
+the License at http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software distributed
+under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+CONDITIONS OF ANY KIND, either express or implied. See the License for the
+specific language governing permissions and limitations under the License.
+
+For additional information, contact:
+Environmental Systems Research Institute, Inc.
+Attn: Contracts Dept
+380 New York Street
+Redlands, California, USA 92373
+email: contracts@esri.com
+*/
+
+#pragma once
+
+#include "i3s_index_dom.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+namespace i3slib::i3s
+{
+
+//! Node_desc_v17 without its children vector: the children are a range of the index pool of the Node_desc_store.
+//! Node_desc_v17::shared_resource isn't kept ( the writer doesn't set it ).
+struct Node_desc_compact
+{
+  uint32_t        index = std::numeric_limits<uint32_t>::max();
+  uint32_t        parent_index = std::numeric_limits<uint32_t>::max();
+  uint32_t        child_count = 0;
+  uint64_t        first_child = 0; // pool chunk << 32 | offset in the chunk
+  double          lod_threshold = 0.0;
+  utl::Obb_abs    obb;
+  Mesh_desc_v17   mesh;
+};
+
+//! Child indices of a node, in the pool of the Node_desc_store.
+class Node_children
+{
+public:
+  Node_children(uint32_t* b, uint32_t* e) : m_begin(b), m_end(e) {}
+  uint32_t*   begin() const { return m_begin; }
+  uint32_t*   end() const { return m_end; }
+  size_t      size() const { return m_end - m_begin; }
+private:
+  uint32_t*   m_begin;
+  uint32_t*   m_end;
+};
+
+//! Node descriptors implicitly indexed by Node_desc_v17::index. They are stored in chunks allocated on first use and never move:
+//! set() may be called concurrently ( for different nodes ) without lock nor reallocation.
+//! Reads are not synchronized with set(): nodes are read once all of them are set.
+class Node_desc_store
+{
+public:
+  Node_desc_store() = default;
+  Node_desc_store(const Node_desc_store&) = delete;
+  Node_desc_store& operator=(const Node_desc_store&) = delete;
+
+  //! false if the node has already been set.
+  bool                      set(const Node_desc_v17& desc);
+  //! nullptr if the node hasn't been set.
+  Node_desc_compact*        get(uint32_t index);
+  const Node_desc_compact*  get(uint32_t index) const;
+  Node_children             get_children(const Node_desc_compact& node);
+  //! Expanded copy of a node ( e.g. to write it in a node page ).
+  void                      get(const Node_desc_compact& node, Node_desc_v17* out) const;
+  //! 1 + the highest index set.
+  size_t                    size() const { return m_size.load(std::memory_order_acquire); }
+  //! Calls f(Node_desc_compact&) on the nodes set, by increasing index.
+  template< class F > void  for_each(F&& f);
+
+private:
+  static constexpr int      c_chunk_bits = 10;              // nodes per chunk
+  static constexpr int      c_segment_bits = 11;            // chunks per segment of the directories
+  static constexpr uint32_t c_pool_chunk_size = 1u << 16;   // child indices per pool chunk. Larger ranges have their own chunk.
+  static constexpr int      c_pool_chunk_index_bits = 18;   // 2^32 child indices fit, even if chunks are half used.
+
+  //! State of a node slot: claimed by set() before the node is written, published once it is.
+  enum Slot_state : uint8_t { Empty = 0, Claimed, Published };
+  struct Node_chunk
+  {
+    std::array< std::atomic<uint8_t>, 1 << c_chunk_bits > state{};
+    std::array< Node_desc_compact, 1 << c_chunk_bits >  nodes;
+  };
+  struct Pool_chunk
+  {
+    explicit Pool_chunk(size_t size) : indices(new uint32_t[size]) {}
+    std::unique_ptr< uint32_t[] > indices;
+  };
+
+  //! Chunks at stable addresses, allocated on first use. Chunk c is in segment c >> c_segment_bits.
+  template< class Chunk, int Index_bits > class Directory
+  {
+  public:
+    Directory() = default;
+    Directory(const Directory&) = delete;
+    Directory& operator=(const Directory&) = delete;
+    ~Directory();
+    Chunk*  get(size_t c) const;
+    template< class... Args >
+    Chunk*  get_or_create(size_t c, Args&&... args);
+
+  private:
+    struct Segment { std::array< std::atomic< Chunk* >, 1 << c_segment_bits > chunks{}; };
+    template< class T, class... Args >
+    static T* _get_or_create(std::atomic< T* >& slot, Args&&... args);
+    std::array< std::atomic< Segment* >, 1 << (Index_bits - c_segment_bits) > m_segments{};
+  };
+
+  uint64_t                  _reserve_children(uint32_t count);
+  uint32_t*                 _get_pool_indices(uint64_t first_child) const;
+
+  Directory< Node_chunk, 32 - c_chunk_bits >        m_nodes;
+  Directory< Pool_chunk, c_pool_chunk_index_bits >  m_pool;
+  std::atomic< uint64_t >   m_pool_cursor{ 0 }; // next free child index: pool chunk << 32 | offset
+  std::atomic< size_t >     m_size{ 0 };
+};
+
+// ------------------------------------------------------------------------------------
+//        class Node_desc_store  **** inline implementation: ****
+// ------------------------------------------------------------------------------------
+
+template< class F > inline void Node_desc_store::for_each(F&& f)
+{
+  const size_t count = size();
+  for (size_t c = 0; (c << c_chunk_bits) < count; ++c)
+  {
+    if (auto* chunk = m_nodes.get(c))
+    {
+      for (size_t i = 0; i < chunk->nodes.size(); ++i)
+      {
+        if (chunk->state[i].load(std::memory_order_acquire) == Published)
+          f(chunk->nodes[i]);
+      }
+    }
+  }
+}
+
+template< class Chunk, int Index_bits >
+inline Node_desc_store::Directory< Chunk, Index_bits >::~Directory()
+{
+  for (auto& segment : m_segments)
+  {
+    if (auto* s = segment.load(std::memory_order_acquire))
+    {
+      for (auto& chunk : s->chunks)
+        delete chunk.load(std::memory_order_acquire);
+      delete s;
+    }
+  }
+}
+
+template< class Chunk, int Index_bits >
+inline Chunk* Node_desc_store::Directory< Chunk, Index_bits >::get(size_t c) const
+{
+  I3S_ASSERT((c >> Index_bits) == 0);
+  const auto* segment = m_segments[c >> c_segment_bits].load(std::memory_order_acquire);
+  return segment ? segment->chunks[c & ((1 << c_segment_bits) - 1)].load(std::memory_order_acquire) : nullptr;
+}
+
+template< class Chunk, int Index_bits >
+template< class... Args >
+inline Chunk* Node_desc_store::Directory< Chunk, Index_bits >::get_or_create(size_t c, Args&&... args)
+{
+  I3S_ASSERT_EXT((c >> Index_bits) == 0);
+  auto* segment = _get_or_create(m_segments[c >> c_segment_bits]);
+  return _get_or_create(segment->chunks[c & ((1 << c_segment_bits) - 1)], std::forward<Args>(args)...);
+}
+
+template< class Chunk, int Index_bits >
+template< class T, class... Args >
+inline T* Node_desc_store::Directory< Chunk, Index_bits >::_get_or_create(std::atomic< T* >& slot, Args&&... args)
+{
+  auto* p = slot.load(std::memory_order_acquire);
+  if (!p)
+  {
+    auto* created = new T(std::forward<Args>(args)...);
+    if (slot.compare_exchange_strong(p, created, std::memory_order_acq_rel))
+      p = created;
+    else
+      delete created; // allocated by another thread
+  }
+  return p;
+}
+
+}
@@ -20,6 +20,7 @@ email: contracts@esri.com
 #pragma once
 
 #include "i3s_index_dom.h"
+#include "i3s_node_store.h"
 
 #include <functional>
 #include <cstdint>
@@ -45,7 +46,7 @@ public:
   *
   * |root_id| is the index of the root of the nodes tree.
   *
-  * In the input |nodes|, indexes correspond to the implicit indexing of the |nodes| vector.
+  * In the input |nodes|, indexes correspond to the implicit indexing of the |nodes| store.
   * The function modifies these indexes s.t they correspond to the indexes of nodes in pages.
   */
   virtual status_t build_pages(
@@ -53,7 +54,7 @@ public:
     const uint32_t root_id,
     const uint32_t page_size,
     const F_on_page_created& on_page,
-    std::vector<Node_desc_v17>& nodes) = 0;
+    Node_desc_store& nodes) = 0;
 };
 
 }
\ No newline at end of file
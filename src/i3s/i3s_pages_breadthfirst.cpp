@@ -30,19 +30,22 @@ status_t Page_builder_breadthfirst::build_pages(
   const uint32_t root_id,
   const uint32_t page_size,
   const F_on_page_created& on_page,
-  std::vector<Node_desc_v17>& nodes)
+  Node_desc_store& nodes)
 {
 
   // we need to re-order the tree breadth first:
   struct Item
   {
-    Item(Node_desc_v17* n) : node(n) {}
-    Node_desc_v17* node;
+    Item(Node_desc_compact* n) : node(n) {}
+    Node_desc_compact* node;
   };
 
   std::deque<Item > queue;
-  nodes[root_id].index = 0; //update the root_id : clients expect the root index to be 0
-  queue.push_back({ &nodes[root_id] }); //root is node 0
+  auto* root = nodes.get(root_id);
+  if (!root)
+    return IDS_I3S_INVALID_TREE_TOPOLOGY;
+  root->index = 0; //update the root_id : clients expect the root index to be 0
+  queue.push_back({ root }); //root is node 0
   uint32_t visit_count = 0;
   Node_page_desc_v17 current_page;
   uint32_t page_id = 0;
@@ -56,17 +59,20 @@ status_t Page_builder_breadthfirst::build_pages(
     uint32_t ch0 = visit_count + (uint32_t)queue.size();
     uint32_t node_id = (visit_count - 1) % page_size;
     //get the children:
-    for (uint32_t& ch_id : item.node->children)
+    for (uint32_t& ch_id : nodes.get_children(*item.node))
     {
       uint32_t updated_id = ch0++;
+      auto* child = nodes.get(ch_id);
+      if (!child)
+        return IDS_I3S_INVALID_TREE_TOPOLOGY;
       //rewrite childen index:
-      nodes[ch_id].index = updated_id;
-      nodes[ch_id].parent_index = page_id * page_size + node_id;
-      queue.push_back({ &nodes[ch_id] });
+      child->index = updated_id;
+      child->parent_index = page_id * page_size + node_id;
+      queue.push_back({ child });
       //update childen in parent:
       ch_id = updated_id;
     }
-    current_page.nodes[node_id] = *item.node;
+    nodes.get(*item.node, &current_page.nodes[node_id]);
     //write the page out ?
     if (node_id == page_size - 1)
     {
@@ -32,7 +32,7 @@ public:
     const uint32_t root_id,
     const uint32_t page_size,
     const F_on_page_created& on_page,
-    std::vector<Node_desc_v17>& nodes) override;
+    Node_desc_store& nodes) override;
 };
 
 }
\ No newline at end of file
@@ -41,21 +41,40 @@ status_t Page_builder_localsubtree::build_pages(
   const uint32_t root_id,
   const uint32_t page_size,
   const F_on_page_created& on_page,
-  std::vector<Node_desc_v17>& nodes)
+  Node_desc_store& nodes)
 {
-  using Node_index_t = decltype(std::declval<Node_desc_v17>().index);
+  using Node_index_t = decltype(std::declval<Node_desc_compact>().index);
 
   // Detect whether node indexes are packed.
   Node_index_t min_index = std::numeric_limits<Node_index_t>::max();
   Node_index_t max_index = std::numeric_limits<Node_index_t>::lowest();
-  for (const Node_desc_v17& node : nodes)
+  for (size_t i = 0; i < nodes.size(); ++i)
   {
-    min_index = std::min(min_index, node.index);
-    max_index = std::max(max_index, node.index);
+    const auto* node = nodes.get(static_cast<Node_index_t>(i));
+    const auto index = node ? node->index : std::numeric_limits<Node_index_t>::max();
+    min_index = std::min(min_index, index);
+    max_index = std::max(max_index, index);
   }
 
   const bool packed = (min_index == 0) && (max_index == static_cast<Node_index_t>(nodes.size() - 1));
 
+  // The partitioner dereferences the nodes reachable from the root: verify they are all set, and reached once.
+  {
+    std::vector<bool> reached(nodes.size(), false);
+    std::vector<Node_index_t> stack{ root_id };
+    while (!stack.empty())
+    {
+      const Node_index_t i = stack.back();
+      stack.pop_back();
+      const auto* node = nodes.get(i);
+      if (!node || reached[i])
+        return IDS_I3S_INVALID_TREE_TOPOLOGY;
+      reached[i] = true;
+      for (const Node_index_t ch : nodes.get_children(*node))
+        stack.push_back(ch);
+    }
+  }
+
   using Pages = utl::treepartition::Pages<Node_index_t>;
   using Children = utl::treepartition::Children<Node_index_t>;
 
@@ -65,14 +84,14 @@ status_t Page_builder_localsubtree::build_pages(
   Pages pages;
 
   auto get_children = [&](Node_index_t i) -> Children {
-    std::vector<Node_index_t>& children = nodes[i].children;
-    return { children.data(), children.data() + children.size() };
+    const auto children = nodes.get_children(*nodes.get(i));
+    return { children.begin(), children.end() };
   };
 
   auto get_priority = [&](const Node_index_t parent) -> float {
     // Clients will load the page of a node when its _parent_ node is split.
     // So we use the parent obb here.
-    return nodes[parent].obb.radius();
+    return nodes.get(parent)->obb.radius();
   };
 
   std::vector<int> page_sizes;
@@ -149,7 +168,10 @@ status_t Page_builder_localsubtree::build_pages(
 
       for (const Node_index_t old_node_index : page_nodes)
       {
-        nodes[old_node_index].index = new_index++;
+        auto* node = nodes.get(old_node_index);
+        if (!node)
+          return IDS_I3S_INVALID_TREE_TOPOLOGY;
+        node->index = new_index++;
       }
     }
     I3S_ASSERT_EXT(node_count == new_index);
@@ -157,15 +179,32 @@ status_t Page_builder_localsubtree::build_pages(
 
   // reindex parents and children
 
-  for (Node_desc_v17& node : nodes)
+  bool is_topology_valid = true;
+  nodes.for_each([&nodes, &is_topology_valid](Node_desc_compact& node)
   {
     if (node.parent_index != std::numeric_limits<decltype(node.parent_index)>::max())
-      node.parent_index = nodes[node.parent_index].index;
-    for (Node_index_t& ch : node.children)
     {
-      ch = nodes[ch].index;
+      const auto* parent = nodes.get(node.parent_index);
+      if (!parent)
+      {
+        is_topology_valid = false;
+        return;
+      }
+      node.parent_index = parent->index;
+    }
+    for (Node_index_t& ch : nodes.get_children(node))
+    {
+      const auto* child = nodes.get(ch);
+      if (!child)
+      {
+        is_topology_valid = false;
+        return;
+      }
+      ch = child->index;
     }
-  }
+  });
+  if (!is_topology_valid)
+    return IDS_I3S_INVALID_TREE_TOPOLOGY;
 
   // write pages
 
@@ -179,7 +218,10 @@ status_t Page_builder_localsubtree::build_pages(
     int j = 0;
     for (const Node_index_t old_node_index : page_nodes)
     {
-      current_page.nodes[j++] = nodes[old_node_index];
+      const auto* node = nodes.get(old_node_index);
+      if (!node)
+        return IDS_I3S_INVALID_TREE_TOPOLOGY;
+      nodes.get(*node, &current_page.nodes[j++]);
     }
 
     auto status = on_page(current_page, i);
@@ -0,0 +1,751 @@
+/*
+Copyright 2020 Esri
+
+Licensed under the Apache License, Version 2.0 (the "License"); you may not use
+this file except in compliance with the License. You may obtain a copy of
+the License at http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software distributed
+under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+CONDITIONS OF ANY KIND, either express or implied. See the License for the
+specific language governing permissions and limitations under the License.
+
+For additional information, contact:
+Environmental Systems Research Institute, Inc.
+Attn: Contracts Dept
+380 New York Street
+Redlands, California, USA 92373
+email: contracts@esri.com
+*/
+
+#include "pch.h"
+#include "i3s/i3s_pcsl_writer_impl.h"
+#include "i3s/i3s_writer_impl.h"
+#include "i3s/i3s_index_dom.h"
+#include "i3s/i3s_layer_dom.h"
+#include "utils/utl_i3s_resource_defines.h"
+#include "utils/utl_serialize_json.h"
+#include "utils/utl_mime.h"
+#include "utils/utl_string.h"
+#include <algorithm>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
+namespace i3slib
+{
+
+namespace i3s
+{
+
+using detail::Pcsl_point;
+using detail::Pcsl_point_source;
+using detail::Pcsl_node;
+using detail::Pcsl_subtree;
+
+namespace
+{
+
+template<typename... Args>
+status_t log_error_s(utl::Basic_tracker* tracker, int code, Args&&... args)
+{
+  utl::Basic_tracker::log(tracker, utl::Log_level::Critical, code, std::forward<Args>(args)...);
+  return status_t(code);
+}
+
+// Points are binned in the cells of this level of the quadtree ( i.e. a 16x16 grid over the layer extent ):
+constexpr int c_bin_level = 4;
+// Deeper, points are coincident ( or nearly so ) and are split in arbitrary groups:
+constexpr int c_max_depth = 24;
+// Always 64 for PCSL:
+constexpr uint32_t c_nodes_per_page = 64;
+// Points read at once when splitting temporary files:
+constexpr size_t c_chunk_size = 1 << 16;
+
+const std::string c_metadata_json_path{ "metadata" };
+
+//! Quadrant q of box ( bit 0: right half, bit 1: top half ). Z-range is kept.
+utl::Boxd get_quadrant(const utl::Boxd& box, int q)
+{
+  const auto c = box.center();
+  return utl::Boxd(
+    (q & 1) ? c.x : box.left(), (q & 2) ? c.y : box.bottom(),
+    (q & 1) ? box.right() : c.x, (q & 2) ? box.top() : c.y,
+    box.front(), box.back());
+}
+
+int get_quadrant_index(const utl::Vec3d& center, const utl::Vec3d& p)
+{
+  return (p.y >= center.y ? 2 : 0) + (p.x >= center.x ? 1 : 0);
+}
+
+//! Density of the points over the footprint of their OBB ( its two largest extents ).
+double get_point_density(const utl::Obb_abs& obb, size_t count)
+{
+  std::array<double, 3> e{ obb.extents.x, obb.extents.y, obb.extents.z };
+  std::sort(e.begin(), e.end());
+  const double area = 4.0 * e[1] * e[2];
+  return area > 0.0 ? static_cast<double>(count) / area : 0.0;
+}
+
+//! Keeps one point per voxel. Voxels are cubes in the cartesian space of the layer, so that horizontal and vertical
+//! extents are in the same unit ( e.g. degrees and meters of a GCS layer ). The voxel size starts at the mean spacing of
+//! max_count points over the footprint and grows until at most max_count points remain.
+std::vector< Pcsl_point > thin_points(const Spatial_reference_xform& xform, const std::vector< Pcsl_point >& points, size_t max_count, std::vector< utl::Vec3d >& scratch)
+{
+  if (points.size() <= max_count)
+    return points;
+
+  scratch.resize(points.size());
+  for (size_t i = 0; i < points.size(); ++i)
+    scratch[i] = points[i].xyz;
+  [[maybe_unused]] bool ret = to_dst_cartesian(xform, scratch.data(), static_cast<int>(scratch.size()));
+  I3S_ASSERT(ret);
+
+  utl::Boxd box;
+  for (const auto& p : scratch)
+    box.expand(p);
+
+  // the footprint is spanned by the two largest extents ( the box isn't aligned with the ground in ECEF ):
+  std::array<double, 3> e{ box.width(), box.height(), box.depth() };
+  std::sort(e.begin(), e.end());
+  double voxel_size = std::max(std::sqrt(e[1] * e[2] / max_count), e[2] / max_count);
+  if (!(voxel_size > 0.0))
+    return std::vector< Pcsl_point >(points.begin(), points.begin() + max_count); // coincident points
+
+  // e[2] / voxel_size <= max_count, so that voxel coordinates fit in 21 bits ( for max_count < 2^21 ):
+  constexpr uint64_t c_mask = (1ull << 21) - 1;
+  std::unordered_set< uint64_t > voxels(points.size());
+  std::vector< Pcsl_point > out;
+  out.reserve(max_count);
+  while (true)
+  {
+    voxels.clear();
+    out.clear();
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+      const auto& p = scratch[i];
+      const auto ix = static_cast<uint64_t>((p.x - box.left()) / voxel_size) & c_mask;
+      const auto iy = static_cast<uint64_t>((p.y - box.bottom()) / voxel_size) & c_mask;
+      const auto iz = static_cast<uint64_t>((p.z - box.front()) / voxel_size) & c_mask;
+      if (voxels.insert(ix | (iy << 21) | (iz << 42)).second)
+        out.push_back(points[i]);
+    }
+    if (out.size() <= max_count)
+      return out;
+    voxel_size *= 1.25;
+  }
+}
+
+bool write_points(const std::filesystem::path& path, const Pcsl_point* points, size_t count)
+{
+  std::ofstream out(path, std::ios::binary | std::ios::app);
+  out.write(reinterpret_cast<const char*>(points), count * sizeof(Pcsl_point));
+  return out.good();
+}
+
+status_t append_to_slpk(utl::Basic_tracker* trk, utl::Slpk_writer& slpk, const std::string& path, const utl::Raw_buffer_view& buf, utl::Mime_encoding encoding)
+{
+  if (!slpk.append_file(path, buf.data(), buf.size(), utl::Mime_type::Binary, encoding))
+    return log_error_s(trk, IDS_I3S_IO_WRITE_FAILED, "SLPK://" + path);
+  return IDS_I3S_OK;
+}
+
+template< class T > status_t save_json(utl::Basic_tracker* trk, utl::Slpk_writer& slpk, const T& obj, const std::string& path, Gzip_context& gzip)
+{
+  auto json_content = utl::to_json(obj);
+  if (json_content.empty())
+    return log_error_s(trk, IDS_I3S_INTERNAL_ERROR, std::string("Empty JSON"));
+  if (!gzip.compress_inplace(&json_content))
+    return log_error_s(trk, IDS_I3S_COMPRESSION_ERROR, path, std::string("GZIP"));
+  if (!slpk.append_file(path, json_content.data(), static_cast<int>(json_content.size()), utl::Mime_type::Json, utl::Mime_encoding::Gzip))
+    return log_error_s(trk, IDS_I3S_IO_WRITE_FAILED, "SLPK://" + path);
+  return IDS_I3S_OK;
+}
+
+Attribute_storage_info_desc create_pcsl_attrib_info(Pcsl_attribute_buffer_type type, Attribute_storage_info_encoding encoding, Type value_type, int values_per_element)
+{
+  Attribute_storage_info_desc desc;
+  desc.key = std::to_string(static_cast<int>(type));
+  desc.name = to_string(type);
+  desc.ordering = { Attrib_ordering::Attribute_values };
+  desc.attribute_values.value_type = value_type;
+  desc.attribute_values.values_per_element = values_per_element;
+  desc.encoding = encoding;
+  return desc;
+}
+
+Field_desc create_pcsl_field(Pcsl_attribute_buffer_type type, Esri_field_type field_type)
+{
+  Field_desc desc;
+  desc.name = to_string(type);
+  desc.alias = desc.name;
+  desc.type = field_type;
+  return desc;
+}
+
+} // namespace
+
+
+Pcsl_writer_impl::Pcsl_writer_impl(utl::Slpk_writer::Ptr slpk, Writer_context::Ptr ctx, const Pcsl_writer_params& params, utl::Scoped_folder temp_folder)
+  : m_ctx(ctx)
+  , m_slpk(slpk)
+  , m_params(params)
+  , m_temp_folder(std::move(temp_folder))
+  , m_gzip(ctx->gzip_option)
+{
+  if (m_params.max_points_per_node <= 0)
+    m_params.max_points_per_node = Pcsl_writer_params().max_points_per_node;
+  if (m_params.thread_count <= 0)
+    m_params.thread_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+  const int bin_count = 1 << (2 * c_bin_level);
+  m_bins.resize(bin_count);
+  for (auto& bin : m_bins)
+    bin = std::make_unique<Bin>();
+
+  // Half of the budget for the bins, half for the build tasks:
+  const size_t max_points = m_params.memory_budget / sizeof(Pcsl_point) / 2;
+  m_max_bin_points = std::max(max_points / bin_count, size_t(1024));
+  m_max_task_points = std::max(max_points / m_params.thread_count, 4 * static_cast<size_t>(m_params.max_points_per_node));
+}
+
+void Pcsl_writer_impl::set_layer_meta(const Layer_meta& meta)
+{
+  m_layer_meta = meta;
+  m_layer_meta.type = Layer_type::Point_cloud;
+  m_xform = m_ctx->sr_helper_factory(meta.sr, nullptr);
+}
+
+int Pcsl_writer_impl::_get_bin_index(const utl::Vec3d& p) const
+{
+  constexpr int n = 1 << c_bin_level;
+  auto to_cell = [](double v, double lo, double hi)
+  {
+    const int i = hi > lo ? static_cast<int>((v - lo) / (hi - lo) * n) : 0;
+    return std::clamp(i, 0, n - 1);
+  };
+  const auto& e = m_params.extent;
+  return to_cell(p.y, e.bottom(), e.top()) * n + to_cell(p.x, e.left(), e.right());
+}
+
+utl::Boxd Pcsl_writer_impl::_get_cell_box(int level, int ix, int iy) const
+{
+  const auto& e = m_params.extent;
+  const double w = e.width() / (1 << level);
+  const double h = e.height() / (1 << level);
+  return utl::Boxd(e.left() + ix * w, e.bottom() + iy * h, e.left() + (ix + 1) * w, e.bottom() + (iy + 1) * h, e.front(), e.back());
+}
+
+std::filesystem::path Pcsl_writer_impl::_create_temp_file_path()
+{
+  return m_temp_folder.path() / (std::to_string(m_temp_file_count++) + ".bin");
+}
+
+status_t Pcsl_writer_impl::add_points(const Simple_raw_point_cloud& src)
+{
+  auto trk = m_ctx->tracker();
+  if (src.count <= 0)
+    return IDS_I3S_OK;
+  if (!src.abs_xyz || (m_params.has_rgb && !src.rgb) || (m_params.has_intensity && !src.intensity))
+    return log_error_s(trk, IDS_I3S_INTERNAL_ERROR, std::string("missing point attributes"));
+
+  std::vector< std::vector< Pcsl_point > > binned(m_bins.size());
+  for (int i = 0; i < src.count; ++i)
+  {
+    Pcsl_point p{ src.abs_xyz[i], src.rgb ? src.rgb[i] : utl::Rgb8(0, 0, 0), src.intensity ? src.intensity[i] : uint16_t(0) };
+    binned[_get_bin_index(p.xyz)].push_back(p);
+  }
+
+  for (size_t b = 0; b < binned.size(); ++b)
+  {
+    if (binned[b].empty())
+      continue;
+    auto& bin = *m_bins[b];
+    std::lock_guard<std::mutex> lk(bin.mutex);
+    for (const auto& p : binned[b])
+      bin.envelope.expand(p.xyz);
+    bin.src.points.insert(bin.src.points.end(), binned[b].begin(), binned[b].end());
+    bin.src.count += binned[b].size();
+    if (bin.src.points.size() > m_max_bin_points)
+    {
+      if (auto status = _spill(bin.src); status != IDS_I3S_OK)
+        return status;
+    }
+  }
+  return IDS_I3S_OK;
+}
+
+status_t Pcsl_writer_impl::_spill(Pcsl_point_source& src)
+{
+  if (src.points.empty())
+    return IDS_I3S_OK;
+  if (src.files.empty())
+    src.files.push_back(_create_temp_file_path());
+  if (!write_points(src.files.back(), src.points.data(), src.points.size()))
+    return log_error_s(m_ctx->tracker(), IDS_I3S_IO_WRITE_FAILED, src.files.back());
+  src.points.clear();
+  src.points.shrink_to_fit();
+  return IDS_I3S_OK;
+}
+
+status_t Pcsl_writer_impl::_load(Pcsl_point_source& src)
+{
+  std::vector< Pcsl_point > points;
+  points.reserve(src.count);
+  for (const auto& path : src.files)
+  {
+    std::error_code ec;
+    const auto count = std::filesystem::file_size(path, ec) / sizeof(Pcsl_point);
+    std::ifstream in(path, std::ios::binary);
+    const auto offset = points.size();
+    points.resize(offset + count);
+    if (ec || !in.read(reinterpret_cast<char*>(points.data() + offset), count * sizeof(Pcsl_point)))
+      return log_error_s(m_ctx->tracker(), IDS_I3S_IO_READ_FAILED, path);
+    in.close();
+    [[maybe_unused]] const bool is_removed = utl::remove_file(path); // the temporary folder is removed anyway
+  }
+  src.files.clear();
+  points.insert(points.end(), src.points.begin(), src.points.end());
+  src.points = std::move(points);
+  I3S_ASSERT(src.points.size() == src.count);
+  return IDS_I3S_OK;
+}
+
+status_t Pcsl_writer_impl::_split(Pcsl_point_source& src, const utl::Boxd& box, Pcsl_point_source* quadrants)
+{
+  const auto center = box.center();
+  std::vector< Pcsl_point > buffers[4];
+  auto flush = [this, quadrants, &buffers](int q) -> status_t
+  {
+    auto& dst = quadrants[q];
+    dst.count += buffers[q].size();
+    dst.points.swap(buffers[q]);
+    auto status = _spill(dst);
+    buffers[q].swap(dst.points);
+    buffers[q].clear();
+    return status;
+  };
+  auto distribute = [&](const Pcsl_point* begin, const Pcsl_point* end) -> status_t
+  {
+    for (auto p = begin; p != end; ++p)
+    {
+      const int q = get_quadrant_index(center, p->xyz);
+      buffers[q].push_back(*p);
+      if (buffers[q].size() >= c_chunk_size)
+      {
+        if (auto status = flush(q); status != IDS_I3S_OK)
+          return status;
+      }
+    }
+    return IDS_I3S_OK;
+  };
+
+  std::vector< Pcsl_point > chunk(c_chunk_size);
+  for (const auto& path : src.files)
+  {
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+      return log_error_s(m_ctx->tracker(), IDS_I3S_IO_READ_FAILED, path);
+    while (in)
+    {
+      in.read(reinterpret_cast<char*>(chunk.data()), chunk.size() * sizeof(Pcsl_point));
+      const auto count = static_cast<size_t>(in.gcount()) / sizeof(Pcsl_point);
+      if (auto status = distribute(chunk.data(), chunk.data() + count); status != IDS_I3S_OK)
+        return status;
+    }
+    in.close();
+    [[maybe_unused]] const bool is_removed = utl::remove_file(path); // the temporary folder is removed anyway
+  }
+  src.files.clear();
+  if (auto status = distribute(src.points.data(), src.points.data() + src.points.size()); status != IDS_I3S_OK)
+    return status;
+  src.points.clear();
+  src.points.shrink_to_fit();
+
+  for (int q = 0; q < 4; ++q)
+  {
+    if (auto status = flush(q); status != IDS_I3S_OK)
+      return status;
+  }
+  return IDS_I3S_OK;
+}
+
+status_t Pcsl_writer_impl::_build_subtree(Pcsl_point_source& src, const utl::Boxd& box, int depth, Worker& w, Pcsl_subtree* out)
+{
+  if (src.count == 0)
+    return IDS_I3S_OK;
+
+  if (src.count <= m_max_task_points || depth >= c_max_depth)
+  {
+    if (auto status = _load(src); status != IDS_I3S_OK)
+      return status;
+    auto status = _build_subtree(src.points.data(), src.points.data() + src.points.size(), box, depth, w, out);
+    src.points.clear();
+    src.points.shrink_to_fit();
+    return status;
+  }
+
+  // Too many points to be held in memory: split them in the temporary files of the quadrants:
+  Pcsl_point_source quadrants[4];
+  if (auto status = _split(src, box, quadrants); status != IDS_I3S_OK)
+    return status;
+
+  std::vector< Pcsl_subtree > children;
+  for (int q = 0; q < 4; ++q)
+  {
+    Pcsl_subtree child;
+    if (auto status = _build_subtree(quadrants[q], get_quadrant(box, q), depth + 1, w, &child); status != IDS_I3S_OK)
+      return status;
+    if (child.node != Pcsl_subtree::c_no_node)
+      children.push_back(std::move(child));
+  }
+  return _create_parent(children, w, out);
+}
+
+status_t Pcsl_writer_impl::_build_subtree(Pcsl_point* begin, Pcsl_point* end, const utl::Boxd& box, int depth, Worker& w, Pcsl_subtree* out)
+{
+  const auto max_count = static_cast<size_t>(m_params.max_points_per_node);
+  const auto count = static_cast<size_t>(end - begin);
+  if (count == 0)
+    return IDS_I3S_OK;
+  if (count <= max_count)
+    return _create_leaf(begin, end, w, out);
+
+  std::vector< Pcsl_subtree > children;
+  if (depth >= c_max_depth)
+  {
+    // coincident points:
+    for (auto it = begin; it < end; it += std::min(max_count, static_cast<size_t>(end - it)))
+    {
+      Pcsl_subtree child;
+      if (auto status = _create_leaf(it, it + std::min(max_count, static_cast<size_t>(end - it)), w, &child); status != IDS_I3S_OK)
+        return status;
+      children.push_back(std::move(child));
+    }
+  }
+  else
+  {
+    // in-place partition in quadrants:
+    const auto c = box.center();
+    auto mid_y = std::partition(begin, end, [&c](const Pcsl_point& p) { return p.xyz.y < c.y; });
+    auto mid_x0 = std::partition(begin, mid_y, [&c](const Pcsl_point& p) { return p.xyz.x < c.x; });
+    auto mid_x1 = std::partition(mid_y, end, [&c](const Pcsl_point& p) { return p.xyz.x < c.x; });
+    Pcsl_point* ranges[5] = { begin, mid_x0, mid_y, mid_x1, end };
+    for (int q = 0; q < 4; ++q)
+    {
+      Pcsl_subtree child;
+      if (auto status = _build_subtree(ranges[q], ranges[q + 1], get_quadrant(box, q), depth + 1, w, &child); status != IDS_I3S_OK)
+        return status;
+      if (child.node != Pcsl_subtree::c_no_node)
+        children.push_back(std::move(child));
+    }
+  }
+  return _create_parent(children, w, out);
+}
+
+status_t Pcsl_writer_impl::_create_leaf(const Pcsl_point* begin, const Pcsl_point* end, Worker& w, Pcsl_subtree* out)
+{
+  out->points.assign(begin, end);
+
+  Pcsl_node node;
+  w.scratch.resize(out->points.size());
+  for (size_t i = 0; i < out->points.size(); ++i)
+    w.scratch[i] = out->points[i].xyz;
+  utl::Vec4d mbs;
+  compute_obb(*m_xform, w.scratch, w.hull, node.obb, mbs);
+
+  return _write_node(out->points, node, &out->node);
+}
+
+status_t Pcsl_writer_impl::_create_parent(std::vector< Pcsl_subtree >& children, Worker& w, Pcsl_subtree* out)
+{
+  if (children.empty())
+    return IDS_I3S_OK;
+  if (children.size() == 1)
+  {
+    // no need for an intermediate node:
+    *out = std::move(children.front());
+    return IDS_I3S_OK;
+  }
+
+  std::vector< Pcsl_point > points;
+  Pcsl_node node;
+  std::vector< utl::Obb_abs > child_obbs;
+  {
+    std::lock_guard<std::mutex> lk(m_nodes_mutex);
+    for (const auto& child : children)
+    {
+      child_obbs.push_back(m_nodes[child.node].obb);
+      node.children.push_back(child.node);
+    }
+  }
+  for (auto& child : children)
+  {
+    points.insert(points.end(), child.points.begin(), child.points.end());
+    child.points = std::vector< Pcsl_point >();
+  }
+  out->points = thin_points(*m_xform, points, static_cast<size_t>(m_params.max_points_per_node), w.scratch);
+
+  utl::Vec4d mbs;
+  compute_obb(*m_xform, child_obbs, w.hull, w.scratch, node.obb, mbs);
+
+  return _write_node(out->points, node, &out->node);
+}
+
+status_t Pcsl_writer_impl::_write_node(const std::vector< Pcsl_point >& points, Pcsl_node& node, uint32_t* resource_id)
+{
+  auto trk = m_ctx->tracker();
+  const int count = static_cast<int>(points.size());
+  node.point_count = static_cast<uint32_t>(count);
+  node.lod_threshold = get_point_density(node.obb, points.size());
+  {
+    std::lock_guard<std::mutex> lk(m_nodes_mutex);
+    *resource_id = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(node);
+  }
+  const std::string node_path = "nodes/" + std::to_string(*resource_id);
+
+  // --- geometry ( elevation is embedded ):
+  std::vector< utl::Vec3d > xyz(count);
+  for (int i = 0; i < count; ++i)
+    xyz[i] = points[i].xyz;
+  utl::Raw_buffer_view buffer;
+  std::vector< uint32_t > order;
+  const std::string geometry_path = node_path + "/geometries/0";
+  if (!m_ctx->encode_to_lepcc_xyz(xyz.data(), count, m_params.max_xyz_error, &buffer, &order))
+    return log_error_s(trk, IDS_I3S_COMPRESSION_ERROR, geometry_path, std::string("LEPCC"));
+  if (auto status = append_to_slpk(trk, *m_slpk, geometry_path, buffer, utl::Mime_encoding::Lepcc_xyz); status != IDS_I3S_OK)
+    return status;
+
+  // --- attributes, in the order of the encoded points:
+  if (m_params.has_rgb)
+  {
+    std::vector< utl::Rgb8 > rgb(count);
+    for (int i = 0; i < count; ++i)
+      rgb[i] = points[order[i]].rgb;
+    const auto path = node_path + "/attributes/" + std::to_string(static_cast<int>(Pcsl_attribute_buffer_type::Color_rgb));
+    if (!m_ctx->encode_to_lepcc_rgb(rgb.data(), count, &buffer))
+      return log_error_s(trk, IDS_I3S_COMPRESSION_ERROR, path, std::string("LEPCC"));
+    if (auto status = append_to_slpk(trk, *m_slpk, path, buffer, utl::Mime_encoding::Lepcc_rgb); status != IDS_I3S_OK)
+      return status;
+  }
+  if (m_params.has_intensity)
+  {
+    std::vector< uint16_t > intensity(count);
+    for (int i = 0; i < count; ++i)
+      intensity[i] = points[order[i]].intensity;
+    const auto path = node_path + "/attributes/" + std::to_string(static_cast<int>(Pcsl_attribute_buffer_type::Intensity));
+    if (!m_ctx->encode_to_lepcc_intensity(intensity.data(), count, &buffer))
+      return log_error_s(trk, IDS_I3S_COMPRESSION_ERROR, path, std::string("LEPCC"));
+    if (auto status = append_to_slpk(trk, *m_slpk, path, buffer, utl::Mime_encoding::Lepcc_int); status != IDS_I3S_OK)
+      return status;
+  }
+  return IDS_I3S_OK;
+}
+
+status_t Pcsl_writer_impl::save()
+{
+  auto trk = m_ctx->tracker();
+  if (!m_xform)
+    return log_error_s(trk, IDS_I3S_INTERNAL_ERROR, std::string("set_layer_meta() must be called before save()"));
+  if (!m_ctx->encode_to_lepcc_xyz || (m_params.has_rgb && !m_ctx->encode_to_lepcc_rgb) || (m_params.has_intensity && !m_ctx->encode_to_lepcc_intensity))
+    return log_error_s(trk, IDS_I3S_COMPRESSION_ERROR, std::string("point cloud"), std::string("LEPCC"));
+
+  utl::Boxd envelope;
+  for (const auto& bin : m_bins)
+  {
+    if (!bin->envelope.is_empty())
+      envelope.expand(bin->envelope);
+  }
+  if (envelope.is_empty())
+    return log_error_s(trk, IDS_I3S_EMPTY_FULL_EXTENT);
+
+  // --- subtrees of the bins, in parallel:
+  constexpr int n = 1 << c_bin_level;
+  std::vector< Pcsl_subtree > cells(m_bins.size());
+  std::atomic<int> next_bin{ 0 };
+  std::atomic<bool> is_canceled{ false };
+  auto build_bins = [&]() -> status_t
+  {
+    Worker w;
+    for (int b = next_bin++; b < static_cast<int>(m_bins.size()) && !is_canceled; b = next_bin++)
+    {
+      auto status = _build_subtree(m_bins[b]->src, _get_cell_box(c_bin_level, b % n, b / n), c_bin_level, w, &cells[b]);
+      if (status != IDS_I3S_OK)
+      {
+        is_canceled = true;
+        return status;
+      }
+    }
+    return IDS_I3S_OK;
+  };
+  std::vector< std::future< status_t > > tasks;
+  for (int i = 0; i < m_params.thread_count; ++i)
+    tasks.push_back(std::async(std::launch::async, build_bins));
+  status_t status = IDS_I3S_OK;
+  for (auto& task : tasks)
+  {
+    auto task_status = task.get();
+    if (task_status != IDS_I3S_OK)
+      status = task_status;
+  }
+  if (status != IDS_I3S_OK)
+    return status;
+
+  // --- top of the quadtree:
+  Worker w;
+  for (int level = c_bin_level; level > 0; --level)
+  {
+    const int size = 1 << level;
+    const int half = size / 2;
+    std::vector< Pcsl_subtree > parents(half * half);
+    for (int iy = 0; iy < half; ++iy)
+    {
+      for (int ix = 0; ix < half; ++ix)
+      {
+        std::vector< Pcsl_subtree > children;
+        for (int q = 0; q < 4; ++q)
+        {
+          auto& child = cells[(2 * iy + (q >> 1)) * size + 2 * ix + (q & 1)];
+          if (child.node != Pcsl_subtree::c_no_node)
+            children.push_back(std::move(child));
+        }
+        if (status = _create_parent(children, w, &parents[iy * half + ix]); status != IDS_I3S_OK)
+          return status;
+      }
+    }
+    cells.swap(parents);
+  }
+  I3S_ASSERT(cells.size() == 1 && cells.front().node != Pcsl_subtree::c_no_node);
+
+  if (status = _save_node_pages(cells.front().node); status != IDS_I3S_OK)
+    return status;
+  if (status = _save_layer_desc(envelope); status != IDS_I3S_OK)
+    return status;
+
+  const auto metadata_json =
+    "{\n  \"I3SVersion\": \"2.0\",\n  \"nodeCount\": " + std::to_string(m_nodes.size()) + "\n}";
+  if (!m_slpk->append_file(c_metadata_json_path, metadata_json.data(), static_cast<int>(metadata_json.size()), utl::Mime_type::Json))
+    return log_error_s(trk, IDS_I3S_IO_WRITE_FAILED, "SLPK://" + c_metadata_json_path);
+
+  if (m_ctx->finalization_mode == Writer_finalization_mode::Finalize_output_stream && !m_slpk->finalize())
+    return log_error_s(trk, IDS_I3S_IO_WRITE_FAILED, std::string("output SLPK"));
+  return IDS_I3S_OK;
+}
+
+status_t Pcsl_writer_impl::_save_node_pages(uint32_t root)
+{
+  // Breadth-first, so that the children of a node are contiguous:
+  std::vector< uint32_t > order{ root };
+  order.reserve(m_nodes.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    order.insert(order.end(), m_nodes[order[i]].children.begin(), m_nodes[order[i]].children.end());
+  I3S_ASSERT(order.size() == m_nodes.size());
+
+  std::vector< uint32_t > page_index(m_nodes.size());
+  for (size_t i = 0; i < order.size(); ++i)
+    page_index[order[i]] = static_cast<uint32_t>(i);
+
+  Pcsl_node_page_desc page;
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    const auto& node = m_nodes[order[i]];
+    Pcsl_node_desc desc;
+    desc.resource_id = order[i];
+    desc.child_count = static_cast<uint32_t>(node.children.size());
+    desc.first_child = node.children.empty() ? 0 : page_index[node.children.front()];
+    desc.vertex_count = node.point_count;
+    desc.obb = node.obb;
+    desc.lod_threshold = node.lod_threshold;
+    page.nodes.push_back(desc);
+
+    if (page.nodes.size() == c_nodes_per_page || i + 1 == order.size())
+    {
+      const auto path = "nodepages/" + std::to_string(i / c_nodes_per_page);
+      if (auto status = save_json(m_ctx->tracker(), *m_slpk, page, path, m_gzip); status != IDS_I3S_OK)
+        return status;
+      page.nodes.clear();
+    }
+  }
+  return IDS_I3S_OK;
+}
+
+status_t Pcsl_writer_impl::_save_layer_desc(const utl::Boxd& envelope)
+{
+  Pcsl_layer_desc desc;
+  desc.name = m_layer_meta.name;
+  desc.alias = m_layer_meta.alias.size() ? m_layer_meta.alias : m_layer_meta.name;
+  desc.description = m_layer_meta.desc;
+  desc.copyright = m_layer_meta.copyright;
+  if (m_layer_meta.capabilities.size())
+    desc.capabilities = m_layer_meta.capabilities;
+  desc.drawing_info.raw = m_layer_meta.drawing_info;
+  desc.elevation_info.raw = m_layer_meta.elevation_info;
+  desc.spatial_ref = (const Spatial_reference_desc&)m_layer_meta.sr;
+  static_assert(sizeof(Height_model_info_desc) == sizeof(m_layer_meta.height_model_info), "unexpected size");
+  desc.height_model_info = reinterpret_cast<const Height_model_info_desc&>(m_layer_meta.height_model_info);
+
+  desc.full_extent.spatial_reference = desc.spatial_ref;
+  desc.full_extent.xmin = envelope.left();
+  desc.full_extent.xmax = envelope.right();
+  desc.full_extent.ymin = envelope.bottom();
+  desc.full_extent.ymax = envelope.top();
+  desc.full_extent.zmin = envelope.front();
+  desc.full_extent.zmax = envelope.back();
+
+  desc.store.id = "0";
+  desc.store.extent = { envelope.left(), envelope.bottom(), envelope.right(), envelope.top() };
+  desc.store.index.nodes_per_page = c_nodes_per_page;
+
+  desc.attribute_storage_info.push_back(create_pcsl_attrib_info(Pcsl_attribute_buffer_type::Elevation, Attribute_storage_info_encoding::Embedded_elevation, Type::Float64, 1));
+  desc.fields.push_back(create_pcsl_field(Pcsl_attribute_buffer_type::Elevation, Esri_field_type::Double));
+  if (m_params.has_intensity)
+  {
+    desc.attribute_storage_info.push_back(create_pcsl_attrib_info(Pcsl_attribute_buffer_type::Intensity, Attribute_storage_info_encoding::Lepcc_intensity, Type::UInt16, 1));
+    desc.fields.push_back(create_pcsl_field(Pcsl_attribute_buffer_type::Intensity, Esri_field_type::Integer));
+  }
+  if (m_params.has_rgb)
+  {
+    desc.attribute_storage_info.push_back(create_pcsl_attrib_info(Pcsl_attribute_buffer_type::Color_rgb, Attribute_storage_info_encoding::Lepcc_rgb, Type::UInt8, 3));
+    desc.fields.push_back(create_pcsl_field(Pcsl_attribute_buffer_type::Color_rgb, Esri_field_type::String));
+  }
+
+  return save_json(m_ctx->tracker(), *m_slpk, desc, "3dSceneLayer", m_gzip);
+}
+
+Pcsl_writer* create_pcsl_builder(Writer_context::Ptr ctx, const std::filesystem::path& path, const Pcsl_writer_params& params)
+{
+  auto trk = ctx->tracker();
+  if (params.extent.is_empty())
+  {
+    std::ostringstream extent;
+    extent << params.extent;
+    utl::log_error(trk, IDS_I3S_INVALID_EXTENT, extent.str());
+    return nullptr;
+  }
+
+  auto temp_folder = utl::create_temporary_folder("i3s_pcsl_");
+  if (temp_folder.path().empty())
+  {
+    utl::log_error(trk, IDS_I3S_IO_OPEN_FAILED, std::string("temporary folder"));
+    return nullptr;
+  }
+
+  utl::Slpk_writer::Ptr slpk_writer(utl::create_slpk_writer(utl::to_string(path)));
+  const auto flags = ctx->write_behind_output ?
+    utl::Slpk_writer::Create_flag::Write_behind :
+    utl::Slpk_writer::Create_flag::Overwrite_if_exists_and_cancel_in_destructor;
+  if (slpk_writer)
+    slpk_writer->set_write_behind_params(get_write_behind_params(*ctx));
+  if (slpk_writer && slpk_writer->create_archive(path, flags))
+    return new Pcsl_writer_impl(slpk_writer, ctx, params, std::move(temp_folder));
+
+  utl::log_error(trk, IDS_I3S_IO_OPEN_FAILED, path);
+  return nullptr;
+}
+
+} // namespace i3s
+
+} // namespace i3slib
@@ -0,0 +1,135 @@
+/*
+Copyright 2020 Esri
+
+Licensed under the Apache License, Version 2.0 (the "License"); you may not use
+this file except in compliance with the License. You may obtain a copy of
+the License at http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software distributed
+under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+CONDITIONS OF ANY KIND, either express or implied. See the License for the
+specific language governing permissions and limitations under the License.
+
+For additional information, contact:
+Environmental Systems Research Institute, Inc.
+Attn: Contracts Dept
+380 New York Street
+Redlands, California, USA 92373
+email: contracts@esri.com
+*/
+
+#pragma once
+#include "i3s/i3s_writer.h"
+#include "utils/utl_slpk_writer_api.h"
+#include "utils/utl_obb.h"
+#include "utils/utl_gzip_context.h"
+#include "utils/utl_prohull.h"
+#include "utils/utl_box.h"
+#include "utils/utl_fs.h"
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <memory>
+#include <vector>
+
+namespace i3slib
+{
+
+namespace i3s
+{
+
+namespace detail
+{
+
+//! Point record of the bins and of the temporary files.
+struct Pcsl_point
+{
+  utl::Vec3d  xyz;
+  utl::Rgb8   rgb;
+  uint16_t    intensity;
+};
+
+//! Points of a quadtree cell: a list of temporary files and the points still in memory.
+struct Pcsl_point_source
+{
+  std::vector< std::filesystem::path > files;
+  std::vector< Pcsl_point > points;
+  uint64_t                  count = 0; // total ( files and memory )
+};
+
+//! Node of the LOD tree. Identified by its resource id ( its index in Pcsl_writer_impl::m_nodes ).
+struct Pcsl_node
+{
+  uint32_t                point_count = 0;
+  utl::Obb_abs            obb;
+  double                  lod_threshold = 0.0;
+  std::vector< uint32_t > children;
+};
+
+//! Root of a subtree and its points ( at most Pcsl_writer_params::max_points_per_node ), subsampled by the parent.
+struct Pcsl_subtree
+{
+  static constexpr uint32_t c_no_node = std::numeric_limits<uint32_t>::max();
+  uint32_t                  node = c_no_node;
+  std::vector< Pcsl_point > points;
+};
+
+}
+
+class Pcsl_writer_impl : public Pcsl_writer
+{
+public:
+  DECL_PTR(Pcsl_writer_impl);
+  Pcsl_writer_impl(utl::Slpk_writer::Ptr slpk, Writer_context::Ptr ctx, const Pcsl_writer_params& params, utl::Scoped_folder temp_folder);
+
+  // --- Pcsl_writer:
+  virtual void       set_layer_meta(const Layer_meta& meta) override;
+  virtual status_t   add_points(const Simple_raw_point_cloud& src) override;
+  virtual status_t   save() override;
+
+private:
+  //! Per build thread.
+  struct Worker
+  {
+    utl::Pro_hull             hull{ utl::Pro_set::get_default() };
+    std::vector<utl::Vec3d>   scratch;
+  };
+  //! Points of a cell of the binning grid ( level c_bin_level of the quadtree ).
+  struct Bin
+  {
+    std::mutex                mutex;
+    detail::Pcsl_point_source src;
+    utl::Boxd                 envelope;
+  };
+
+  int                   _get_bin_index(const utl::Vec3d& p) const;
+  utl::Boxd             _get_cell_box(int level, int ix, int iy) const;
+  std::filesystem::path _create_temp_file_path();
+  status_t              _spill(detail::Pcsl_point_source& src);
+  status_t              _load(detail::Pcsl_point_source& src);
+  status_t              _split(detail::Pcsl_point_source& src, const utl::Boxd& box, detail::Pcsl_point_source* quadrants);
+  status_t              _build_subtree(detail::Pcsl_point_source& src, const utl::Boxd& box, int depth, Worker& w, detail::Pcsl_subtree* out);
+  status_t              _build_subtree(detail::Pcsl_point* begin, detail::Pcsl_point* end, const utl::Boxd& box, int depth, Worker& w, detail::Pcsl_subtree* out);
+  status_t              _create_leaf(const detail::Pcsl_point* begin, const detail::Pcsl_point* end, Worker& w, detail::Pcsl_subtree* out);
+  status_t              _create_parent(std::vector< detail::Pcsl_subtree >& children, Worker& w, detail::Pcsl_subtree* out);
+  status_t              _write_node(const std::vector< detail::Pcsl_point >& points, detail::Pcsl_node& node, uint32_t* resource_id);
+  status_t              _save_node_pages(uint32_t root);
+  status_t              _save_layer_desc(const utl::Boxd& envelope);
+
+  Writer_context::Ptr       m_ctx;
+  utl::Slpk_writer::Ptr     m_slpk;
+  Pcsl_writer_params        m_params;
+  utl::Scoped_folder        m_temp_folder;
+  Layer_meta                m_layer_meta;
+  Spatial_reference_xform::cptr m_xform;
+  Gzip_context              m_gzip;
+  std::vector< std::unique_ptr< Bin > > m_bins;
+  size_t                    m_max_bin_points;   // in memory, per bin
+  size_t                    m_max_task_points;  // in memory, per build thread
+  std::atomic<uint64_t>     m_temp_file_count{ 0 };
+  std::mutex                m_nodes_mutex;      // synchronizes accesses to m_nodes
+  std::vector< detail::Pcsl_node > m_nodes;     // implicitly indexed by resource id
+};
+
+} // namespace i3s
+
+} // namespace i3slib
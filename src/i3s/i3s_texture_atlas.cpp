@@ -0,0 +1,350 @@
+/*
+Copyright 2020 Esri
+
+Licensed under the Apache License, Version 2.0 (the "License"); you may not use
+this file except in compliance with the License. You may obtain a copy of
+the License at http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software distributed
+under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+CONDITIONS OF ANY KIND, either express or implied. See the License for the
+specific language governing permissions and limitations under the License.
+
+For additional information, contact:
+Environmental Systems Research Institute, Inc.
+Attn: Contracts Dept
+380 New York Street
+Redlands, California, USA 92373
+email: contracts@esri.com
+*/
+
+#include "pch.h"
+#include "i3s/i3s_texture_atlas.h"
+#include "i3s/i3s_legacy_mesh.h"
+#include "utils/utl_bitstream.h"
+#include "utils/utl_image_resize.h"
+#include "utils/utl_i3s_assert.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace i3slib
+{
+
+namespace i3s
+{
+
+namespace
+{
+
+// Rectangles are aligned on DXT blocks, so that compressed blocks never straddle two images.
+constexpr int c_block_size = 4;
+
+// Each failed packing attempt shrinks the images by this factor.
+constexpr double c_shrink_factor = 0.8;
+constexpr int c_max_packing_attempts = 24;
+
+// UVs slightly outside of [0, 1] ( rounding errors ) are clamped rather than considered repeated.
+constexpr float c_uv_tolerance = 1e-3f;
+
+int align_to_block(int v)
+{
+  return (v + c_block_size - 1) / c_block_size * c_block_size;
+}
+
+struct Skyline_segment
+{
+  int x, y, width;
+};
+
+// Packs the rectangles ( in the given order ) in an atlas of the given width. Returns the height used, or -1 if max_height is exceeded.
+int pack_skyline(const std::vector<utl::Vec2i>& sizes, const std::vector<int>& order, int width, int max_height, std::vector<utl::Vec2i>* positions)
+{
+  std::vector<Skyline_segment> skyline{ { 0, 0, width } };
+  int height = 0;
+  for (auto r : order)
+  {
+    const auto& size = sizes[r];
+
+    // bottom-left: lowest position, ties broken by the narrowest segment.
+    int best = -1, best_y = std::numeric_limits<int>::max(), best_width = std::numeric_limits<int>::max();
+    for (int i = 0; i < static_cast<int>(skyline.size()); ++i)
+    {
+      if (skyline[i].x + size.x > width)
+        break;
+
+      int y = 0;
+      for (int j = i, covered = 0; covered < size.x; ++j)
+      {
+        y = std::max(y, skyline[j].y);
+        covered += skyline[j].width;
+      }
+      if (y + size.y > max_height)
+        continue;
+      if (y < best_y || (y == best_y && skyline[i].width < best_width))
+      {
+        best = i;
+        best_y = y;
+        best_width = skyline[i].width;
+      }
+    }
+    if (best < 0)
+      return -1;
+
+    const int x = skyline[best].x;
+    (*positions)[r] = utl::Vec2i(x, best_y);
+    height = std::max(height, best_y + size.y);
+
+    // the new segment hides ( or shortens ) the following ones:
+    skyline.insert(skyline.begin() + best, { x, best_y + size.y, size.x });
+    const int right = x + size.x;
+    for (size_t j = best + 1; j < skyline.size() && skyline[j].x < right; )
+    {
+      const int overlap = right - skyline[j].x;
+      if (overlap < skyline[j].width)
+      {
+        skyline[j].x += overlap;
+        skyline[j].width -= overlap;
+        break;
+      }
+      skyline.erase(skyline.begin() + j);
+    }
+
+    // merge segments of the same height:
+    for (size_t j = 1; j < skyline.size(); )
+    {
+      if (skyline[j].y == skyline[j - 1].y)
+      {
+        skyline[j - 1].width += skyline[j].width;
+        skyline.erase(skyline.begin() + j);
+      }
+      else
+        ++j;
+    }
+  }
+  return height;
+}
+
+// Copies img ( resampled to rect ) to atlas, its border texels being replicated over padding texels.
+void blit(const Texture_buffer& img, const Atlas_rect& rect, int padding, int atlas_width, int atlas_height, uint32_t* atlas)
+{
+  const int channels = img.meta.format == Image_format::Raw_rgb8 ? 3 : 4;
+  const char* src = img.data.data();
+  std::vector<char> resampled;
+  if (img.width() != rect.width || img.height() != rect.height)
+  {
+    resampled.resize(static_cast<size_t>(rect.width) * rect.height * channels);
+    utl::resample_2d_uint8(img.width(), img.height(), rect.width, rect.height, src, resampled.data(), channels, utl::Alpha_mode::Pre_mult);
+    src = resampled.data();
+  }
+
+  const int x0 = std::max(0, rect.x - padding), x1 = std::min(atlas_width, rect.x + rect.width + padding);
+  const int y0 = std::max(0, rect.y - padding), y1 = std::min(atlas_height, rect.y + rect.height + padding);
+  for (int y = y0; y < y1; ++y)
+  {
+    const int sy = std::clamp(y - rect.y, 0, rect.height - 1);
+    const auto* row = reinterpret_cast<const uint8_t*>(src) + static_cast<size_t>(sy) * rect.width * channels;
+    auto* out = atlas + static_cast<size_t>(y) * atlas_width;
+    for (int x = x0; x < x1; ++x)
+    {
+      const auto* texel = row + std::clamp(x - rect.x, 0, rect.width - 1) * channels;
+      const uint32_t alpha = channels == 4 ? texel[3] : 0xFF;
+      out[x] = texel[0] | (texel[1] << 8) | (texel[2] << 16) | (alpha << 24);
+    }
+  }
+}
+
+uint16_t to_region_coord(double v)
+{
+  return static_cast<uint16_t>(std::lround(std::clamp(v, 0.0, 1.0) * 0xFFFF));
+}
+
+}
+
+bool pack_atlas_rects(
+  const std::vector<utl::Vec2i>& sizes,
+  int max_size,
+  bool power_of_two,
+  utl::Vec2i* atlas_size,
+  std::vector<utl::Vec2i>* positions)
+{
+  if (power_of_two)
+    max_size = static_cast<int>(utl::round_down_power_of_two(static_cast<uint32_t>(std::max(1, max_size))));
+
+  int64_t area = 0;
+  int min_width = 1;
+  for (const auto& size : sizes)
+  {
+    if (size.x <= 0 || size.y <= 0 || size.x > max_size || size.y > max_size)
+      return false;
+    area += static_cast<int64_t>(size.x) * size.y;
+    min_width = std::max(min_width, size.x);
+  }
+
+  // tallest first:
+  std::vector<int> order(sizes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&sizes](int a, int b)
+  {
+    return sizes[a].y != sizes[b].y ? sizes[a].y > sizes[b].y : sizes[a].x > sizes[b].x;
+  });
+
+  // Try atlas widths from the square root of the area up to max_size and keep the smallest atlas:
+  auto round_size = [power_of_two](int v)
+  {
+    return power_of_two ? static_cast<int>(utl::round_up_power_of_two(static_cast<uint32_t>(v))) : align_to_block(v);
+  };
+  int width = round_size(std::max(min_width, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(area))))));
+  int64_t best_area = std::numeric_limits<int64_t>::max();
+  std::vector<utl::Vec2i> candidate(sizes.size());
+  for (; width <= max_size; width = power_of_two ? width * 2 : round_size(width + width / 4 + 1))
+  {
+    const int height = pack_skyline(sizes, order, width, max_size, &candidate);
+    if (height < 0)
+      continue;
+
+    const int atlas_height = std::min(max_size, round_size(std::max(1, height)));
+    if (static_cast<int64_t>(width) * atlas_height < best_area)
+    {
+      best_area = static_cast<int64_t>(width) * atlas_height;
+      *atlas_size = utl::Vec2i(width, atlas_height);
+      positions->swap(candidate);
+      candidate.resize(sizes.size());
+    }
+    if (height <= width)
+      break; // wider atlases would not be smaller.
+  }
+  return best_area != std::numeric_limits<int64_t>::max();
+}
+
+bool build_texture_atlas(
+  const std::vector<Texture_buffer>& raw_imgs,
+  const Texture_atlas_params& params,
+  Texture_buffer* atlas,
+  std::vector<Atlas_rect>* rects)
+{
+  for (const auto& img : raw_imgs)
+  {
+    if (img.empty() || img.width() <= 0 || img.height() <= 0
+      || (img.meta.format != Image_format::Raw_rgb8 && img.meta.format != Image_format::Raw_rgba8))
+      return false;
+  }
+
+  const int padding = align_to_block(std::max(0, params.padding));
+  std::vector<utl::Vec2i> sizes(raw_imgs.size()), positions;
+  utl::Vec2i atlas_size;
+  auto scale = std::min(1.0, params.texel_scale);
+  bool is_packed = false;
+  for (int attempt = 0; attempt < c_max_packing_attempts && !is_packed; ++attempt, scale *= c_shrink_factor)
+  {
+    for (size_t i = 0; i < raw_imgs.size(); ++i)
+    {
+      sizes[i].x = align_to_block(std::max(1, static_cast<int>(std::lround(raw_imgs[i].width() * scale)))) + 2 * padding;
+      sizes[i].y = align_to_block(std::max(1, static_cast<int>(std::lround(raw_imgs[i].height() * scale)))) + 2 * padding;
+    }
+    is_packed = pack_atlas_rects(sizes, params.max_size, params.power_of_two, &atlas_size, &positions);
+  }
+  if (!is_packed)
+    return false;
+
+  const int size_in_bytes = atlas_size.x * atlas_size.y * static_cast<int>(sizeof(uint32_t));
+  auto buffer = std::make_shared<utl::Buffer>(nullptr, size_in_bytes, utl::Buffer::Memory::Deep_aligned);
+  auto pixels = buffer->create_writable_view();
+  std::memset(pixels.data(), 0, size_in_bytes);
+
+  rects->resize(raw_imgs.size());
+  for (size_t i = 0; i < raw_imgs.size(); ++i)
+  {
+    auto& rect = (*rects)[i];
+    rect.x = positions[i].x + padding;
+    rect.y = positions[i].y + padding;
+    rect.width = sizes[i].x - 2 * padding;
+    rect.height = sizes[i].y - 2 * padding;
+    blit(raw_imgs[i], rect, padding, atlas_size.x, atlas_size.y, reinterpret_cast<uint32_t*>(pixels.data()));
+  }
+
+  atlas->data = pixels;
+  atlas->meta = Texture_meta();
+  atlas->meta.mip0_width = atlas_size.x;
+  atlas->meta.mip0_height = atlas_size.y;
+  atlas->meta.mip_count = 1;
+  atlas->meta.format = Image_format::Raw_rgba8;
+  atlas->meta.wrap_mode = Texture_meta::Wrap_mode::None;
+  atlas->meta.is_atlas = true;
+  atlas->meta.semantic = Texture_semantic::Base_color;
+  return true;
+}
+
+bool needs_uv_regions(const Mesh_abstract& mesh)
+{
+  if (mesh.get_regions().size())
+    return true;
+
+  const auto& uvs = mesh.get_uvs(0).values;
+  for (int i = 0; i < uvs.size(); ++i)
+  {
+    if (uvs[i].x < -c_uv_tolerance || uvs[i].x > 1.0f + c_uv_tolerance
+      || uvs[i].y < -c_uv_tolerance || uvs[i].y > 1.0f + c_uv_tolerance)
+      return true;
+  }
+  return false;
+}
+
+Mesh_abstract::Ptr remap_to_atlas(
+  const Mesh_abstract& mesh,
+  const Atlas_rect& rect,
+  const utl::Vec2i& atlas_size,
+  bool use_regions)
+{
+  const auto count = mesh.get_vertex_count();
+  const auto& uvs = mesh.get_uvs(0);
+  if (uvs.size() != count || atlas_size.x <= 0 || atlas_size.y <= 0)
+    return nullptr;
+
+  // rect in normalized atlas coordinates:
+  const double x0 = static_cast<double>(rect.x) / atlas_size.x, sx = static_cast<double>(rect.width) / atlas_size.x;
+  const double y0 = static_cast<double>(rect.y) / atlas_size.y, sy = static_cast<double>(rect.height) / atlas_size.y;
+
+  Mesh_bulk_data bulk;
+  bulk.origin = mesh.get_origin();
+  bulk.rel_pos = mesh.get_relative_positions();
+  bulk.normals = mesh.get_normals();
+  bulk.colors = mesh.get_colors();
+  bulk.fids = mesh.get_feature_ids();
+  if (use_regions)
+  {
+    const auto& src = mesh.get_regions();
+    if (src.size() && src.size() != count)
+      return nullptr;
+
+    constexpr double c_to_norm = 1.0 / 0xFFFF;
+    auto regions = utl::Buffer::create_writable_typed_view<Uv_region>(count);
+    for (int i = 0; i < count; ++i)
+    {
+      const auto r = src.size() ? utl::Vec4d(src[i]) * c_to_norm : utl::Vec4d(0.0, 0.0, 1.0, 1.0);
+      regions[i] = Uv_region(
+        to_region_coord(x0 + r.x * sx), to_region_coord(y0 + r.y * sy),
+        to_region_coord(x0 + r.z * sx), to_region_coord(y0 + r.w * sy));
+    }
+    bulk.uvs = uvs;
+    bulk.uv_region.values = regions;
+  }
+  else
+  {
+    I3S_ASSERT(mesh.get_regions().size() == 0);
+    auto values = utl::Buffer::create_writable_typed_view<utl::Vec2f>(uvs.values.size());
+    for (int i = 0; i < values.size(); ++i)
+    {
+      values[i].x = static_cast<float>(x0 + std::clamp(uvs.values[i].x, 0.0f, 1.0f) * sx);
+      values[i].y = static_cast<float>(y0 + std::clamp(uvs.values[i].y, 0.0f, 1.0f) * sy);
+    }
+    bulk.uvs.values = values;
+    bulk.uvs.index = uvs.index;
+  }
+  return Mesh_abstract::Ptr(parse_mesh_from_bulk(bulk));
+}
+
+}
+
+} // namespace i3slib
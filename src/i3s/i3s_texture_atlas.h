@@ -0,0 +1,74 @@
+/*
+Copyright 2020 Esri
+
+Licensed under the Apache License, Version 2.0 (the "License"); you may not use
+this file except in compliance with the License. You may obtain a copy of
+the License at http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software distributed
+under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+CONDITIONS OF ANY KIND, either express or implied. See the License for the
+specific language governing permissions and limitations under the License.
+
+For additional information, contact:
+Environmental Systems Research Institute, Inc.
+Attn: Contracts Dept
+380 New York Street
+Redlands, California, USA 92373
+email: contracts@esri.com
+*/
+
+#pragma once
+
+#include "i3s/i3s_common_.h"
+#include "i3s/i3s_writer.h"
+#include "utils/utl_i3s_export.h"
+#include <vector>
+
+namespace i3slib
+{
+
+namespace i3s
+{
+
+//! Texels of an image in the atlas, padding excluded.
+struct Atlas_rect
+{
+  int x = 0, y = 0;
+  int width = 0, height = 0;
+};
+
+//! Skyline bottom-left packing of rectangles ( largest first ) in an atlas of at most max_size x max_size texels.
+//! The atlas size is the smallest found by the heuristic, rounded up to a power of two if requested.
+//! Returns false if the rectangles do not fit.
+I3S_EXPORT bool pack_atlas_rects(
+  const std::vector<utl::Vec2i>& sizes,
+  int max_size,
+  bool power_of_two,
+  utl::Vec2i* atlas_size,
+  std::vector<utl::Vec2i>* positions);
+
+//! Packs uncompressed ( Raw_rgb8 or Raw_rgba8 ) images in a Raw_rgba8 atlas. Images are scaled by params.texel_scale,
+//! or less if they would not fit in params.max_size. Their border texels are replicated in the padding.
+//! rects receives the area of each image in the atlas.
+I3S_EXPORT bool build_texture_atlas(
+  const std::vector<Texture_buffer>& raw_imgs,
+  const Texture_atlas_params& params,
+  Texture_buffer* atlas,
+  std::vector<Atlas_rect>* rects);
+
+//! Returns true if the texture coordinates of mesh can't be made absolute in an atlas:
+//! the mesh already has UV regions, or its UVs repeat the texture.
+I3S_EXPORT bool needs_uv_regions(const Mesh_abstract& mesh);
+
+//! Returns a copy of mesh textured by rect of an atlas of atlas_size texels. Other attributes are shallow-copied.
+//! If use_regions is set, UVs are kept and UV regions are set ( or composed with the existing ones ) to rect.
+//! Otherwise, UVs are made absolute in the atlas and the mesh must not need regions ( see needs_uv_regions() ).
+I3S_EXPORT Mesh_abstract::Ptr remap_to_atlas(
+  const Mesh_abstract& mesh,
+  const Atlas_rect& rect,
+  const utl::Vec2i& atlas_size,
+  bool use_regions);
+
+}
+
+} // namespace i3slib
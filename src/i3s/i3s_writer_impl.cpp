@@ -34,17 +34,20 @@ email: contracts@esri.com
 #include "utils/utl_image_resize.h"
 #include "utils/utl_json_helper.h"
 #include "utils/utl_geom.h"
+#include "utils/utl_colors.h"
 #include "utils/utl_slpk_writer_api.h"
 #include "utils/utl_envelope.h"
 #include "utils/utl_string.h"
 #include "i3s/i3s_pages_localsubtree.h"
 #include "i3s/i3s_pages_breadthfirst.h"
 #include "i3s/i3s_attribute_buffer_encoder.h"
+#include "utils/utl_zip_archive_impl.h"
 
 #include <stdint.h>
 #include <set>
 #include <deque>
 #include <ctime>
+#include <fstream>
 
 namespace i3slib
 {
@@ -354,10 +357,8 @@ namespace
 {
 
 void compute_obb(const Spatial_reference_xform& xform
-  , const utl::Vec3d* points, int count, utl::Obb_abs& obb, utl::Vec4d& mbs)
+  , const utl::Vec3d* points, int count, utl::Pro_hull& hull, utl::Obb_abs& obb, utl::Vec4d& mbs)
 {
-  utl::Pro_hull hull(utl::Pro_set::get_default());
-
   //deep copy:
   std::vector< utl::Vec3d > points_copy(count);
   copy_elements(points_copy.data(), points, count);
@@ -365,6 +366,92 @@ void compute_obb(const Spatial_reference_xform& xform
   compute_obb(xform, points_copy, hull, obb, mbs);
 }
 
+void compute_obb(const Spatial_reference_xform& xform
+  , const utl::Vec3d* points, int count, utl::Obb_abs& obb, utl::Vec4d& mbs)
+{
+  utl::Pro_hull hull(utl::Pro_set::get_default());
+  compute_obb(xform, points, count, hull, obb, mbs);
+}
+
+//! Bounding volumes of the children of a node.
+struct Child_bounds
+{
+  std::vector< utl::Obb_abs > obbs;
+  std::vector< utl::Vec4d >   mbs;
+  std::vector< char >         has_hull; // the geometry of the child is in 'hull'.
+  utl::Pro_hull               hull;     // merged hulls of the children ( destination cartesian space )
+  utl::Pro_hull::Fit          fit = utl::Pro_hull::Fit::Intervals; // see Writer_context::tight_node_obb
+};
+
+//! Computes the bounding volumes of a node from the bounds of its children and, if obb is valid, from the bounds 
+//! of its own geometry ( whose hull is in 'hull' ). On output, 'hull' bounds the geometry of the subtree.
+//! The box is computed for the merged hulls rather than for the corners of the child boxes, which would 
+//! accumulate the slack of the boxes at every level.
+void compute_obb(
+  const Spatial_reference_xform& xform,
+  const Child_bounds& children,
+  utl::Pro_hull& hull,
+  utl::Obb_abs& obb,
+  utl::Vec4d& mbs)
+{
+  auto boxes = children.obbs;
+  auto spheres = children.mbs;
+  if (obb.is_valid())
+  {
+    boxes.push_back(obb);
+    spheres.push_back(mbs);
+  }
+
+  // to cartesian space, at once:
+  const auto box_count = static_cast<int>(boxes.size());
+  const auto sphere_count = static_cast<int>(spheres.size());
+  std::vector< utl::Vec3d > centers(box_count + sphere_count);
+  for (int i = 0; i < box_count; ++i)
+    centers[i] = boxes[i].center;
+  for (int i = 0; i < sphere_count; ++i)
+    centers[box_count + i] = spheres[i].xyz();
+  to_dst_cartesian(xform, centers.data(), static_cast<int>(centers.size()));
+  for (int i = 0; i < box_count; ++i)
+    boxes[i].center = centers[i];
+
+  // children without hull ( shard roots, precomputed OBBs ) are bounded by their boxes:
+  std::array< utl::Vec3d, 8 > corners;
+  for (size_t i = 0; i < children.obbs.size(); ++i)
+  {
+    if (children.has_hull[i])
+      continue;
+    boxes[i].get_corners(corners.data(), 8);
+    for (const auto& corner : corners)
+      hull.add(corner);
+  }
+  hull.add(children.hull);
+
+  hull.get_box(boxes.data(), box_count, obb, utl::Pro_hull::Method::Minimal_surface_area, children.fit);
+
+  // bounding sphere: the smallest of the spheres around the box, the child boxes and the child spheres:
+  double box_radius = 0.0;
+  for (const auto& box : boxes)
+  {
+    box.get_corners(corners.data(), 8);
+    for (const auto& corner : corners)
+      box_radius = std::max(box_radius, obb.center.distance(corner));
+  }
+  double sphere_radius = 0.0;
+  for (int i = 0; i < sphere_count; ++i)
+    sphere_radius = std::max(sphere_radius, obb.center.distance(centers[box_count + i]) + spheres[i].w);
+  auto radius = std::min({ utl::Vec3d(obb.extents).length(), box_radius, sphere_radius });
+  //enforce a minimum extent, as for a single point:
+  if (radius == 0.)
+  {
+    radius = 1.0;
+    obb.extents = { 1.0f, 1.0f, 1.0f };
+  }
+
+  //convert center back:
+  from_dst_cartesian(xform, &obb.center);
+  mbs = utl::Vec4d(obb.center, radius);
+}
+
 
 } // namespace
 
@@ -421,12 +508,17 @@ void compute_obb(
   compute_obb(xform, child_obbs, hull, corners, obb, mbs);
 }
 
+namespace
+{
+
+//! On output, 'hull' bounds the geometry of the mesh and of the children.
 status_t project_update_mesh_origin_and_obb(
   utl::Basic_tracker* trk,
   Layer_type layer_type,
   const Spatial_reference_xform& xform,
   Mesh_abstract& mesh,
-  const std::vector<utl::Obb_abs>& ch_obbs,
+  const Child_bounds& children,
+  utl::Pro_hull& hull,
   utl::Obb_abs& obb,
   utl::Vec4d& mbs)
 {
@@ -456,11 +548,11 @@ status_t project_update_mesh_origin_and_obb(
     abs_positions, abs_positions_count);
   if (hr != Spatial_reference_xform::Status_t::Ok)
     return log_error_s(trk, IDS_I3S_PROJ_ENGINE_TRANS_ERROR);
-  compute_obb(xform, abs_positions, abs_positions_count, obb, mbs);
+  compute_obb(xform, abs_positions, abs_positions_count, hull, obb, mbs);
 
   // update obb, including children
-  if (ch_obbs.size())
-    compute_obb(xform, ch_obbs, obb, mbs);
+  if (children.obbs.size())
+    compute_obb(xform, children, hull, obb, mbs);
 
   // Update relative positions to reflect abs positions.
   if (!mesh.update_positions(obb.center, abs_positions, abs_positions_count))
@@ -470,6 +562,26 @@ status_t project_update_mesh_origin_and_obb(
   return IDS_I3S_OK;
 }
 
+} // namespace
+
+status_t project_update_mesh_origin_and_obb(
+  utl::Basic_tracker* trk,
+  Layer_type layer_type,
+  const Spatial_reference_xform& xform,
+  Mesh_abstract& mesh,
+  const std::vector<utl::Obb_abs>& ch_obbs,
+  utl::Obb_abs& obb,
+  utl::Vec4d& mbs)
+{
+  Child_bounds children;
+  children.obbs = ch_obbs;
+  children.has_hull.resize(ch_obbs.size(), 0);
+  for (const auto& ch_obb : ch_obbs)
+    children.mbs.emplace_back(ch_obb.center, ch_obb.radius());
+  utl::Pro_hull hull(utl::Pro_set::get_default());
+  return project_update_mesh_origin_and_obb(trk, layer_type, xform, mesh, children, hull, obb, mbs);
+}
+
 utl::Vec3f get_somewhat_anisotropic_scale(Writer_context& ctx, const Spatial_reference_xform& xform, const Mesh_abstract& mesh)
 {
   //estimate X/Y scale if globe mode:
@@ -671,20 +783,7 @@ static int get_alpha_bits(const Texture_buffer& img)
     case Image_format::Raw_rgba8:
     {
       I3S_ASSERT_EXT((img.data.size() % 4) == 0);
-      const uint32_t* pix32 = reinterpret_cast<const uint32_t*>(img.data.data());
-      const uint32_t* end = reinterpret_cast<const uint32_t*>(img.data.data() + img.data.size());
-      //uint32_t n = img.data.size();
-      uint32_t lo = 256;
-      while (pix32 < end)
-      {
-        uint32_t a = ((*(pix32++)) >> 24) & 0xFF;
-        if (a > 0 && a < 255)
-          return 8;
-        lo = std::min(lo, a);
-      }
-      return lo == 255 ?
-        0 : //opaque image
-        1; // 1-bit mask image ( 0 or 255 only)
+      return utl::get_alpha_bits(reinterpret_cast<const utl::Rgba8*>(img.data.data()), img.data.size() / 4);
     }
     default:
       I3S_ASSERT_EXT(false);
@@ -772,6 +871,44 @@ void scale_texture(const Texture_buffer& img, int w, int h, Texture_buffer& out)
 
 }
 
+//! get the uncompressed texture of tex_set, decoding the PNG or JPEG one if needed.
+static status_t get_raw_texture(const Writer_context& builder_ctx, const Multi_format_texture_buffer& tex_set, const std::string& res_id_for_error_only, Texture_buffer& raw_img)
+{
+  auto trk = builder_ctx.tracker();
+
+  // Check if there's raw texture in the input.
+  std::optional<size_t> raw_idx = find_tex(tex_set, Image_format::Raw_rgba8);
+  if (!raw_idx)
+    raw_idx = find_tex(tex_set, Image_format::Raw_rgb8);
+
+  if (raw_idx)
+    raw_img = tex_set[*raw_idx];
+  else if (const std::optional<size_t> png_index = find_tex(tex_set, Image_format::Png))
+  {
+    // There's no raw texture readily available, have to decompress from PNG.
+    if (
+      !builder_ctx.decoder->decode_png ||
+      !builder_ctx.decoder->decode_png(tex_set[*png_index].data, &raw_img))
+    {
+      return log_error_s(trk, IDS_I3S_IMAGE_ENCODING_ERROR, res_id_for_error_only, std::string("PNG"));
+    }
+  }
+  else if (const std::optional<size_t> pre_raw_idx = find_tex(tex_set, Image_format::Jpg))
+  {
+    if (
+      !builder_ctx.decoder->decode_jpeg ||
+      !builder_ctx.decoder->decode_jpeg(tex_set[*pre_raw_idx].data, &raw_img))
+    {
+      return log_error_s(trk, IDS_I3S_IMAGE_ENCODING_ERROR, res_id_for_error_only, std::string("JPEG"));
+    }
+  }
+  else
+    return log_error_s(trk, IDS_I3S_MISSING_JPG_OR_PNG, res_id_for_error_only);
+
+  I3S_ASSERT_EXT(!raw_img.empty());
+  return IDS_I3S_OK;
+}
+
 //! generate the missing texture format based on what texture encoder have been provided in the context
 static status_t create_texture_set(const Writer_context& builder_ctx, Multi_format_texture_buffer& tex_set, const std::string& res_id_for_error_only)
 {
@@ -845,36 +982,9 @@ static status_t create_texture_set(const Writer_context& builder_ctx, Multi_form
   Texture_buffer raw_img;
   Texture_buffer pot_img; // scaled to power-of-two dimensions, only used for DDS/DXT
   {
-    // Check if there's raw texture in the input.
-    std::optional<size_t> raw_idx = find_tex(tex_set, Image_format::Raw_rgba8);
-    if (!raw_idx)
-      raw_idx = find_tex(tex_set, Image_format::Raw_rgb8);
-    
-    if (raw_idx)
-      raw_img = tex_set[*raw_idx];
-    else if (png_index)
-    {
-      // There's no raw texture readily available, have to decompress from PNG.
-      if (
-        !builder_ctx.decoder->decode_png ||
-        !builder_ctx.decoder->decode_png(tex_set[*png_index].data, &raw_img))
-      {
-        return log_error_s(trk, IDS_I3S_IMAGE_ENCODING_ERROR, res_id_for_error_only, std::string("PNG"));
-      }
-    }
-    else if (const std::optional<size_t> pre_raw_idx = find_tex(tex_set, Image_format::Jpg))
-    {
-      if (
-        !builder_ctx.decoder->decode_jpeg ||
-        !builder_ctx.decoder->decode_jpeg(tex_set[*pre_raw_idx].data, &raw_img))
-      {
-        return log_error_s(trk, IDS_I3S_IMAGE_ENCODING_ERROR, res_id_for_error_only, std::string("JPEG"));
-      }
-    }
-    else
-      return log_error_s(trk, IDS_I3S_MISSING_JPG_OR_PNG, res_id_for_error_only);
+    if (auto st = get_raw_texture(builder_ctx, tex_set, res_id_for_error_only, raw_img); st != IDS_I3S_OK)
+      return st;
 
-    I3S_ASSERT_EXT(!raw_img.empty());
     if ((int)raw_img.meta.alpha_status <= 0)
       raw_img.meta.alpha_status = (Texture_meta::Alpha_status)get_alpha_bits(raw_img);
 
@@ -1008,24 +1118,87 @@ bool dbg_compare_points(const i3s::Mesh_abstract& legacy_mesh, const i3s::Mesh_a
 
 namespace detail
 {
-int Material_helper::get_or_create_texture_set(Image_formats f, bool is_atlas, Texture_semantic sem)
+
+namespace
 {
+
+// splitmix64 finalizer of the combination, so that all bits of the ( mostly float ) words contribute to the low bits of the hash.
+uint64_t combine_hash(uint64_t h, uint64_t word)
+{
+  uint64_t x = word + h + 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+uint64_t get_float_bits(float v)
+{
+  uint32_t bits;
+  v = v == 0.0f ? 0.0f : v; // -0.0f == 0.0f
+  memcpy(&bits, &v, sizeof(bits));
+  return bits;
+}
+
+uint64_t combine_hash(uint64_t h, const Material_texture_desc& tex)
+{
+  h = combine_hash(h, static_cast<uint32_t>(tex.tex_def_id) | static_cast<uint64_t>(static_cast<uint32_t>(tex.tex_coord_set)) << 32);
+  return combine_hash(h, get_float_bits(tex.factor));
+}
+
+}
+
+//! Fields of Material_desc::operator==().
+size_t Material_helper::Material_hash::operator()(const Material_desc& mat) const noexcept
+{
+  uint64_t h = combine_hash(0, static_cast<uint64_t>(mat.alpha_mode) | static_cast<uint64_t>(mat.cull_face) << 16 | static_cast<uint64_t>(mat.is_double_sided) << 32);
+  h = combine_hash(h, get_float_bits(mat.alpha_cutoff));
+  h = combine_hash(h, mat.normal_tex);
+  h = combine_hash(h, mat.occlusion_tex);
+  h = combine_hash(h, mat.emissive_tex);
+  for (int i = 0; i < 3; ++i)
+    h = combine_hash(h, get_float_bits(mat.emissive_factor[i]));
+  for (int i = 0; i < 4; ++i)
+    h = combine_hash(h, get_float_bits(mat.metal.base_color_factor[i]));
+  h = combine_hash(h, mat.metal.base_color_tex);
+  h = combine_hash(h, get_float_bits(mat.metal.metallic_factor));
+  h = combine_hash(h, mat.metal.metal_tex);
+  return static_cast<size_t>(h);
+}
+
+size_t Material_helper::Texture_set_hash::operator()(uint64_t key) const noexcept
+{
+  return static_cast<size_t>(combine_hash(0, key));
+}
+
+//! Shared lookup, then insertion on miss. The shard is selected by the high bits of the hash, the buckets of its map by the low ones.
+template< class Key, class Hash, class Create >
+int Material_helper::_get_or_create(Shards< Key, Hash >& shards, const Key& key, Create&& create)
+{
+  auto& shard = shards[Hash()(key) >> (sizeof(size_t) * 8 - c_shard_bits)];
   {
-    utl::Lock_guard lk(m_mutex);
-    auto found = std::find_if(m_tex_def.begin(), m_tex_def.end(), [f, is_atlas, sem](const Texture_definition_desc& desc)
-    {
-      if (desc.is_atlas != is_atlas)
-        return false;
-      Image_formats mask = 0;
-      for (auto& f : desc.formats)
-        mask |= (Image_formats)f.format;
-      if (mask != f)
-        return false;
-      return sem == desc.sem;
-    });
+    std::shared_lock< std::shared_mutex > lk(shard.mutex);
+    auto found = shard.ids.find(key);
+    if (found != shard.ids.end())
+      return found->second;
+  }
+  std::unique_lock< std::shared_mutex > lk(shard.mutex);
+  auto found = shard.ids.find(key);
+  if (found != shard.ids.end())
+    return found->second; // created by another thread
+  int id;
+  {
+    utl::Lock_guard defs_lk(m_mutex);
+    id = create();
+  }
+  shard.ids.emplace(key, id);
+  return id;
+}
 
-    if (found != m_tex_def.end())
-      return (int)(found - m_tex_def.begin());
+int Material_helper::get_or_create_texture_set(Image_formats f, bool is_atlas, Texture_semantic sem)
+{
+  const uint64_t key = f | static_cast<uint64_t>(is_atlas) << 32 | static_cast<uint64_t>(static_cast<uint16_t>(sem)) << 40;
+  return _get_or_create(m_tex_shards, key, [this, f, is_atlas, sem]()
+  {
     Texture_definition_desc tex_def;
     utl::for_each_bit_set(f, [&tex_def, sem](int bit_number)
     {
@@ -1039,7 +1212,7 @@ int Material_helper::get_or_create_texture_set(Image_formats f, bool is_atlas, T
     tex_def.sem = sem;
     m_tex_def.push_back(tex_def);
     return (int)m_tex_def.size() - 1;
-  } // -> unlock
+  });
 }
 
 int Material_helper::get_or_create_material(const Material_desc& data)
@@ -1049,15 +1222,11 @@ int Material_helper::get_or_create_material(const Material_desc& data)
   if (copy.alpha_mode == Alpha_mode::Opaque)
     copy.alpha_cutoff = Material_desc::c_default_alpha_cutoff; //suppress it.
 
+  return _get_or_create(m_mat_shards, copy, [this, &copy]()
   {
-    utl::Lock_guard lk(m_mutex);
-    auto found = std::find(m_mat_def.begin(), m_mat_def.end(), copy);
-    if (found != m_mat_def.end())
-      return (int)(found - m_mat_def.begin());
-
     m_mat_def.push_back(copy);
     return (int)m_mat_def.size() - 1;
-  } // -> unlock
+  });
 }
 
 std::vector< std::string >  Material_helper::get_legacy_texture_mime_types() const
@@ -1075,6 +1244,143 @@ std::vector< std::string >  Material_helper::get_legacy_texture_mime_types() con
   return get_texture_mime_types(mask);
 }
 
+// ---------------------------------------------------------------------------------------------
+//        struct:      Layer_shard_desc
+// ---------------------------------------------------------------------------------------------
+
+static const std::string c_shard_desc_path{ "shard" };
+//! Descriptors of the shards merged in a layer ( by file name of the shard ), so that the layer can be updated without them.
+static const std::string c_merged_shard_desc_folder{ "shards/" };
+
+//! Subtree root of a shard. It has already been written as a child of parent_id.
+struct Shard_root_desc
+{
+  // --- fields:
+  uint32_t      id = 0;
+  uint32_t      parent_id = 0;
+  int           level = -1;
+  utl::Obb_abs  obb;
+  utl::Vec4d    mbs;
+  utl::Vec3d    envelope_min, envelope_max;
+  // --- 
+  SERIALIZABLE(Shard_root_desc);
+  template< class Ar > void serialize(Ar& ar)
+  {
+    ar & utl::nvp("id", id);
+    ar & utl::nvp("parentId", parent_id);
+    ar & utl::nvp("level", level);
+    ar & utl::nvp("obb", obb);
+    ar & utl::nvp("mbs", utl::seq(mbs));
+    ar & utl::nvp("envelopeMin", utl::seq(envelope_min));
+    ar & utl::nvp("envelopeMax", utl::seq(envelope_max));
+  }
+};
+
+//! Texture_definition_desc doesn't serialize the semantic.
+struct Shard_texture_set_desc
+{
+  // --- fields:
+  Image_formats formats = 0;
+  bool          is_atlas = false;
+  int           sem = 0; // Texture_semantic
+  // --- 
+  SERIALIZABLE(Shard_texture_set_desc);
+  template< class Ar > void serialize(Ar& ar)
+  {
+    ar & utl::nvp("formats", formats);
+    ar & utl::opt("atlas", is_atlas, false);
+    ar & utl::nvp("semantic", sem);
+  }
+};
+
+struct Shard_stats_desc
+{
+  // --- fields:
+  int         sid = 0;
+  int         index = 0;
+  std::string json; // as written in "statistics/f_<index>/0"
+  // --- 
+  SERIALIZABLE(Shard_stats_desc);
+  template< class Ar > void serialize(Ar& ar)
+  {
+    ar & utl::nvp("schema", sid);
+    ar & utl::nvp("index", index);
+    ar & utl::nvp("stats", json);
+  }
+};
+
+//! Written by Layer_writer::save_shard() with the shard resources. It holds everything the merging writer needs 
+//! to write the layer documents and the node pages. Node indices and geometry definition ids are **not** remapped.
+struct Layer_shard_desc
+{
+  // --- fields:
+  std::vector< Shard_root_desc >        roots;
+  std::vector< Node_desc_v17 >          nodes;
+  std::vector< Material_desc >          material_defs;
+  std::vector< Shard_texture_set_desc > tex_defs;
+  std::vector< int >                    geometry_def_counts;
+  Attrib_flags                          vb_attribs = 0;
+  Attrib_flags                          vb_attribs_mask_legacy = 0;
+  std::vector< Shard_stats_desc >       stats;
+  // --- 
+  SERIALIZABLE(Layer_shard_desc);
+  template< class Ar > void serialize(Ar& ar)
+  {
+    ar & utl::nvp("roots", utl::seq(roots));
+    ar & utl::nvp("nodes", utl::seq(nodes));
+    ar & utl::nvp("materialDefinitions", utl::seq(material_defs));
+    ar & utl::nvp("textureSetDefinitions", utl::seq(tex_defs));
+    ar & utl::nvp("geometryDefinitionCounts", utl::seq(geometry_def_counts));
+    ar & utl::nvp("vertexAttributes", vb_attribs);
+    ar & utl::nvp("vertexAttributesLegacy", vb_attribs_mask_legacy);
+    ar & utl::nvp("statistics", utl::seq(stats));
+  }
+};
+
+// ---------------------------------------------------------------------------------------------
+//        struct:      Merged_attribute_stats
+// ---------------------------------------------------------------------------------------------
+
+static bool is_string_stats(Type type)
+{
+  return type == Type::String_utf8 || type == Type::Global_id || type == Type::Guid;
+}
+
+bool Merged_attribute_stats::merge(const std::string& json, utl::Basic_tracker* trk, const std::string& ref)
+{
+  if (type == Type::Date_iso_8601)
+  {
+    utl::Attribute_stats_desc< utl::Atrb_stats_datetime< std::string > > src;
+    if (!utl::from_json_safe(json, &src, trk, ref))
+      return false;
+    utl::merge_stats(&datetime.stats, src.stats);
+  }
+  else if (is_string_stats(type))
+  {
+    utl::Attribute_stats_desc< utl::Atrb_stats_string< std::string > > src;
+    if (!utl::from_json_safe(json, &src, trk, ref))
+      return false;
+    utl::merge_stats(&string.stats, src.stats);
+  }
+  else
+  {
+    utl::Attribute_stats_desc< utl::Atrb_stats > src;
+    if (!utl::from_json_safe(json, &src, trk, ref))
+      return false;
+    utl::merge_stats(&numeric.stats, src.stats);
+  }
+  return true;
+}
+
+std::string Merged_attribute_stats::to_json() const
+{
+  if (type == Type::Date_iso_8601)
+    return utl::to_json(datetime);
+  if (is_string_stats(type))
+    return utl::to_json(string);
+  return utl::to_json(numeric);
+}
+
 
 // ---------------------------------------------------------------------------------------------
 //        class:      Node_io
@@ -1129,7 +1435,7 @@ i3s::status_t Node_io::_write_geometry(utl::Basic_tracker* trk, utl::Slpk_writer
   status_t status = IDS_I3S_OK; // exit if not ok
   if (layer_type == i3s::Layer_type::Point)
   {
-    if (l == Write_legacy::Yes)
+    if (l == Write_legacy::Yes && simple_geom.size())
     {
       //Legacy geometry is stored in JSON featureData ...
       auto enc = utl::Mime_encoding::Not_set;
@@ -1141,7 +1447,7 @@ i3s::status_t Node_io::_write_geometry(utl::Basic_tracker* trk, utl::Slpk_writer
       legacy_desc.feature_data.push_back({ "./features/0" });
     }
   }
-  else
+  else if (simple_geom.size()) // missing if Draco-only
   {
     // Contrary to the Layer_type::Point branch, not implementing the filter on (l == Write_legacy::Yes) here, because of the comment
     // on top of struct Legacy_feature_desc saying "featureData document is deprecated, but for 3DObject, Pro will read the OID from it (for no good reason)"
@@ -1158,7 +1464,8 @@ i3s::status_t Node_io::_write_geometry(utl::Basic_tracker* trk, utl::Slpk_writer
     out_size = 0;
     const Use_gzip gz = (g == Gzip_draco::Yes) ? Use_gzip::Yes : Use_gzip::No;
     auto enc = utl::Mime_encoding::Not_set;
-    if (layer_type == i3s::Layer_type::Point)
+    // Draco buffer follows the legacy one in the geometry definitions, unless there is no legacy buffer ( see create_mesh_desc() ):
+    if (layer_type == i3s::Layer_type::Point || !simple_geom.size())
       status = append_to_slpk(trk, slpk, "geometries/0", legacy_res_path, draco_geom, utl::Mime_type::Binary, &enc, gzip, &out_size, gz);
     else
       status = append_to_slpk(trk, slpk, "geometries/1", legacy_res_path, draco_geom, utl::Mime_type::Binary, &enc, gzip, &out_size, gz);
@@ -1185,7 +1492,7 @@ status_t Node_io::save(utl::Basic_tracker* trk, const Write_legacy legacy, utl::
     const bool write_legacy = (legacy == Write_legacy::Yes) && (legacy_id == legacy_node_ids.back());
 
     std::string legacy_res_path = layer_prefix + "nodes/" + legacy_id + "/";
-    if (simple_geom.size())
+    if (simple_geom.size() || draco_geom.size())
     {
       // --- write the textures:
       legacy_desc.texture_data.clear(); //the last one (if node is "root") will override.
@@ -1591,23 +1898,43 @@ static bool is_implicit_normals(std::shared_ptr<Mesh_abstract> mesh, const Write
   return true; // all implicit
 }
 
+// More of wrapper around  Mesh_abstract::Ptr. Maybe Geometry_buffer needs refactoring. 
+class Geometry_buffer_simple_impl : public Geometry_buffer
+{
+public:
+  explicit Geometry_buffer_simple_impl(Mesh_abstract::Ptr m) : m_mesh(m) {}
+  // --- Geometry_buffer:
+  virtual Mesh_abstract::Ptr        get_mesh() const override { return m_mesh; }
+  virtual Geometry_format           get_format() const override { return Geometry_format::Legacy; } //not completly true. TBD
+  virtual utl::Raw_buffer_view      to_legacy_buffer(Attrib_flags* actualy_written_attrib) const override { return encode_legacy_buffer(*m_mesh, actualy_written_attrib); }
+  virtual Modification_state        get_modification_state() const override { return Modification_state(); };
+private:
+  Mesh_abstract::Ptr m_mesh;
+};
+
+bool Layer_writer_impl::_is_draco_only() const
+{
+  // Legacy buffers are only needed by 1.6 clients, or if there's no other geometry buffer:
+  return m_ctx->write_legacy == Write_legacy::No && m_ctx->encode_to_draco;
+}
+
 void Layer_writer_impl::_encode_geometry_to_legacy(detail::Node_io& nio, const Geometry_buffer& src)
 {
+  if (_is_draco_only())
+    return;
+
   if (m_layer_meta.type == i3s::Layer_type::Point)
   {
     //let's create the legacy JSON for it:
-    std::string json_content;
     auto mesh = src.get_mesh();
     if (mesh->get_feature_ids().values.size() == mesh->get_absolute_positions().size())
-      encode_points_to_i3s(mesh->get_vertex_count(), mesh->get_absolute_positions().data(), mesh->get_feature_ids().values.data()
-        , &json_content,m_ctx->tracker());
+      nio.simple_geom = encode_points_to_i3s(mesh->get_vertex_count(), mesh->get_absolute_positions().data(), mesh->get_feature_ids().values.data()
+        , m_ctx->tracker());
     else
     {
       I3S_ASSERT( "fids / xyz size mismatch for Points Scene layer" ); //TODO: report error failure.
     }
 
-    nio.simple_geom = utl::Buffer::create_deep_copy(json_content.data(), (int)json_content.size());
-
     m_vb_attribs_mask_legacy |= (Attrib_flags)Attrib_flag::Pos | (Attrib_flags)Attrib_flag::Feature_id;
   }
   else
@@ -1667,6 +1994,13 @@ static std::optional<utl::Raw_buffer_view> try_convert_date_attribs_to_iso8601(
 namespace
 {
 
+// Per-thread arena of the per-node buffers, if enabled.
+utl::Buffer_arena* get_buffer_arena(const Writer_context& ctx)
+{
+  thread_local utl::Buffer_arena arena;
+  return ctx.use_buffer_arena ? &arena : nullptr;
+}
+
 utl::Boxd compute_mesh_envelope(const Mesh_abstract& mesh, const Spatial_reference_desc& sr, Layer_type layer_type)
 {
   const auto vertices = mesh.get_absolute_positions().data();
@@ -1711,6 +2045,7 @@ utl::Boxd merge_envelopes(const std::vector<utl::Boxd>& envelopes, const Spatial
 
 status_t Layer_writer_impl::create_output_node(const Simple_node_data& node, Node_id node_id)
 {
+  utl::Buffer_arena_scope arena_scope(get_buffer_arena(*m_ctx));
   std::string scratch;
   status_t status{ IDS_I3S_OK };
 
@@ -1742,8 +2077,11 @@ status_t Layer_writer_impl::create_output_node(const Simple_node_data& node, Nod
 
   const bool has_precomputed_obb = node.precomputed_obb.extent.x >= 0.0;
 
-  // get obb of children
-  std::vector<utl::Obb_abs> ch_obbs;
+  // get bounds of children
+  Child_bounds children;
+  if (m_ctx->tight_node_obb)
+    children.fit = utl::Pro_hull::Fit::Convexoid;
+  utl::Pro_hull hull;
 
   // Get envelopes of children as well.
   std::vector<utl::Boxd> envelopes;
@@ -1754,7 +2092,9 @@ status_t Layer_writer_impl::create_output_node(const Simple_node_data& node, Nod
     envelopes.reserve(node.children.size() + 1);
     if (!has_precomputed_obb)
     {
-      ch_obbs.reserve(node.children.size());
+      children.obbs.reserve(node.children.size());
+      children.mbs.reserve(node.children.size());
+      children.has_hull.reserve(node.children.size());
     }
 
     utl::Lock_guard lk(m_mutex);
@@ -1771,7 +2111,11 @@ status_t Layer_writer_impl::create_output_node(const Simple_node_data& node, Nod
         envelopes.push_back(*iter->second.envelope);
       if (!has_precomputed_obb)
       {
-        ch_obbs.push_back(iter->second.obb);
+        const auto& brief = iter->second;
+        children.obbs.push_back(brief.obb);
+        children.mbs.push_back(brief.mbs);
+        children.has_hull.push_back(!brief.hull.is_empty());
+        children.hull.add(brief.hull);
       }
     }
   } // --> unlock
@@ -1817,7 +2161,7 @@ status_t Layer_writer_impl::create_output_node(const Simple_node_data& node, Nod
     {
       // Project if necessary, then compute OBB and shift to new center:
       status = project_update_mesh_origin_and_obb(m_ctx->tracker(), m_layer_meta.type, *m_xform,
-        *legacy_mesh, ch_obbs, nio->legacy_desc.obb, nio->legacy_desc.mbs);
+        *legacy_mesh, children, hull, nio->legacy_desc.obb, nio->legacy_desc.mbs);
       if (status != IDS_I3S_OK)
         return status;
     }
@@ -1856,27 +2200,22 @@ status_t Layer_writer_impl::create_output_node(const Simple_node_data& node, Nod
         legacy_mesh->drop_colors();
     }
 
-    // "convert" to legacy:
-    _encode_geometry_to_legacy(*nio, *legacy_mesh_buffer);
-
-    if (m_layer_meta.type == Layer_type::Point)
+    bool is_cache_optimized = false;
+    if (m_ctx->optimize_vertex_cache && legacy_mesh->get_topology() == i3s::Mesh_topology::Triangles)
     {
-      auto abs_points = legacy_mesh->get_absolute_positions();
-      auto& feature_ids = legacy_mesh->get_feature_ids();
-      int num = abs_points.size();
-      Point_feature_data_desc feature_data;
-      auto& points = feature_data.points;
-      points.resize(num);
-      for (int i = 0; i < num; ++i)
+      // Legacy geometry is de-indexed, so only its triangle order is kept. Draco's edgebreaker
+      // reorders faces, hence the sequential encoder below.
+      if (auto optimized = optimize_vertex_cache(*legacy_mesh))
       {
-        auto& desc = points[i];
-        desc.fid = feature_ids[i];
-        desc.position = abs_points[i];
+        legacy_mesh = optimized;
+        legacy_mesh_buffer = std::make_shared< Geometry_buffer_simple_impl>(optimized);
+        is_cache_optimized = true;
       }
-
-      nio->legacy_feature.feature_data.raw = utl::to_json(feature_data);
     }
-    
+
+    // "convert" to legacy:
+    _encode_geometry_to_legacy(*nio, *legacy_mesh_buffer);
+
     // This is deprecated.
     //nio->legacy_feature.geometry_data.raw = node.mesh.legacy_feature_data_geom_json;
 
@@ -1894,7 +2233,9 @@ status_t Layer_writer_impl::create_output_node(const Simple_node_data& node, Nod
 
       // create a Draco version for it:
       Has_fids has_fids = Has_fids::No;
-      if (!m_ctx->encode_to_draco(*legacy_mesh, &nio->draco_geom, has_fids, (double)scale.x, (double)scale.y))
+      const auto& encode_to_draco = is_cache_optimized && m_ctx->encode_to_draco_keep_face_order ?
+        m_ctx->encode_to_draco_keep_face_order : m_ctx->encode_to_draco;
+      if (!encode_to_draco(*legacy_mesh, &nio->draco_geom, has_fids, (double)scale.x, (double)scale.y))
       {
         // DRACO will fail on degenerated mesh ( all faces are degenerated)
         // need to add the node ID to help with error reporting.
@@ -2059,7 +2400,7 @@ status_t Layer_writer_impl::create_output_node(const Simple_node_data& node, Nod
         utl::log_warning(trk, IDS_I3S_EMPTY_LEAF_NODE, node_id);
         return IDS_I3S_EMPTY_LEAF_NODE;
       }
-      compute_obb(*m_xform, ch_obbs, nio->legacy_desc.obb, nio->legacy_desc.mbs);
+      compute_obb(*m_xform, children, hull, nio->legacy_desc.obb, nio->legacy_desc.mbs);
     }
 
     nio->desc.obb = nio->legacy_desc.obb;
@@ -2074,6 +2415,7 @@ status_t Layer_writer_impl::create_output_node(const Simple_node_data& node, Nod
 
   brief.level = nio->legacy_desc.level;
   brief.node = std::move(nio);
+  brief.hull = std::move(hull);
   {
     utl::Lock_guard lk(m_mutex);
     m_working_set.emplace(node_id, std::move(brief));
@@ -2123,7 +2465,10 @@ status_t Layer_writer_impl::process_children(const Simple_node_data& node, Node_
     nio->desc.children.push_back(static_cast<decltype(nio->desc.children)::value_type>(ch_id));
     I3S_ASSERT_EXT(static_cast<decltype(nio->desc.children)::value_type>(ch_id) == ch_id);
     //connect the parent:
-    children_to_write.push_back(std::move(ch_node_brief.node));
+    if (ch_node_brief.node)
+      children_to_write.push_back(std::move(ch_node_brief.node));
+    else if (ch_node_brief.shard_parent_id != node_id)
+      return log_error_s(trk, IDS_I3S_INVALID_TREE_TOPOLOGY, ch_id); // shard root has been written for another parent.
   }
 
   if (nio->legacy_desc.obb.is_valid())
@@ -2183,13 +2528,8 @@ status_t Layer_writer_impl::_write_node( detail::Node_io& nio, Node_desc_v17* ma
 
 status_t Layer_writer_impl::_on_node_written(Node_desc_v17& desc, Node_desc_v17* maybe_parent)
 {
-  {
-    utl::Lock_guard lk(m_mutex_nodes17);
-
-    if (desc.index >= m_nodes17.size())
-      m_nodes17.resize(desc.index + 1);
-    m_nodes17[desc.index] = desc;
-  }
+  if (!m_nodes17.set(desc))
+    return log_error_s(m_ctx->tracker(), IDS_I3S_INVALID_TREE_TOPOLOGY, desc.index); // written twice
   return IDS_I3S_OK;
 }
 
@@ -2197,7 +2537,7 @@ status_t Layer_writer_impl::_save_paged_index(uint32_t root_id, std::map<int, in
 {
   auto trk = m_ctx->tracker();
 
-  I3S_ASSERT(root_id < m_nodes17.size());
+  I3S_ASSERT(m_nodes17.get(root_id));
   remap_geometry_ids(&geometry_ids, m_geometry_defs.data(), static_cast<int>(m_geometry_defs.size()));
 
   {
@@ -2207,8 +2547,7 @@ status_t Layer_writer_impl::_save_paged_index(uint32_t root_id, std::map<int, in
       if (found != geometry_ids.end())
         *inout = found->second;
     };
-    for (auto& n : m_nodes17)
-      update_geometry_id(&n.mesh.geometry.definition_id);
+    m_nodes17.for_each([&update_geometry_id](Node_desc_compact& n) { update_geometry_id(&n.mesh.geometry.definition_id); });
   }
 
   const std::string node_page_path = _layer_path("nodepages");
@@ -2468,6 +2807,8 @@ status_t Layer_writer_impl::save(utl::Boxd* extent /*= nullptr*/)
   }
 
   const auto found = std::cbegin(m_working_set);
+  if (!found->second.node)
+    return log_error_s(trk, IDS_I3S_INVALID_TREE_TOPOLOGY, found->first); // shard root(s) must have a parent.
   const auto root_id = found->second.node->desc.index;
 
   //save the root:
@@ -2517,7 +2858,8 @@ status_t Layer_writer_impl::save(utl::Boxd* extent /*= nullptr*/)
 
   if (m_layer_meta.type != Layer_type::Point)
   {
-    desc.store.geometry_schema = create_legacy_geometry_schema(m_vb_attribs_mask_legacy);
+    if (!_is_draco_only())
+      desc.store.geometry_schema = create_legacy_geometry_schema(m_vb_attribs_mask_legacy);
     desc.store.normal_reference_frame = m_layer_meta.normal_reference_frame;
     desc.store.profile = "meshpyramids";
     desc.store.resource_pattern = { "3dNodeIndexDocument", "SharedResource", "Geometry", "Attributes" }, // required but useless..
@@ -2594,7 +2936,8 @@ status_t Layer_writer_impl::save(utl::Boxd* extent /*= nullptr*/)
         udpated_vb_attribs &= ~(Attrib_flags)attrib_flag.at(0x01 << bit_number);
         return true;
       });
-    create_mesh_desc(udpated_vb_attribs, m_vb_attribs_mask_legacy, &draco_all_defs[i], (bool)m_ctx->encode_to_draco, desc.layer_type != Layer_type::Point);
+    create_mesh_desc(udpated_vb_attribs, m_vb_attribs_mask_legacy, &draco_all_defs[i], (bool)m_ctx->encode_to_draco
+      , desc.layer_type != Layer_type::Point && !_is_draco_only());
   }
 
   desc.geom_defs.resize(geometry_ids.size());
@@ -2631,7 +2974,7 @@ status_t Layer_writer_impl::save(utl::Boxd* extent /*= nullptr*/)
   for (int sid = 0; sid < m_attrib_metas.size(); ++sid)
     for (int i = 0; i < m_attrib_metas[sid].size(); ++i)
     {
-      if (m_attrib_metas[sid][i].stats)
+      if (m_attrib_metas[sid][i].stats || m_shard_stats.count({ sid, i }))
       {
         //create stats info entry:
         Statistics_href_desc shd;
@@ -2640,18 +2983,7 @@ status_t Layer_writer_impl::save(utl::Boxd* extent /*= nullptr*/)
         shd.key = "f_" + std::to_string(i);
         shd.name = m_attrib_metas[sid][i].def.meta.name;
         desc.statistics_info.push_back(shd);
-        std::string json_stats;
-        // stats for datetime attributes may have been updated
-        if (m_attrib_metas[sid][i].def.type == Type::Date_iso_8601 && m_ctx->decoder->datetime_meta)
-        {
-          utl::Attribute_stats_desc<utl::Atrb_stats_datetime<std::string> > stats;
-          m_datetime_stats[i].get_stats(&stats.stats);
-          json_stats = utl::to_json(stats);
-        }
-        else
-        {
-          json_stats = m_attrib_metas[sid][i].stats->to_json();
-        }
+        auto json_stats = _get_stats_json(sid, i);
         auto st = save_json(trk, m_slpk.get(), json_stats, name, _layer_path("statistics"), m_gzip);
         if (st != IDS_I3S_OK)
           return st;
@@ -2688,6 +3020,204 @@ status_t Layer_writer_impl::save(utl::Boxd* extent /*= nullptr*/)
 }
 
 
+std::string Layer_writer_impl::_get_stats_json(Attrib_schema_id sid, Attrib_index idx)
+{
+  const auto& meta = m_attrib_metas[sid][idx];
+  // stats merged from shards, unless the caller has provided stats for the whole layer:
+  if (auto found = m_shard_stats.find({ sid, idx }); found != m_shard_stats.end() && !meta.stats)
+    return found->second.to_json();
+  // stats for datetime attributes may have been updated
+  if (meta.def.type == Type::Date_iso_8601 && m_ctx->decoder->datetime_meta)
+  {
+    utl::Attribute_stats_desc<utl::Atrb_stats_datetime<std::string> > stats;
+    m_datetime_stats[idx].get_stats(&stats.stats);
+    return utl::to_json(stats);
+  }
+  return meta.stats ? meta.stats->to_json() : std::string();
+}
+
+status_t Layer_writer_impl::save_shard(Node_id parent_id)
+{
+  auto trk = m_ctx->tracker();
+  if (m_working_set.empty())
+    return log_error_s(trk, IDS_I3S_INVALID_TREE_TOPOLOGY, m_working_set.size());
+
+  detail::Layer_shard_desc shard;
+
+  // --- write the subtree root(s) as children of parent_id:
+  for (auto& [id, brief] : m_working_set)
+  {
+    if (!brief.node || !brief.envelope.has_value())
+      return log_error_s(trk, IDS_I3S_INVALID_TREE_TOPOLOGY, id);
+
+    detail::Node_io parent;
+    parent.legacy_desc.id = brief.level == 1 ? "root" : std::to_string(parent_id);
+    brief.node->set_parent(parent);
+    if (auto status = _write_node(*brief.node, nullptr); status != IDS_I3S_OK)
+      return status;
+
+    detail::Shard_root_desc root;
+    root.id = static_cast<uint32_t>(id);
+    root.parent_id = static_cast<uint32_t>(parent_id);
+    root.level = brief.level;
+    root.obb = brief.obb;
+    root.mbs = brief.mbs;
+    root.envelope_min = utl::Vec3d(brief.envelope->left(), brief.envelope->bottom(), brief.envelope->front());
+    root.envelope_max = utl::Vec3d(brief.envelope->right(), brief.envelope->top(), brief.envelope->back());
+    shard.roots.push_back(root);
+  }
+  m_working_set.clear();
+
+  // --- everything needed to write the node pages and the layer documents later on:
+  m_nodes17.for_each([this, &shard](const Node_desc_compact& n)
+  {
+    shard.nodes.emplace_back();
+    m_nodes17.get(n, &shard.nodes.back());
+  });
+  shard.material_defs = m_mat_helper.get_material_defs();
+  for (const auto& def : m_mat_helper.get_texture_defs())
+  {
+    detail::Shard_texture_set_desc tex_def;
+    for (const auto& f : def.formats)
+      tex_def.formats |= static_cast<Image_formats>(f.format);
+    tex_def.is_atlas = def.is_atlas;
+    tex_def.sem = static_cast<int>(def.sem);
+    shard.tex_defs.push_back(tex_def);
+  }
+  for (const auto& count : m_geometry_defs)
+    shard.geometry_def_counts.push_back(count);
+  shard.vb_attribs = m_vb_attribs;
+  shard.vb_attribs_mask_legacy = m_vb_attribs_mask_legacy;
+  for (int sid = 0; sid < m_attrib_metas.size(); ++sid)
+    for (int i = 0; i < m_attrib_metas[sid].size(); ++i)
+    {
+      auto json_stats = _get_stats_json(sid, i);
+      if (json_stats.size())
+        shard.stats.push_back({ sid, i, std::move(json_stats) });
+    }
+
+  const auto json = utl::to_json(shard);
+  if (!m_slpk->append_file(_layer_path(detail::c_shard_desc_path), json.data(), static_cast<int>(json.size()), utl::Mime_type::Json))
+    return log_error_s(trk, IDS_I3S_IO_WRITE_FAILED, "SLPK://" + _layer_path(detail::c_shard_desc_path));
+
+  if (m_ctx->finalization_mode == Writer_finalization_mode::Finalize_output_stream)
+  {
+    if (!m_slpk->finalize())
+      return log_error_s(trk, IDS_I3S_IO_WRITE_FAILED, std::string("output SLPK"));
+  }
+  return IDS_I3S_OK;
+}
+
+status_t Layer_writer_impl::add_shard(const std::filesystem::path& shard_path, Shard_resources res)
+{
+  auto trk = m_ctx->tracker();
+  auto shard_desc_path = _layer_path(detail::c_shard_desc_path);
+  utl::add_slpk_extension_to_path(&shard_desc_path, utl::Mime_type::Json, utl::Mime_encoding::Not_set);
+
+  auto merged_desc_path = _layer_path(detail::c_merged_shard_desc_folder + utl::to_string(shard_path.stem()));
+  utl::add_slpk_extension_to_path(&merged_desc_path, utl::Mime_type::Json, utl::Mime_encoding::Not_set);
+
+  detail::Layer_shard_desc shard;
+  std::string json;
+  if (res == Shard_resources::Append)
+  {
+    std::ifstream in(shard_path, std::ios::binary);
+    utl::detail::End_of_cd_64 eocd;
+    if (!in.good() || !utl::detail::read_end_of_cd_64(&in, &eocd))
+      return log_error_s(trk, IDS_I3S_IO_OPEN_FAILED, utl::to_string(shard_path));
+    if (!utl::detail::read_stored_file(&in, eocd, shard_desc_path, &json))
+      return log_error_s(trk, IDS_I3S_IO_NOT_FOUND, "SLPK://" + shard_desc_path);
+  }
+  else if (!m_slpk->get_existing_file(merged_desc_path, &json))
+  {
+    // the descriptor has been kept in the output by the add_shard() which appended the shard:
+    return log_error_s(trk, IDS_I3S_IO_NOT_FOUND, "SLPK://" + merged_desc_path);
+  }
+  if (!utl::from_json_safe(json, &shard, trk, shard_desc_path))
+    return IDS_I3S_JSON_PARSING_ERROR;
+
+  // --- resources are copied as-is, the descriptor is kept under a per-shard path:
+  if (res == Shard_resources::Append)
+  {
+    auto is_shard_desc = [&shard_desc_path](const std::string& path) { return path == shard_desc_path; };
+    if (!m_slpk->append_archive(shard_path, is_shard_desc))
+      return log_error_s(trk, IDS_I3S_IO_WRITE_FAILED, utl::to_string(shard_path));
+    if (!m_slpk->append_file(merged_desc_path, json.data(), static_cast<int>(json.size())))
+      return log_error_s(trk, IDS_I3S_IO_WRITE_FAILED, "SLPK://" + merged_desc_path);
+  }
+
+  // --- material and texture set definitions are re-indexed:
+  std::vector< int > tex_ids(shard.tex_defs.size());
+  for (size_t i = 0; i < tex_ids.size(); ++i)
+  {
+    const auto& def = shard.tex_defs[i];
+    tex_ids[i] = m_mat_helper.get_or_create_texture_set(def.formats, def.is_atlas, static_cast<Texture_semantic>(def.sem));
+  }
+  auto remap_tex = [&tex_ids](Material_texture_desc& tex)
+  {
+    if (tex.tex_def_id >= 0 && tex.tex_def_id < static_cast<int>(tex_ids.size()))
+      tex.tex_def_id = tex_ids[tex.tex_def_id];
+  };
+  std::vector< int > mat_ids(shard.material_defs.size());
+  for (size_t i = 0; i < mat_ids.size(); ++i)
+  {
+    auto& mat = shard.material_defs[i];
+    remap_tex(mat.normal_tex);
+    remap_tex(mat.occlusion_tex);
+    remap_tex(mat.emissive_tex);
+    remap_tex(mat.metal.base_color_tex);
+    remap_tex(mat.metal.metal_tex);
+    mat_ids[i] = m_mat_helper.get_or_create_material(mat);
+  }
+
+  // --- nodes:
+  for (auto& n : shard.nodes)
+  {
+    auto& mat_id = n.mesh.material.definition_id;
+    if (mat_id >= static_cast<int>(mat_ids.size()))
+      return log_error_s(trk, IDS_I3S_INVALID_TREE_TOPOLOGY, n.index);
+    if (mat_id >= 0)
+      mat_id = mat_ids[mat_id];
+    if (!m_nodes17.set(n))
+      return log_error_s(trk, IDS_I3S_INVALID_TREE_TOPOLOGY, n.index); // node ids must be unique across shards.
+  }
+  m_node_count += shard.nodes.size();
+  for (size_t i = 0; i < std::min(shard.geometry_def_counts.size(), m_geometry_defs.size()); ++i)
+    m_geometry_defs[i] += shard.geometry_def_counts[i];
+  m_vb_attribs |= shard.vb_attribs;
+  m_vb_attribs_mask_legacy |= shard.vb_attribs_mask_legacy;
+
+  // --- attribute statistics:
+  {
+    utl::Lock_guard lk(m_mutex_attr);
+    for (const auto& st : shard.stats)
+    {
+      auto& merged = m_shard_stats[{ st.sid, st.index }];
+      merged.type = _get_attrib_meta_nolock(st.sid, st.index).def.type;
+      if (!merged.merge(st.json, trk, shard_desc_path))
+        return IDS_I3S_JSON_PARSING_ERROR;
+    }
+  }
+
+  // --- shard root(s) are ready to be connected to their parent:
+  {
+    utl::Lock_guard lk(m_mutex);
+    for (const auto& root : shard.roots)
+    {
+      Node_brief brief;
+      brief.obb = root.obb;
+      brief.mbs = root.mbs;
+      brief.envelope = utl::Boxd(root.envelope_min, root.envelope_max);
+      brief.level = root.level;
+      brief.shard_parent_id = root.parent_id;
+      if (!m_working_set.emplace(root.id, std::move(brief)).second)
+        return log_error_s(trk, IDS_I3S_INVALID_TREE_TOPOLOGY, root.id);
+    }
+  } // -> unlock
+  return IDS_I3S_OK;
+}
+
+
 Layer_writer* create_mesh_layer_builder(Writer_context::Ptr ctx, const std::filesystem::path& path)
 {
   // Since create_mesh_layer_builder() accepts both filesystem paths and URIs
@@ -2695,7 +3225,12 @@ Layer_writer* create_mesh_layer_builder(Writer_context::Ptr ctx, const std::file
   // However, the existing API has already been adopted by clients.
   utl::Slpk_writer::Ptr slpk_writer(utl::create_slpk_writer(utl::to_string(path)));
 
-  if (slpk_writer && slpk_writer->create_archive(path))
+  const auto flags = ctx->write_behind_output ? 
+    utl::Slpk_writer::Create_flag::Write_behind : 
+    utl::Slpk_writer::Create_flag::Overwrite_if_exists_and_cancel_in_destructor;
+  if (slpk_writer)
+    slpk_writer->set_write_behind_params(get_write_behind_params(*ctx));
+  if (slpk_writer && slpk_writer->create_archive(path, flags))
     return new Layer_writer_impl(slpk_writer, ctx);
 
   utl::log_error(ctx->tracker(), IDS_I3S_IO_OPEN_FAILED, path);
@@ -2707,6 +3242,22 @@ Layer_writer* create_mesh_layer_builder(Writer_context::Ptr ctx, utl::Slpk_write
   return (writer ? new Layer_writer_impl(writer, ctx, sublayer_id) : nullptr);
 }
 
+Layer_writer* create_mesh_layer_updater(Writer_context::Ptr ctx, const std::filesystem::path& path)
+{
+  utl::Slpk_writer::Ptr slpk_writer(utl::create_slpk_writer(utl::to_string(path)));
+
+  utl::Slpk_writer::Create_flags flags = utl::Slpk_writer::Create_flag::Update_existing;
+  if (ctx->write_behind_output)
+    flags |= utl::Slpk_writer::Create_flag::Write_behind;
+  if (slpk_writer)
+    slpk_writer->set_write_behind_params(get_write_behind_params(*ctx));
+  if (slpk_writer && slpk_writer->create_archive(path, flags))
+    return new Layer_writer_impl(slpk_writer, ctx);
+
+  utl::log_error(ctx->tracker(), IDS_I3S_IO_OPEN_FAILED, path);
+  return nullptr;
+}
+
 bool  create_texture_from_image(int width, int height, int channel_count, const char* data, Texture_buffer& out)
 {
   I3S_ASSERT(channel_count == 3 || channel_count == 4);
@@ -2727,24 +3278,11 @@ bool  create_texture_from_image(int width, int height, int channel_count, const
 }
 
 
-// More of wrapper around  Mesh_abstract::Ptr. Maybe Geometry_buffer needs refactoring. 
-class Geometry_buffer_simple_impl : public Geometry_buffer
-{
-public:
-  explicit Geometry_buffer_simple_impl(Mesh_abstract::Ptr m) : m_mesh(m) {}
-  // --- Geometry_buffer:
-  virtual Mesh_abstract::Ptr        get_mesh() const override { return m_mesh; }
-  virtual Geometry_format           get_format() const override { return Geometry_format::Legacy; } //not completly true. TBD
-  virtual utl::Raw_buffer_view      to_legacy_buffer(Attrib_flags* actualy_written_attrib) const override { return encode_legacy_buffer(*m_mesh, actualy_written_attrib); }
-  virtual Modification_state        get_modification_state() const override { return Modification_state(); };
-private:
-  Mesh_abstract::Ptr m_mesh;
-};
-
 
 //! Create Mesh_data from src mesh description. Vertex data will be deep-copied, but Texture_buffer will be shallow-copied.
 status_t  Layer_writer_impl::create_mesh_from_raw(const Simple_raw_mesh& src, Mesh_data& dst) const
 {
+  utl::Buffer_arena_scope arena_scope(get_buffer_arena(*m_ctx));
   I3S_ASSERT(src.abs_xyz && src.vertex_count);
 
   if (src.index_count == 0)
@@ -2848,6 +3386,7 @@ void create_mesh_from_raw_and_origin(const Simple_raw_points& src, const utl::Ve
 status_t Layer_writer_impl::create_mesh_from_raw(const Simple_raw_points& src, Mesh_data& dst) const
 {
   I3S_ASSERT(src.abs_xyz && src.count);
+  utl::Buffer_arena_scope arena_scope(get_buffer_arena(*m_ctx));
 
   utl::Obb_abs obb;
   utl::Vec4d mbs;
@@ -2858,6 +3397,177 @@ status_t Layer_writer_impl::create_mesh_from_raw(const Simple_raw_points& src, M
   return IDS_I3S_OK;
 }
 
+static bool is_same_material(const Material_data_multitex& a, const Material_data_multitex& b)
+{
+  for (size_t sem = 0; sem < a.texs.size(); ++sem)
+  {
+    if (a.texs[sem].size() != b.texs[sem].size())
+      return false;
+    for (size_t i = 0; i < a.texs[sem].size(); ++i)
+    {
+      if (a.texs[sem][i].data.data() != b.texs[sem][i].data.data())
+        return false;
+    }
+  }
+  return true;
+}
+
+To_cartesian_fct Layer_writer_impl::_get_to_cartesian() const
+{
+  if (!m_xform)
+    return nullptr;
+
+  auto xform = m_xform;
+  return [xform](utl::Vec3d* xyz, int count)
+  {
+    return xform->transform(Spatial_reference_xform::Sr_type::Src_sr, Spatial_reference_xform::Sr_type::Src_cartesian, xyz, count)
+      != Spatial_reference_xform::Status_t::Failed;
+  };
+}
+
+status_t Layer_writer_impl::create_simplified_mesh(const Mesh_data& src, const Mesh_simplification_params& params, Mesh_data& dst) const
+{
+  utl::Buffer_arena_scope arena_scope(get_buffer_arena(*m_ctx));
+  if (src.geometries.empty() || !src.geometries.front())
+    return IDS_I3S_DEGENERATED_MESH;
+
+  auto mesh = src.geometries.front()->get_mesh();
+  if (!mesh)
+    return IDS_I3S_DEGENERATED_MESH;
+
+  auto simplified = simplify_mesh(*mesh, params, _get_to_cartesian());
+  if (!simplified)
+    return IDS_I3S_DEGENERATED_MESH;
+
+  dst.material = src.material;
+  dst.attribs = src.attribs;
+  dst.geometries = { std::make_shared< Geometry_buffer_simple_impl>(simplified) };
+  return IDS_I3S_OK;
+}
+
+status_t Layer_writer_impl::create_parent_mesh(
+  const std::vector<const Mesh_data*>& children,
+  double lod_threshold,
+  Mesh_data& dst,
+  double screen_area_per_triangle,
+  int thread_count,
+  const Texture_atlas_params& atlas_params) const
+{
+  utl::Buffer_arena_scope arena_scope(get_buffer_arena(*m_ctx));
+  std::vector<Mesh_abstract::Ptr> meshes;
+  std::vector<const Mesh_data*> sources;
+  bool is_shared_material = true;
+  for (auto child : children)
+  {
+    if (!child || child->geometries.empty() || !child->geometries.front())
+      continue; // empty node.
+
+    auto mesh = child->geometries.front()->get_mesh();
+    if (!mesh || mesh->get_vertex_count() == 0)
+      continue;
+
+    is_shared_material = is_shared_material && (sources.empty() || is_same_material(sources.front()->material, child->material));
+    sources.push_back(child);
+    meshes.push_back(mesh);
+  }
+  if (meshes.empty())
+    return IDS_I3S_EMPTY_LEAF_NODE;
+
+  const auto* first = sources.front();
+  Texture_buffer atlas;
+  if (!is_shared_material)
+  {
+    if (auto st = _remap_to_atlas(sources, atlas_params, meshes, atlas); st != IDS_I3S_OK)
+      return st;
+  }
+
+  std::vector<const Mesh_abstract*> srcs;
+  for (const auto& mesh : meshes)
+    srcs.push_back(mesh.get());
+
+  auto merged = merge_meshes(srcs, meshes.front()->get_origin());
+  if (!merged)
+    return IDS_I3S_DEGENERATED_MESH;
+
+  Mesh_simplification_params params;
+  params.target_face_count = std::max(1, static_cast<int>(lod_threshold / screen_area_per_triangle));
+  params.thread_count = thread_count;
+  auto simplified = simplify_mesh(*merged, params, _get_to_cartesian());
+  if (!simplified)
+    return IDS_I3S_DEGENERATED_MESH;
+
+  dst = Mesh_data();
+  if (is_shared_material)
+    dst.material = first->material;
+  else
+  {
+    dst.material.properties = first->material.properties;
+    dst.material.metallic_roughness = first->material.metallic_roughness;
+    dst.material.add_texture(atlas, Texture_semantic::Base_color);
+  }
+  dst.geometries = { std::make_shared< Geometry_buffer_simple_impl>(simplified) };
+  return IDS_I3S_OK;
+}
+
+status_t Layer_writer_impl::_remap_to_atlas(
+  const std::vector<const Mesh_data*>& children,
+  const Texture_atlas_params& atlas_params,
+  std::vector<Mesh_abstract::Ptr>& meshes,
+  Texture_buffer& atlas) const
+{
+  if (!m_ctx->decoder)
+    return IDS_I3S_INTERNAL_ERROR;
+
+  const std::string c_res_id("atlas");
+
+  // Only base color textures are packed. Children sharing a texture share its area in the atlas:
+  std::vector<Texture_buffer> imgs;
+  std::vector<const char*> img_keys;
+  std::vector<size_t> img_of_child(children.size());
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    const auto& mat = children[i]->material;
+    for (int sem = 0; sem < (int)Texture_semantic::_count; ++sem)
+    {
+      if (sem != (int)Texture_semantic::Base_color && mat.has_texture(static_cast<Texture_semantic>(sem)))
+        return IDS_I3S_EXPECTS;
+    }
+    const auto& tex_set = mat.texs[(int)Texture_semantic::Base_color];
+    if (tex_set.empty() || !is_set(meshes[i]->get_available_attrib_mask(), Attrib_flag::Uv0))
+      return IDS_I3S_EXPECTS;
+
+    const auto* key = tex_set.front().data.data();
+    auto found = std::find(img_keys.begin(), img_keys.end(), key);
+    img_of_child[i] = std::distance(img_keys.begin(), found);
+    if (found != img_keys.end())
+      continue;
+
+    Texture_buffer raw_img;
+    if (auto st = get_raw_texture(*m_ctx, tex_set, c_res_id, raw_img); st != IDS_I3S_OK)
+      return st;
+    img_keys.push_back(key);
+    imgs.push_back(raw_img);
+  }
+
+  Texture_atlas_params params = atlas_params;
+  params.max_size = std::min(params.max_size, static_cast<int>(m_ctx->decoder->m_prop.max_write_texture_size));
+  std::vector<Atlas_rect> rects;
+  if (!build_texture_atlas(imgs, params, &atlas, &rects))
+    return IDS_I3S_IMAGE_TOO_LARGE;
+
+  // UVs are made absolute in the atlas, unless some are repeated ( or already in an atlas ), in which case all meshes get regions:
+  const bool use_regions = std::any_of(meshes.begin(), meshes.end(), [](const Mesh_abstract::Ptr& mesh) { return needs_uv_regions(*mesh); });
+  atlas.meta.is_atlas = use_regions;
+  const utl::Vec2i atlas_size(atlas.width(), atlas.height());
+  for (size_t i = 0; i < meshes.size(); ++i)
+  {
+    meshes[i] = remap_to_atlas(*meshes[i], rects[img_of_child[i]], atlas_size, use_regions);
+    if (!meshes[i])
+      return IDS_I3S_DEGENERATED_MESH;
+  }
+  return IDS_I3S_OK;
+}
+
 
 size_t Layer_writer_impl::_get_page_size() const
 {
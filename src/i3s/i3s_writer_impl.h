@@ -25,10 +25,16 @@ email: contracts@esri.com
 #include "utils/utl_prohull.h"
 #include "utils/utl_box.h"
 #include <map>
+#include <array>
 #include <atomic>
 #include <mutex>
 #include <memory>
+#include <shared_mutex>
+#include <unordered_map>
 #include "i3s/i3s_index_dom.h"
+#include "i3s/i3s_node_store.h"
+#include "i3s/i3s_mesh_simplifier.h"
+#include "i3s/i3s_texture_atlas.h"
 #include "utils/utl_basic_tracker_api.h" //TBD
 #include "utils/utl_stats.h"
 
@@ -50,22 +56,50 @@ class Stats_attribute;
 
 namespace detail
 {
+//! Material and texture set definitions of a layer. Ids are indices in the definition arrays.
+//! Definitions are found by content hash in sharded maps: lookups only take a shared lock of their shard.
 class Material_helper
 {
 public:
   int     get_or_create_texture_set(Image_formats f, bool is_atlas, Texture_semantic sem);
   int     get_or_create_material(const Material_desc& data);
+  //! Not synchronized with get_or_create_*(): the definitions are read once all nodes are created.
   const std::vector< Texture_definition_desc >& get_texture_defs() const { return m_tex_def; }
   const std::vector< Material_desc >& get_material_defs() const { return m_mat_def; }
   std::vector< std::string >                          get_legacy_texture_mime_types() const;
 
 private:
-  std::vector< Material_desc > m_mat_def;
+  struct Material_hash { size_t operator()(const Material_desc& mat) const noexcept; };
+  struct Texture_set_hash { size_t operator()(uint64_t key) const noexcept; };
+  template< class Key, class Hash > struct Shard
+  {
+    std::shared_mutex                     mutex;
+    std::unordered_map< Key, int, Hash >  ids;
+  };
+  static constexpr int c_shard_bits = 4;
+  template< class Key, class Hash > using Shards = std::array< Shard< Key, Hash >, 1 << c_shard_bits >;
+  template< class Key, class Hash, class Create >
+  int     _get_or_create(Shards< Key, Hash >& shards, const Key& key, Create&& create);
+
+  Shards< Material_desc, Material_hash >  m_mat_shards;
+  Shards< uint64_t, Texture_set_hash >    m_tex_shards;
+  std::vector< Material_desc >           m_mat_def;
   std::vector< Texture_definition_desc > m_tex_def;
-  std::mutex                             m_mutex;
+  std::mutex                             m_mutex; // synchronizes the insertions in m_mat_def and m_tex_def
 };
 
 struct Node_io;
+
+//! Statistics of an attribute merged from all the shards of a layer.
+struct Merged_attribute_stats
+{
+  Type type = Type::Not_set;
+  utl::Attribute_stats_desc< utl::Atrb_stats > numeric;
+  utl::Attribute_stats_desc< utl::Atrb_stats_string< std::string > > string;
+  utl::Attribute_stats_desc< utl::Atrb_stats_datetime< std::string > > datetime;
+  bool merge(const std::string& json, utl::Basic_tracker* trk, const std::string& ref);
+  std::string to_json() const;
+};
 }
 
 class Layer_writer_impl final : public Layer_writer
@@ -99,19 +133,38 @@ public:
   virtual status_t   create_node(const Simple_node_data& mesh, Node_id id) override;
   [[nodiscard]]
   virtual status_t   save(utl::Boxd* extent = nullptr) override;
+  [[nodiscard]]
+  virtual status_t   save_shard(Node_id parent_id) override;
+  [[nodiscard]]
+  virtual status_t   add_shard(const std::filesystem::path& shard_path, Shard_resources res = Shard_resources::Append) override;
   virtual status_t   create_mesh_from_raw(const Simple_raw_mesh& src, Mesh_data& dst) const override;
   virtual status_t   create_mesh_from_raw(const Simple_raw_points& src, Mesh_data& dst) const override;
+  virtual status_t   create_simplified_mesh(const Mesh_data& src, const Mesh_simplification_params& params, Mesh_data& dst) const override;
+  virtual status_t   create_parent_mesh(
+    const std::vector<const Mesh_data*>& children,
+    double lod_threshold,
+    Mesh_data& dst,
+    double screen_area_per_triangle = c_default_screen_area_per_triangle,
+    int thread_count = 0,
+    const Texture_atlas_params& atlas_params = Texture_atlas_params()) const override;
   Spatial_reference_xform::cptr get_xform() const { return m_xform; }
 private:
   [[nodiscard]]
   status_t              _write_node(detail::Node_io& d, Node_desc_v17* maybe_parent);
   size_t        _get_page_size() const;
+  // Conversion of source positions to the cartesian frame the simplification error is measured in.
+  To_cartesian_fct      _get_to_cartesian() const;
+  // Packs the base color textures of children in atlas and remaps the UVs of their meshes to it.
+  status_t              _remap_to_atlas(const std::vector<const Mesh_data*>& children, const Texture_atlas_params& atlas_params,
+                                        std::vector<Mesh_abstract::Ptr>& meshes, Texture_buffer& atlas) const;
   // This method is called when a node has been written, with the guarantee that
   // calls corresponding to sibling nodes will be done in the same thread, and are contiguous in time.
   status_t      _on_node_written(Node_desc_v17&, Node_desc_v17* maybe_parent);
   [[nodiscard]]
   status_t      _save_paged_index(uint32_t root_index, std::map<int, int>& geometry_ids_mapping);
+  bool                  _is_draco_only() const;
   void                  _encode_geometry_to_legacy(detail::Node_io& nio, const Geometry_buffer& src);
+  std::string           _get_stats_json(Attrib_schema_id sid, Attrib_index idx);
 protected:
   std::string           _layer_path(const std::string& resource = std::string()) const;
 
@@ -127,7 +180,9 @@ protected:
     utl::Vec4d  mbs;
     std::optional<utl::Boxd> envelope;  // empty leaf nodes don't have an envelope.
     int level = -1; //so we can identify the root.
-    std::unique_ptr<detail::Node_io> node;
+    std::unique_ptr<detail::Node_io> node; // null if node has already been written by a shard ( see add_shard() )
+    Node_id shard_parent_id = c_invalid_id; // parent the shard root has been written for.
+    utl::Pro_hull hull; // hull of the geometry of the subtree ( destination cartesian space ). Empty if the OBB is not computed by the writer.
   };
   std::map< Node_id, Node_brief > m_working_set;
 
@@ -143,6 +198,7 @@ protected:
   Attrb_info& _get_attrib_meta_nolock(Attrib_schema_id sid, Attrib_index idx);
 
   std::map<int, utl::Histo_datetime<std::string> > m_datetime_stats;
+  std::map< std::pair<Attrib_schema_id, Attrib_index>, detail::Merged_attribute_stats > m_shard_stats; // merged from shards ( see add_shard() )
   std::array<std::atomic<int>, c_count_geometry_defs> m_geometry_defs{ {{0}, {0}, {0}, {0}, {0}, {0}, {0}, {0}} };
   std::atomic<size_t> m_node_count = 0;
 
@@ -153,8 +209,7 @@ protected:
 
   Gzip_context m_gzip;
 
-  std::mutex                   m_mutex_nodes17;  // synchronizes accesses to m_nodes17
-  std::vector< Node_desc_v17 > m_nodes17; // implicitely indexed by Node_id
+  Node_desc_store              m_nodes17; // implicitely indexed by Node_id
 
   static bool remap_geometry_ids(std::map<int, int>* out, const std::atomic<int>* geometry_ids, int size);
 };
@@ -197,5 +252,15 @@ inline bool from_dst_cartesian(const Spatial_reference_xform& xform, utl::Vec3d*
     == Spatial_reference_xform::Status_t::Ok;
 }
 
+inline utl::Output_stream_async_params get_write_behind_params(const Writer_context& ctx)
+{
+  utl::Output_stream_async_params params;
+  params.block_size = ctx.write_behind_block_size;
+  params.block_count = ctx.write_behind_block_count;
+  params.direct_io = ctx.write_behind_direct_io;
+  params.sync_every_n_blocks = ctx.write_behind_sync_every_n_blocks;
+  return params;
+}
+
 } // namespace i3s
 } // namespace i3slib
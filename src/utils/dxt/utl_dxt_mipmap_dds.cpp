@@ -20,6 +20,7 @@ email: contracts@esri.com
 #include "utils/dxt/utl_dxt_mipmap_dds.h"
 #include "utils/utl_jpeg.h"
 #include "utils/utl_bitstream.h"
+#include "utils/utl_colors.h"
 #include "IntelDXTCompressor.h"
 #include "dds.h"
 #include "utils/utl_fs.h"
@@ -201,6 +202,9 @@ bool    convert_to_dds_with_mips(const std::string& jpeg, utl::Buffer_view<char>
 
   //wrap into an image:
   Image_2d src = Image_2d::wrap_aligned(w, h, raw_data.data(), raw_data.size());
+  // The decoder reports an alpha channel, not whether it is used:
+  if (has_alpha)
+    has_alpha = get_alpha_bits(static_cast<const Rgba8*>(src.data()), (size_t)w * h) != 0;
   return compress_to_dds_with_mips(src, has_alpha, dds_out);
 }
 
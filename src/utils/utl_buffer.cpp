@@ -48,6 +48,11 @@ Buffer::Buffer(const char* ptr, int size, Memory mem, int align)
 {
   I3S_ASSERT_EXT(align >= 0);
 
+  if (mem == Memory::Arena)
+  {
+    I3S_ASSERT(false); // only Buffer_arena creates arena buffers.
+    m_mode = mem = Memory::Deep;
+  }
   if (mem == Memory::Deep)
   {
     m_rw_ptr = new char[size];
@@ -75,6 +80,7 @@ Buffer::Buffer(const char* ptr, int size, Memory mem, int align)
 
 Buffer::~Buffer()
 {
+  // Arena memory is released with its chunk.
   if (m_mode == Memory::Deep)
     delete[] m_rw_ptr;
   else if (m_mode == Memory::Deep_aligned)
@@ -85,7 +91,7 @@ Buffer::~Buffer()
 Buffer::Ptr  Buffer::deep_copy() const
 {
   I3S_ASSERT_EXT(m_mode != Memory::Deep_aligned); //not supported. 
-  return std::make_shared< Buffer >(m_read_ptr, m_size, m_mode);
+  return std::make_shared< Buffer >(m_read_ptr, m_size, m_mode == Memory::Arena ? Memory::Deep : m_mode);
 }
 
 
@@ -97,11 +103,149 @@ Raw_buffer_view Buffer::create_shallow_view(const char* data, int bytes)
 
 Buffer_view<char> Buffer::create_writable_view(const char* data, int bytes)
 {
-  auto buff = std::make_shared< Buffer >(data, bytes, Memory::Deep);
+  auto buff = _create(bytes);
+  if (data)
+    std::memcpy(buff->m_rw_ptr, data, bytes);
   return Buffer_view<char>(buff, buff->m_rw_ptr, bytes);
 }
 
 
+// --------------------------------------------------------------------
+// class      Buffer_arena
+// --------------------------------------------------------------------
+namespace
+{
+
+thread_local Buffer_arena* t_current_arena = nullptr;
+
+// Same as new char[] on 64-bit platforms:
+constexpr size_t c_arena_alignment = 16;
+// Room left in a chunk for the shared_ptr control block ( and Buffer ) of its buffers:
+constexpr size_t c_control_block_reserve = 256;
+
+size_t align_up(size_t size, size_t alignment)
+{
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+}
+
+namespace detail
+{
+
+struct Buffer_arena_chunk
+{
+  explicit Buffer_arena_chunk(size_t size) : data(new char[size]), size(size) {}
+
+  // Returns nullptr if the chunk is full.
+  char* allocate(size_t bytes, size_t alignment)
+  {
+    const auto offset = align_up(used, alignment);
+    if (offset + bytes > size)
+      return nullptr;
+    used = offset + bytes;
+    return data.get() + offset;
+  }
+  bool contains(const void* p) const { return p >= data.get() && p < data.get() + size; }
+
+  std::unique_ptr< char[] > data;
+  size_t size;
+  size_t used = 0;
+};
+
+}
+
+namespace
+{
+
+//! Allocates the shared_ptr control blocks in a chunk ( and keeps it alive ). Deallocation is a no-op, except if the
+//! chunk was full ( heap fallback ).
+template< class T >
+struct Chunk_allocator
+{
+  using value_type = T;
+  explicit Chunk_allocator(std::shared_ptr< detail::Buffer_arena_chunk > c) : chunk(std::move(c)) {}
+  template< class U > Chunk_allocator(const Chunk_allocator<U>& src) : chunk(src.chunk) {}
+
+  T* allocate(size_t n)
+  {
+    if (auto p = chunk->allocate(n * sizeof(T), alignof(T)))
+      return reinterpret_cast<T*>(p);
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+  void deallocate(T* p, size_t)
+  {
+    if (!chunk->contains(p))
+      ::operator delete(p);
+  }
+  template< class U > bool operator==(const Chunk_allocator<U>& b) const { return chunk == b.chunk; }
+  template< class U > bool operator!=(const Chunk_allocator<U>& b) const { return chunk != b.chunk; }
+
+  std::shared_ptr< detail::Buffer_arena_chunk > chunk;
+};
+
+}
+
+Buffer_arena::Buffer_arena(int chunk_size)
+  : m_chunk_size(chunk_size)
+{
+  I3S_ASSERT_EXT(chunk_size > 0);
+}
+
+Buffer_arena::~Buffer_arena()
+{
+  I3S_ASSERT(t_current_arena != this); // scope must be closed first
+}
+
+Buffer::Ptr Buffer_arena::_create_buffer(int size_in_bytes)
+{
+  const auto size = align_up(static_cast<size_t>(std::max(size_in_bytes, 0)), c_arena_alignment);
+  std::shared_ptr< detail::Buffer_arena_chunk > chunk;
+  if (size > static_cast<size_t>(m_chunk_size) / 4)
+  {
+    // dedicated chunk, the current one stays:
+    chunk = std::make_shared< detail::Buffer_arena_chunk >(size + c_control_block_reserve);
+    ++m_chunk_count;
+  }
+  else
+  {
+    if (!m_chunk || m_chunk->size - m_chunk->used < size + c_control_block_reserve + c_arena_alignment)
+    {
+      m_chunk = std::make_shared< detail::Buffer_arena_chunk >(static_cast<size_t>(m_chunk_size));
+      ++m_chunk_count;
+    }
+    chunk = m_chunk;
+  }
+  ++m_allocation_count;
+
+  char* data = chunk->allocate(size, c_arena_alignment);
+  I3S_ASSERT(data);
+  auto buff = std::allocate_shared< Buffer >(Chunk_allocator< Buffer >(std::move(chunk)));
+  buff->m_rw_ptr = data;
+  buff->m_size = size_in_bytes;
+  buff->m_mode = Buffer::Memory::Arena;
+  return buff;
+}
+
+Buffer_arena_scope::Buffer_arena_scope(Buffer_arena* arena)
+  : m_previous(t_current_arena)
+{
+  if (arena)
+    t_current_arena = arena;
+}
+
+Buffer_arena_scope::~Buffer_arena_scope()
+{
+  t_current_arena = m_previous;
+}
+
+Buffer::Ptr Buffer::_create(int size_in_bytes)
+{
+  if (t_current_arena)
+    return t_current_arena->_create_buffer(size_in_bytes);
+  return std::make_shared< Buffer >(size_in_bytes);
+}
+
 Raw_buffer_view Buffer::create_view(int count, int offset) const
 {
   if (count <= 0)
@@ -19,6 +19,7 @@ email: contracts@esri.com
 
 #include "pch.h"
 #include <algorithm>
+#include <array>
 #include <numeric>
 #include <vector>
 #include <memory>
@@ -100,6 +101,23 @@ namespace utl
   // Projection Set methods
   //--------------------------------------------------------------------------------------------------------------------
 
+  // independent triples of the projection directions ( see Pro_hull::get_slab_vertices() )
+  static void init_triples(Pro_set& set) {
+    const double c_eps = 1e-6;          // minimal sine of the angles of 3 directions
+    set.triples.clear();
+    for (int i = 0; i < set.base_vector_size; i++) {
+      for (int j = i + 1; j < set.base_vector_size; j++) {
+        for (int k = j + 1; k < set.base_vector_size; k++) {
+          const auto& dir_i = set.dir[i], &dir_j = set.dir[j], &dir_k = set.dir[k];
+          const auto det = dir_i.dot(Vec3d::cross(dir_j, dir_k));
+          if (std::abs(det) < c_eps * dir_i.length() * dir_j.length() * dir_k.length())
+            continue;   // ( almost ) coplanar directions
+          set.triples.push_back({ i, j, k, Vec3d::cross(dir_j, dir_k) * (1.0 / det), Vec3d::cross(dir_k, dir_i) * (1.0 / det), Vec3d::cross(dir_i, dir_j) * (1.0 / det) });
+        }
+      }
+    }
+  }
+
   Pro_set::Pro_set() {
 
     base_vector_size = c_base_vector_size;           
@@ -188,6 +206,8 @@ namespace utl
     obb[19] = Vec3i(1, 31, 32);
     obb[20] = Vec3i(0, 33, 34);
     obb[21] = Vec3i(0, 35, 36);
+
+    init_triples(*this);
   }
 
   Pro_set::Pro_set( Polyhedron base) {
@@ -408,6 +428,8 @@ where f = (1 + √5) / 2 is the golden ratio
 
     //normalize all base direction vectors 
     for (int i = 0; i < base_vector_size; i++)  dir[i] = dir[i].normalized();
+
+    init_triples(*this);
   }
 
   const Pro_set* Pro_set::get_default()
@@ -447,6 +469,22 @@ where f = (1 + √5) / 2 is the golden ratio
     std::fill(m_provertex.begin(), m_provertex.end(), Vec3d{});
   }
 
+  bool Pro_hull::is_empty() const
+  {
+    return m_promin[0] > m_promax[0];
+  }
+
+  void Pro_hull::translate(const Vec3d& offset)
+  {
+    for (int i = 0; i < m_base->base_vector_size; i++) {
+      const auto proj = offset.dot(m_base->dir[i]);
+      m_promin[i] += proj;
+      m_promax[i] += proj;
+    }
+    for (auto& vertex : m_provertex)
+      vertex += offset;
+  }
+
   double Pro_hull::center(int dir) const {                  // middle value of projection for a direction
     return 0.5 * (m_promax[dir] + m_promin[dir]);
   }
@@ -900,7 +938,7 @@ where f = (1 + √5) / 2 is the golden ratio
     }
   }
 
-  double Pro_hull::get_metrics(Method method, Vec3d&  extent) {
+  double Pro_hull::get_metrics(Method method, const Vec3d& extent) {
 
     switch (method)
     {
@@ -977,27 +1015,9 @@ where f = (1 + √5) / 2 is the golden ratio
 
 
   //---------------------------------------------------------------------------------------------------------------
-  // calculate a ballbox for a convexoid -  a combination of OBB and BS
+  // find OBB axes for a convexoid: the best fit OBB aligned with one of its faces
 
-  void Pro_hull::get_ball_box(const Vec3d* points, int count
-    , Obb_abs& obb, double& radius, Method method) {
-    I3S_ASSERT(count > 0);
-    if (count == 0)
-    {
-      obb.center = Vec3d(0.0);
-      obb.orientation = utl::identity_quaternion<double>();
-      obb.extents = Vec3f(std::numeric_limits<float>::max());
-      return;
-    }
-
-    auto origin = std::accumulate(points + 1, points + count, points[0]) * (1.0 / count) ;
-    // reset the Pro_hull
-    std::fill(m_promin.begin(), m_promin.end(), std::numeric_limits<double>::max());
-    std::fill(m_promax.begin(), m_promax.end(), std::numeric_limits<double>::lowest());
-
-    // accumulate relative positions of all of the remaining points
-    for (int i = 0; i < count; i++) 
-      add(points[i] - origin);    // insert points into a convexoid
+  void Pro_hull::get_obb_axes(Method method, Vec3d obb_axis[3]) {
 
     Vec3d min_p, max_p; 
 //    double size_x, size_y, size_z;
@@ -1005,7 +1025,6 @@ where f = (1 + √5) / 2 is the golden ratio
     Vec3d min_point, max_point, extent; 
     Vec3d min_point2, max_point2;
     Vec3d axis2_x, axis2_y;         // 2D OBB axes
-    Vec3d obb_axis[3];              // OBB axes
     std::vector<Vec3d> fold(16);    // fixed 16 vertex convexoid projection fold
 
     // init as AABB..  it will be used if convexoid degraded into a point
@@ -1022,7 +1041,7 @@ where f = (1 + √5) / 2 is the golden ratio
         obb_axis[0] = m_provertex[roll] - m_provertex[0];
         obb_axis[1] = (obb_axis[0].y != 0 || obb_axis[0].z != 0) ? Vec3d( 0., -obb_axis[0].z, obb_axis[0].y) : Vec3d(0., 1., 0.);
         obb_axis[2] = Vec3d::cross(obb_axis[0], obb_axis[1]);
-        for (auto& axis : obb_axis) axis = axis.normalized();  // normalize axes 
+        for (int i = 0; i < 3; i++) obb_axis[i] = obb_axis[i].normalized();  // normalize axes 
       }
       // else there is a point degradation => use default AABB
     }
@@ -1089,20 +1108,11 @@ where f = (1 + √5) / 2 is the golden ratio
       }
     }
 
-    // now OBB axes are determined, calculate OBB with these axes for the whole point set
-    extend_obb(origin, points, count, obb, obb_axis);
-
-    // calculate a radius of a bounding sphere
-    radius = 0.0;
-    for(int i=0; i < count; ++i)
-    {
-      double dist = obb.center.distance(points[i]); 
-      if (dist > radius) radius = dist;
-    }
-
-    //snap to AABBB
-    snap_to_aabb( &obb, obb_axis);
+  }
 
+  // rotation ( box -> world ) of an OBB with the given axes
+  static Vec4d get_orientation(const Vec3d obb_axis[3])
+  {
     //create the rotation matrix
     Mat4d R;
     R._11 = obb_axis[0].x;
@@ -1128,7 +1138,227 @@ where f = (1 + √5) / 2 is the golden ratio
     R._43 = 0.0;
     R._44 = 1.0;
 
-    obb.orientation = rotation_matrix_to_quaternion(R);
+    return rotation_matrix_to_quaternion(R);
+  }
+
+  //---------------------------------------------------------------------------------------------------------------
+  // calculate a ballbox for a convexoid -  a combination of OBB and BS
+
+  void Pro_hull::get_ball_box(const Vec3d* points, int count
+    , Obb_abs& obb, double& radius, Method method) {
+    I3S_ASSERT(count > 0);
+    if (count == 0)
+    {
+      obb.center = Vec3d(0.0);
+      obb.orientation = utl::identity_quaternion<double>();
+      obb.extents = Vec3f(std::numeric_limits<float>::max());
+      return;
+    }
+
+    auto origin = std::accumulate(points + 1, points + count, points[0]) * (1.0 / count) ;
+    // reset the Pro_hull
+    std::fill(m_promin.begin(), m_promin.end(), std::numeric_limits<double>::max());
+    std::fill(m_promax.begin(), m_promax.end(), std::numeric_limits<double>::lowest());
+
+    // accumulate relative positions of all of the remaining points
+    for (int i = 0; i < count; i++) 
+      add(points[i] - origin);    // insert points into a convexoid
+
+    Vec3d obb_axis[3];              // OBB axes
+    get_obb_axes(method, obb_axis);
+
+    // now OBB axes are determined, calculate OBB with these axes for the whole point set
+    extend_obb(origin, points, count, obb, obb_axis);
+
+    // calculate a radius of a bounding sphere
+    radius = 0.0;
+    for(int i=0; i < count; ++i)
+    {
+      double dist = obb.center.distance(points[i]); 
+      if (dist > radius) radius = dist;
+    }
+
+    //snap to AABBB
+    snap_to_aabb( &obb, obb_axis);
+
+    obb.orientation = get_orientation(obb_axis);
+
+    // back to the absolute positions of the points
+    translate(origin);
+  }
+
+  //---------------------------------------------------------------------------------------------------------------
+  // vertices of the polytope bounded by the projection slabs of a hull ( it contains all the points of the hull )
+
+  void Pro_hull::get_slab_vertices(const Vec3d& origin, std::vector<Vec3d>& vertices) const {
+    vertices.clear();
+    const int n = m_base->base_vector_size;
+    std::vector<double> min_proj(n), max_proj(n);
+    double scale = 1.0;
+    for (int i = 0; i < n; i++) {
+      const auto proj = origin.dot(m_base->dir[i]);
+      min_proj[i] = m_promin[i] - proj;
+      max_proj[i] = m_promax[i] - proj;
+      scale = std::max({ scale, std::abs(min_proj[i]), std::abs(max_proj[i]) });
+    }
+    const double tolerance = 1e-9 * scale;  // vertices slightly outside are kept, it only loosens the bounds
+
+    // each vertex is the intersection of 3 slab planes with independent directions
+    for (const auto& t : m_base->triples) {
+      for (int planes = 0; planes < 8; planes++) {
+        const auto proj_i = (planes & 1) ? max_proj[t.i] : min_proj[t.i];
+        const auto proj_j = (planes & 2) ? max_proj[t.j] : min_proj[t.j];
+        const auto proj_k = (planes & 4) ? max_proj[t.k] : min_proj[t.k];
+        const Vec3d vertex = proj_i * t.a + proj_j * t.b + proj_k * t.c;
+
+        bool inside = true;
+        for (int m = 0; m < n && inside; m++) {
+          const auto proj = vertex.dot(m_base->dir[m]);
+          inside = proj >= min_proj[m] - tolerance && proj <= max_proj[m] + tolerance;
+        }
+        if (inside)
+          vertices.push_back(vertex);
+      }
+    }
+  }
+
+  //---------------------------------------------------------------------------------------------------------------
+  // bounds of the projection of the hull on a unit axis, from the projection intervals of independent direction triples:
+  // with axis = ci * dir[i] + cj * dir[j] + ck * dir[k], the projection of a point is the same combination of its
+  // projections on the directions. The triples of the directions closest to the axis give the tightest bounds.
+
+  bool Pro_hull::get_interval_bounds(const Vec3d& axis, double& min_proj, double& max_proj) const {
+    const double c_eps = 1e-6;          // minimal sine of the angles of 3 directions ( as in init_triples() )
+    const int c_candidates = 5;         // closest directions tried
+    const int n = m_base->base_vector_size;
+
+    // closest directions first:
+    std::array<int, c_candidates> closest;
+    std::array<double, c_candidates> closest_dot;
+    int closest_count = 0;
+    for (int m = 0; m < n; m++) {
+      const auto dot = std::abs(axis.dot(m_base->dir[m]));
+      int pos = std::min(closest_count, c_candidates - 1);
+      if (closest_count == c_candidates && dot <= closest_dot[pos])
+        continue;
+      for (; pos > 0 && closest_dot[pos - 1] < dot; pos--) {
+        closest[pos] = closest[pos - 1];
+        closest_dot[pos] = closest_dot[pos - 1];
+      }
+      closest[pos] = m;
+      closest_dot[pos] = dot;
+      closest_count = std::min(closest_count + 1, c_candidates);
+    }
+
+    min_proj = std::numeric_limits<double>::lowest();
+    max_proj = std::numeric_limits<double>::max();
+    bool found = false;
+    for (int i = 0; i < closest_count; i++) {
+      for (int j = i + 1; j < closest_count; j++) {
+        for (int k = j + 1; k < closest_count; k++) {
+          const int t[3] = { closest[i], closest[j], closest[k] };
+          const auto& dir_i = m_base->dir[t[0]], &dir_j = m_base->dir[t[1]], &dir_k = m_base->dir[t[2]];
+          const auto det = dir_i.dot(Vec3d::cross(dir_j, dir_k));
+          if (std::abs(det) < c_eps)
+            continue;   // ( almost ) coplanar directions
+          const double coef[3] = { axis.dot(Vec3d::cross(dir_j, dir_k)) / det, axis.dot(Vec3d::cross(dir_k, dir_i)) / det
+                                 , axis.dot(Vec3d::cross(dir_i, dir_j)) / det };
+          double lo = 0.0, hi = 0.0;
+          for (int m = 0; m < 3; m++) {
+            lo += coef[m] * (coef[m] > 0.0 ? m_promin[t[m]] : m_promax[t[m]]);
+            hi += coef[m] * (coef[m] > 0.0 ? m_promax[t[m]] : m_promin[t[m]]);
+          }
+          min_proj = std::max(min_proj, lo);
+          max_proj = std::min(max_proj, hi);
+          found = true;
+        }
+      }
+    }
+    return found;
+  }
+
+  //---------------------------------------------------------------------------------------------------------------
+  // calculate an OBB for a hull and the boxes containing its points
+
+  void Pro_hull::get_box(const Obb_abs* boxes, int count, Obb_abs& obb, Method method, Fit fit) const {
+    I3S_ASSERT(!is_empty() && (count > 0 || m_base->base_obb_size > 0));
+
+    auto min3d = std::numeric_limits<double>::max();
+    if (m_base->base_obb_size) {  // fixed OBB set:
+      get_bounding_box(obb, method);
+      min3d = get_metrics(method, Vec3d(obb.extents));
+    }
+    if (count == 0)
+      return;
+
+    // relative to the center of the hull, as in get_ball_box():
+    const auto origin = std::accumulate(m_provertex.begin() + 1, m_provertex.end(), m_provertex[0]) * (1.0 / m_provertex.size());
+    std::vector<Vec3d> vertices;
+    if (fit == Fit::Convexoid)
+      get_slab_vertices(origin, vertices);
+
+    // an OBB with a given orientation bounds both the boxes and the slab polytope:
+    auto check = [&](const Vec4d& orientation) {
+      Vec3d min_proj(std::numeric_limits<double>::max()), max_proj(std::numeric_limits<double>::lowest());
+      for (int i = 0; i < count; i++) {
+        const auto center = rotate_vec3_by_quaternion_inverse(boxes[i].center - origin, orientation);
+        Vec3d axis[3];
+        for (int a = 0; a < 3; a++) {
+          Vec3d box_axis(0.0);
+          box_axis[a] = boxes[i].extents[a];
+          axis[a] = rotate_vec3_by_quaternion_inverse(rotate_vec3_by_quaternion(box_axis, boxes[i].orientation), orientation);
+        }
+        for (int a = 0; a < 3; a++) {
+          const auto half = std::abs(axis[0][a]) + std::abs(axis[1][a]) + std::abs(axis[2][a]);
+          min_proj[a] = std::min(min_proj[a], center[a] - half);
+          max_proj[a] = std::max(max_proj[a], center[a] + half);
+        }
+      }
+      if (vertices.size()) {
+        Vec3d min_vertex(std::numeric_limits<double>::max()), max_vertex(std::numeric_limits<double>::lowest());
+        for (const auto& vertex : vertices) {
+          const auto p = rotate_vec3_by_quaternion_inverse(vertex, orientation);
+          min_vertex = min(min_vertex, p);
+          max_vertex = max(max_vertex, p);
+        }
+        min_proj = max(min_proj, min_vertex);
+        max_proj = min(max_proj, max_vertex);
+      }
+      else if (fit == Fit::Intervals) {
+        for (int a = 0; a < 3; a++) {
+          Vec3d unit(0.0);
+          unit[a] = 1.0;
+          const auto axis = rotate_vec3_by_quaternion(unit, orientation);
+          double lo, hi;
+          if (get_interval_bounds(axis, lo, hi)) {
+            const auto proj = origin.dot(axis);
+            min_proj[a] = std::max(min_proj[a], lo - proj);
+            max_proj[a] = std::min(max_proj[a], hi - proj);
+          }
+        }
+      }
+      const Vec3d extent = max_proj - min_proj;
+      const auto value = get_metrics(method, extent);
+      if (value < min3d) {
+        min3d = value;
+        obb.center = origin + rotate_vec3_by_quaternion(0.5 * (min_proj + max_proj), orientation);
+        obb.extents = Vec3f(0.5 * extent);
+        obb.orientation = orientation;
+      }
+    };
+
+    if (fit == Fit::Convexoid) {
+      // convexoid axes of the hull:
+      Vec3d obb_axis[3];
+      Pro_hull local(*this);
+      local.translate(-origin);
+      local.get_obb_axes(method, obb_axis);
+      check(get_orientation(obb_axis));
+    }
+
+    // box axes:
+    for (int i = 0; i < count; i++)
+      check(boxes[i].orientation);
   }
 
   //--------------------------------------------------------------------------------------------------------------------
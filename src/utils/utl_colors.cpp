@@ -20,6 +20,11 @@ email: contracts@esri.com
 #include "pch.h"
 #include "utils/utl_colors.h"
 #include <stdint.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
 
 namespace i3slib
 {
@@ -61,6 +66,53 @@ void rgba2bgra(uint32_t* rgba, int n)
   }
 }
 
+int get_alpha_bits(const Rgba8* pixels, size_t count)
+{
+  const Rgba8* p = pixels;
+  const Rgba8* end = pixels + count;
+  bool has_transparent = false;
+#if defined(__AVX2__)
+  // 8 pixels per compare: alpha must be 0x00 or 0xFF.
+  const __m256i alpha_mask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i transparent = zero;
+  for (; end - p >= 8; p += 8)
+  {
+    auto a = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), alpha_mask);
+    auto is_transparent = _mm256_cmpeq_epi32(a, zero);
+    auto is_binary = _mm256_or_si256(is_transparent, _mm256_cmpeq_epi32(a, alpha_mask));
+    if (_mm256_movemask_epi8(is_binary) != -1)
+      return 8;
+    transparent = _mm256_or_si256(transparent, is_transparent);
+  }
+  has_transparent = _mm256_movemask_epi8(transparent) != 0;
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  // 4 pixels per compare: alpha must be 0x00 or 0xFF.
+  const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+  const __m128i zero = _mm_setzero_si128();
+  __m128i transparent = zero;
+  for (; end - p >= 4; p += 4)
+  {
+    auto a = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), alpha_mask);
+    auto is_transparent = _mm_cmpeq_epi32(a, zero);
+    auto is_binary = _mm_or_si128(is_transparent, _mm_cmpeq_epi32(a, alpha_mask));
+    if (_mm_movemask_epi8(is_binary) != 0xFFFF)
+      return 8;
+    transparent = _mm_or_si128(transparent, is_transparent);
+  }
+  has_transparent = _mm_movemask_epi8(transparent) != 0;
+#endif
+  for (; p < end; ++p)
+  {
+    if (p->a > 0 && p->a < 255)
+      return 8;
+    has_transparent |= p->a == 0;
+  }
+  return has_transparent ?
+    1 : // 1-bit mask image ( 0 or 255 only)
+    0;  // opaque image
+}
+
 //for testing/debugging
 Rgba8 lod_to_color(int lod)
 {
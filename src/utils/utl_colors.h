@@ -82,6 +82,9 @@ I3S_EXPORT void rgba2bgra(uint32_t* rgba, int n);
 I3S_EXPORT Vec4f to_color4f(const Rgba8& v);
 I3S_EXPORT Rgba8 from_color4f(const Vec4f& v);
 I3S_EXPORT Vec4f lod_to_color4f(int lod);
+//! Classifies the alpha channel of the pixels: 0 if opaque, 1 if a 1-bit mask ( 0 or 255 only ), 8 otherwise.
+//! Stops at the first semi-transparent pixel.
+I3S_EXPORT int get_alpha_bits(const Rgba8* pixels, size_t count);
 
 
 struct Alpha_stop
@@ -32,6 +32,13 @@ email: contracts@esri.com
 #include <stdlib.h>
 #endif
 
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/sendfile.h>
+#endif
+
 namespace i3slib::utl
 {
 
@@ -68,6 +75,65 @@ bool write_file(const stdfs::path& path, const char* data, size_t bytes) noexcep
   return t.is_open() && t.write(data, bytes);
 }
 
+#ifdef __linux__
+
+int64_t append_file_range(const stdfs::path& dst, const stdfs::path& src, int64_t src_offset, int64_t n_bytes) noexcept
+{
+  const int in = ::open(src.c_str(), O_RDONLY | O_CLOEXEC);
+  if (in == -1)
+    return 0;
+  // copy_file_range() doesn't accept O_APPEND destinations, seek to the end instead.
+  const int out = ::open(dst.c_str(), O_WRONLY | O_CLOEXEC);
+  if (out == -1 || ::lseek(out, 0, SEEK_END) < 0)
+  {
+    if (out != -1)
+      ::close(out);
+    ::close(in);
+    return 0;
+  }
+
+  constexpr size_t c_max_chunk = 1 << 30;
+  off_t in_offset = static_cast<off_t>(src_offset);
+  int64_t n_copied = 0;
+  bool use_copy_file_range = true;
+  while (n_copied < n_bytes)
+  {
+    const auto n = static_cast<size_t>(std::min<int64_t>(n_bytes - n_copied, c_max_chunk));
+    ssize_t ret = -1;
+    if (use_copy_file_range)
+    {
+      ret = ::copy_file_range(in, &in_offset, out, nullptr, n, 0);
+      if (ret < 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP))
+      {
+        // e.g. cross-filesystem copy on older kernels. sendfile() still avoids the user-space copy.
+        use_copy_file_range = false;
+        continue;
+      }
+    }
+    else
+      ret = ::sendfile(out, in, &in_offset, n);
+
+    if (ret < 0 && errno == EINTR)
+      continue;
+    if (ret <= 0)
+      break;
+    n_copied += ret;
+  }
+
+  ::close(out);
+  ::close(in);
+  return n_copied;
+}
+
+#else
+
+int64_t append_file_range(const stdfs::path&, const stdfs::path&, int64_t, int64_t) noexcept
+{
+  return 0;
+}
+
+#endif
+
 std::string read_file(const stdfs::path& path) noexcept
 {
   if (std::ifstream t{ path, std::ios::binary | std::ios::ate }; t.is_open())
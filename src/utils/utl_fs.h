@@ -104,6 +104,13 @@ I3S_EXPORT bool write_file(const stdfs::path& path, const char* data, size_t byt
 inline bool write_file(const stdfs::path& path, const std::string& content)noexcept
 { return write_file(path, content.data(), content.size()); }
 
+// Append n_bytes of src (starting at src_offset) to the end of dst with an in-kernel copy 
+// (copy_file_range() or sendfile() on Linux). Both must be regular files.
+// Returns the number of bytes actually appended, which may be less than n_bytes (0 if not supported 
+// on this platform), caller is expected to copy the remainder some other way.
+[[ nodiscard ]]
+I3S_EXPORT int64_t append_file_range(const stdfs::path& dst, const stdfs::path& src, int64_t src_offset, int64_t n_bytes) noexcept;
+
 [[ nodiscard ]] inline
 stdfs::path make_path(const stdfs::path& ref_path, const stdfs::path& res_path) // can throw bad_alloc or bad_array_new_length
 {
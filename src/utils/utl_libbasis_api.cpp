@@ -21,6 +21,12 @@ email: contracts@esri.com
 #include "pch.h"
 #include <memory>
 #include "utils/utl_libbasis_api.h"
+#include "i3s/i3s_writer.h"
+#include <algorithm>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <thread>
 
 // SLL
 #include "utils/dxt/dds.h"
@@ -59,6 +65,22 @@ void add_alpha_channel(const uint8_t* rgb, size_t pixel_count, uint8_t* rgba, ui
   }
   I3S_ASSERT(out == pixel_count * 4);
 }
+
+#ifndef NO_BASIS_ENCODER_SUPPORT
+// Pool of the multithreaded encodings. basisu::job_pool::wait_for_all() waits until the whole pool is idle, so it is used
+// by one encoding at a time ( see get_shared_job_pool_mutex() ): concurrent ones would wait for each other's jobs.
+basisu::job_pool& get_shared_job_pool()
+{
+  static basisu::job_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+  return pool;
+}
+
+std::mutex& get_shared_job_pool_mutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+#endif
 }
 
 namespace i3slib
@@ -81,7 +103,8 @@ namespace i3slib
       int w, int h,
       int component_count, // must be 3 or 4 (rgb8 or rgba8)
       std::string& basis_out,
-      i3s::Texture_semantic sem
+      i3s::Texture_semantic sem,
+      const i3s::Basis_encoding_params& params
     )
     {
       if (component_count != 3 && component_count != 4)
@@ -94,14 +117,29 @@ namespace i3slib
       basisu::basis_compressor_params comp_params;
       comp_params.m_status_output = false; // don't print informational messages to console.
       comp_params.m_mip_gen = true;
-      comp_params.m_quality_level = 128;
-      comp_params.m_compression_level = 1;
-      comp_params.m_multithreading = 0;
+      comp_params.m_quality_level = std::clamp(params.etc1s_quality, 1, 255);
+      comp_params.m_compression_level = std::clamp(params.etc1s_effort, 0, 6);
       comp_params.m_create_ktx2_file = true;
 
-      if (sem == i3s::Texture_semantic::Normal_map)
+      if (params.codec == i3s::Basis_encoding_params::Codec::Uastc || sem == i3s::Texture_semantic::Normal_map)
       {
         comp_params.m_uastc = true;
+        comp_params.m_pack_uastc_flags = static_cast<uint32_t>(std::clamp(params.uastc_level, 0, 4)); // cPackUASTCLevelFastest ... cPackUASTCLevelVerySlow
+        if (params.zstd_level > 0)
+        {
+          comp_params.m_ktx2_uastc_supercompression = basist::KTX2_SS_ZSTANDARD;
+          comp_params.m_ktx2_zstd_supercompression_level = params.zstd_level;
+        }
+        else
+          comp_params.m_ktx2_uastc_supercompression = basist::KTX2_SS_NONE;
+      }
+      if (params.codec == i3s::Basis_encoding_params::Codec::Uastc && sem != i3s::Texture_semantic::Normal_map && params.uastc_rdo_lambda > 0.0f)
+      {
+        comp_params.m_rdo_uastc = true;
+        comp_params.m_rdo_uastc_quality_scalar = params.uastc_rdo_lambda;
+      }
+      if (sem == i3s::Texture_semantic::Normal_map)
+      {
         // additional options used by basis command line tool when using the -normal-map option
         comp_params.m_perceptual = false;
         comp_params.m_mip_srgb = false;
@@ -112,10 +150,13 @@ namespace i3slib
       // Note: basisu::image constructor adds opaque alpha for rgb input
       basisu::image img;
       comp_params.m_source_images.push_back(basisu::image{ (uint8_t*)data, (uint32_t)w, (uint32_t)h, (uint32_t)component_count });
-      // threads
-      constexpr auto num_threads = 16;
-      basisu::job_pool jpool(num_threads);
-      comp_params.m_pJob_pool = &jpool;
+      // threads ( a single-thread pool doesn't start any ). An encoding started while the shared pool is in use runs on
+      // the calling thread rather than waiting: the writer threads already encode concurrently.
+      basisu::job_pool jpool(1);
+      std::unique_lock<std::mutex> shared_pool_lock(get_shared_job_pool_mutex(), std::defer_lock);
+      const bool use_shared_pool = params.multithreading && shared_pool_lock.try_lock();
+      comp_params.m_multithreading = use_shared_pool;
+      comp_params.m_pJob_pool = use_shared_pool ? &get_shared_job_pool() : &jpool;
 
       // set up compressor
       basisu::basis_compressor basisu_comp;
@@ -350,6 +391,7 @@ namespace i3slib
     }
 #endif
 
+#ifdef ENABLE_BASIS_FILE_SUPPORT
     // transcodes all mip levels of an image
     static std::vector< std::vector<uint8_t> > transcode_image(const char* basis, int bytes, Transcoder_format fmt)
     {
@@ -364,168 +406,275 @@ namespace i3slib
       for (int level_index = 0; level_index < num_mipmaps; level_index++)
       {
         auto& gi = mipmaps[level_index];
-#ifdef ENABLE_BASIS_FILE_SUPPORT
         // remove once Basis support is dropped. will be ktx2 only
         if (!is_ktx2 && !transcode_mip_level_basis(basis, bytes, level_index, &gi, fmt))
           return {};
-#endif
         if (is_ktx2 && !transcode_mip_level(basis, bytes, level_index, &gi, fmt))
           return {};
       }
       return mipmaps;
     }
+#endif
 
-
-    static bool copy_mipmaps_to_dds(const std::vector< std::vector<uint8_t > >& gpu_images, std::vector<uint8_t>* dds_out, int width, int height, int mipmap_count, bool has_alpha)
+    struct KTX_header
     {
-      static constexpr int c_dxt5_block_size = 16; // BC3
-      static constexpr int c_dxt1_block_size = 8;  // BC1
-      // DDS header
-      DirectX::DDS_HEADER hdr;
-      memset(&hdr, 0, sizeof(DirectX::DDS_HEADER));
-      // --- set the header:
-      hdr.size = 124;
-      hdr.flags = DDS_HEADER_FLAGS_TEXTURE | DDS_HEADER_FLAGS_MIPMAP | DDS_HEADER_FLAGS_LINEARSIZE; // compressed texture with mipmaps
-      hdr.height = height;
-      hdr.width = width;
-      hdr.pitchOrLinearSize = std::max(1, ((width + 3) / 4)) * std::max(1, ((height + 3) / 4)) * (has_alpha ? c_dxt5_block_size : c_dxt1_block_size);
-      hdr.mipMapCount = mipmap_count;
-      hdr.ddspf = has_alpha ? DirectX::DDSPF_DXT5 : DirectX::DDSPF_DXT1;
-      hdr.caps = DDS_SURFACE_FLAGS_MIPMAP | DDS_SURFACE_FLAGS_TEXTURE;
-
-      int offset = 0;
-      // add magic
-      std::vector<uint8_t> dds(sizeof(uint32_t));
-      memcpy(dds.data(), &DirectX::DDS_MAGIC, sizeof(uint32_t));
-      offset += sizeof(uint32_t);
-      // copy header
-      dds.resize(dds.size() + sizeof(DirectX::DDS_HEADER));
-      memcpy(dds.data() + offset, &hdr, sizeof(DirectX::DDS_HEADER));
-      offset += sizeof(DirectX::DDS_HEADER);
-
-      // copy mipmaps
-      for (int mip_index = 0; mip_index < mipmap_count; mip_index++)
-      {
-        const auto& img = gpu_images[mip_index];
-        const auto img_size_in_bytes = img.size();
-        // copy data
-        const auto dds_end = dds.size();
-        dds.resize(dds_end + img_size_in_bytes);
-        memcpy(dds.data() + dds_end, img.data(), img_size_in_bytes);
-      } // mip_index
-
-      *dds_out = std::move(dds);
-      return true;
+      uint8_t identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+      uint32_t endianness{ 0 };
+      uint32_t gl_type{ 0 };
+      uint32_t gl_type_size{ 0 };
+      uint32_t gl_format{ 0 };
+      uint32_t gl_internal_format{ 0 };
+      uint32_t gl_base_internal_format{ 0 };
+      uint32_t pixel_width{ 0 };
+      uint32_t pixel_height{ 0 };
+      uint32_t pixel_depth{ 0 };
+      uint32_t number_of_array_elements{ 0 };
+      uint32_t number_of_faces{ 0 };
+      uint32_t number_of_mipmap_levels{ 0 };
+      uint32_t bytes_of_key_value_data{ 0 };
+    };
+
+    static size_t get_header_size(Mip_container container)
+    {
+      return container == Mip_container::Dds ? sizeof(uint32_t) + sizeof(DirectX::DDS_HEADER) : sizeof(KTX_header);
+    }
 
+    // KTX stores the size of each level before its data.
+    static size_t get_level_prefix_size(Mip_container container)
+    {
+      return container == Mip_container::Ktx ? sizeof(uint32_t) : 0;
     }
 
-    bool transcode_basis_to_dds(const char* basis, int bytes, std::vector<uint8_t>* dds_out, bool has_alpha)
+    static void write_header(Mip_container container, uint8_t* out, int width, int height, int mipmap_count, bool has_alpha)
     {
-      if (basis && dds_out)
+      if (container == Mip_container::Dds)
       {
-        int width = 0, height = 0, mipmap_count = 0;
-        if (!get_image_info(basis, bytes, &width, &height, &mipmap_count))
-          return false;
-
-        auto fmt = has_alpha ? Transcoder_format::BC3 : Transcoder_format::BC1;
-
-        auto gpu_images = transcode_image(basis, bytes, fmt);
-        if (gpu_images.empty())
-          return false; // transcoding failed
-
-        copy_mipmaps_to_dds(gpu_images, dds_out, width, height, mipmap_count, has_alpha);
-
-        return true;
+        static constexpr int c_dxt5_block_size = 16; // BC3
+        static constexpr int c_dxt1_block_size = 8;  // BC1
+        // DDS header
+        DirectX::DDS_HEADER hdr;
+        memset(&hdr, 0, sizeof(DirectX::DDS_HEADER));
+        // --- set the header:
+        hdr.size = 124;
+        hdr.flags = DDS_HEADER_FLAGS_TEXTURE | DDS_HEADER_FLAGS_MIPMAP | DDS_HEADER_FLAGS_LINEARSIZE; // compressed texture with mipmaps
+        hdr.height = height;
+        hdr.width = width;
+        hdr.pitchOrLinearSize = std::max(1, ((width + 3) / 4)) * std::max(1, ((height + 3) / 4)) * (has_alpha ? c_dxt5_block_size : c_dxt1_block_size);
+        hdr.mipMapCount = mipmap_count;
+        hdr.ddspf = has_alpha ? DirectX::DDSPF_DXT5 : DirectX::DDSPF_DXT1;
+        hdr.caps = DDS_SURFACE_FLAGS_MIPMAP | DDS_SURFACE_FLAGS_TEXTURE;
+
+        memcpy(out, &DirectX::DDS_MAGIC, sizeof(uint32_t));
+        memcpy(out + sizeof(uint32_t), &hdr, sizeof(DirectX::DDS_HEADER));
+      }
+      else
+      {
+        KTX_header hdr;
+        hdr.endianness = 0x04030201;
+        hdr.gl_type_size = 1;
+        hdr.gl_internal_format = 0x9278; // GL_COMPRESSED_RGBA8_ETC2_EAC;
+        hdr.gl_base_internal_format = has_alpha ? 0x1908 : 0x1907; // GL_RGBA: GL_RGB;
+        hdr.number_of_faces = 1;
+        hdr.pixel_height = height;
+        hdr.pixel_width = width;
+        hdr.number_of_mipmap_levels = mipmap_count;
+        memcpy(out, &hdr, sizeof(hdr));
       }
-      return false; // mising input or output
+    }
 
+    // Transcoder state is kept by each thread, so that its buffers are re-used from one texture to the next.
+    static basist::ktx2_transcoder& get_thread_decoder()
+    {
+      thread_local basist::ktx2_transcoder dec;
+      return dec;
     }
 
-    static bool create_ktx_from_etc2_mipmaps(const std::vector< std::vector<uint8_t > >& gpu_images, std::vector<uint8_t>& ktx_out, int width, int height, int mipmap_count, bool has_alpha)
+    static basist::ktx2_transcoder_state& get_thread_transcoder_state()
     {
-      struct KTX_header
-      {
-        uint8_t identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
-        uint32_t endianness{ 0 };
-        uint32_t gl_type{ 0 };
-        uint32_t gl_type_size{ 0 };
-        uint32_t gl_format{ 0 };
-        uint32_t gl_internal_format{ 0 };
-        uint32_t gl_base_internal_format{ 0 };
-        uint32_t pixel_width{ 0 };
-        uint32_t pixel_height{ 0 };
-        uint32_t pixel_depth{ 0 };
-        uint32_t number_of_array_elements{ 0 };
-        uint32_t number_of_faces{ 0 };
-        uint32_t number_of_mipmap_levels{ 0 };
-        uint32_t bytes_of_key_value_data{ 0 };
-      };
+      thread_local basist::ktx2_transcoder_state state;
+      return state;
+    }
 
-      KTX_header hdr;
-      hdr.endianness = 0x04030201;
-      hdr.gl_type_size = 1;
-      hdr.gl_internal_format = 0x9278; // GL_COMPRESSED_RGBA8_ETC2_EAC;
-      hdr.gl_base_internal_format = has_alpha ? 0x1908 : 0x1907; // GL_RGBA: GL_RGB;
-      hdr.number_of_faces = 1;
-      hdr.pixel_height = height;
-      hdr.pixel_width = width;
-      hdr.number_of_mipmap_levels = mipmap_count;
-
-      // Determine total size in bytes and allocate once
-      auto total_size_in_bytes = sizeof(hdr) + static_cast<size_t>(4 * mipmap_count);
-      for (auto const& gpu_image : gpu_images)
+    //! Long-lived thread transcoding the smaller levels of a texture while the caller does level 0. Its thread_local 
+    //! decoder state is re-used from one texture to the next. A single task at a time: callers finding it busy don't wait.
+    class Level_helper
+    {
+    public:
+      static Level_helper& get()
       {
-        total_size_in_bytes += gpu_image.size();
+        static Level_helper helper;
+        return helper;
       }
-
-      try
+      ~Level_helper()
       {
-        ktx_out.resize(total_size_in_bytes);
+        {
+          std::lock_guard<std::mutex> lk(m_mutex);
+          m_stop = true;
+        }
+        m_cv.notify_one();
+        m_thread.join();
       }
-      catch (std::bad_alloc const&)
+      //! Invalid future if the helper is busy ( f isn't run ).
+      std::future<bool> try_run(std::function<bool()> f)
       {
-        return false;
+        std::lock_guard<std::mutex> lk(m_mutex);
+        if (m_is_busy)
+          return {};
+        m_is_busy = true;
+        m_task = std::packaged_task<bool()>(std::move(f));
+        auto ret = m_task.get_future();
+        m_cv.notify_one();
+        return ret;
       }
 
-      // copy header
-      memcpy(ktx_out.data(), &hdr, sizeof(hdr));
-
-      ptrdiff_t offset = sizeof(hdr);
-      // copy mipmaps
-      for (int mip_index = 0; mip_index < mipmap_count; mip_index++)
+    private:
+      Level_helper() : m_thread([this]() { _run(); }) {}
+      void _run()
       {
-        const auto& img = gpu_images[mip_index];
-        const auto img_size_in_bytes = img.size();
-        // copy data
-        memcpy(ktx_out.data() + offset, &img_size_in_bytes, 4);
-        memcpy(ktx_out.data() + offset + 4, img.data(), img_size_in_bytes);
-
-        offset += 4 + img_size_in_bytes;
-      } // mip_index
+        std::unique_lock<std::mutex> lk(m_mutex);
+        while (true)
+        {
+          m_cv.wait(lk, [this]() { return m_stop || m_task.valid(); });
+          if (m_stop)
+            return;
+          auto task = std::move(m_task);
+          lk.unlock();
+          task();
+          lk.lock();
+          m_is_busy = false;
+        }
+      }
+      std::mutex                    m_mutex;
+      std::condition_variable       m_cv;
+      std::packaged_task<bool()>    m_task;
+      bool                          m_is_busy = false;
+      bool                          m_stop = false;
+      std::thread                   m_thread; // last: started once the members above are constructed.
+    };
+
+    // Container of the levels of a .basis file ( transcoded one by one ).
+    static bool transcode_to_container_serial(const char* basis, int bytes, Mip_container container, bool has_alpha, const std::function<char* (size_t)>& allocate)
+    {
+#ifdef ENABLE_BASIS_FILE_SUPPORT
+      int width = 0, height = 0, mipmap_count = 0;
+      if (!get_image_info(basis, bytes, &width, &height, &mipmap_count))
+        return false;
+      const auto fmt = container == Mip_container::Ktx ? Transcoder_format::ETC2 : has_alpha ? Transcoder_format::BC3 : Transcoder_format::BC1;
+      const auto gpu_images = transcode_image(basis, bytes, fmt);
+      if (gpu_images.empty())
+        return false; // transcoding failed
 
+      size_t size = get_header_size(container);
+      for (const auto& img : gpu_images)
+        size += get_level_prefix_size(container) + img.size();
+      auto out = reinterpret_cast<uint8_t*>(allocate(size));
+      if (!out)
+        return false;
+      write_header(container, out, width, height, mipmap_count, has_alpha);
+      out += get_header_size(container);
+      for (const auto& img : gpu_images)
+      {
+        const auto img_size_in_bytes = static_cast<uint32_t>(img.size());
+        if (get_level_prefix_size(container))
+          memcpy(out, &img_size_in_bytes, sizeof(img_size_in_bytes));
+        out += get_level_prefix_size(container);
+        memcpy(out, img.data(), img.size());
+        out += img.size();
+      }
       return true;
+#else
+      return false;
+#endif
     }
 
-    bool transcode_basis_to_ktx(const char* basis, int bytes, std::vector<uint8_t>* ktx_out, bool has_alpha)
+    bool transcode_basis_to_container(const char* basis, int bytes, Mip_container container, bool has_alpha, const std::function<char* (size_t)>& allocate, bool is_parallel)
     {
-      if (basis == nullptr || ktx_out == nullptr)
+      if (basis == nullptr || !allocate)
+        return false;
+      if (is_basis_file(basis, bytes))
+        return transcode_to_container_serial(basis, bytes, container, has_alpha, allocate);
+
+      basis_init();
+      auto& dec = get_thread_decoder();
+      if (!dec.init(basis, bytes) || !dec.start_transcoding())
+        return false;
+
+      const auto fmt = to_basis_transcoder_tex_fmt(container == Mip_container::Ktx ? Transcoder_format::ETC2 : has_alpha ? Transcoder_format::BC3 : Transcoder_format::BC1);
+      const auto bytes_per_block = basist::basis_get_bytes_per_block_or_pixel(fmt);
+      const int mipmap_count = static_cast<int>(dec.get_levels());
+
+      // --- layout of the container:
+      std::vector< uint32_t > block_counts(mipmap_count);
+      std::vector< size_t > offsets(mipmap_count + 1);
+      offsets[0] = get_header_size(container);
+      for (int i = 0; i < mipmap_count; ++i)
       {
-        return false; // mising input or output
+        basist::ktx2_image_level_info level_info;
+        if (!dec.get_image_level_info(level_info, i, 0, 0))
+          return false;
+        block_counts[i] = level_info.m_total_blocks;
+        offsets[i + 1] = offsets[i] + get_level_prefix_size(container) + static_cast<size_t>(block_counts[i]) * bytes_per_block;
       }
-
-      int width = 0, height = 0, mipmap_count = 0;
-      if (!get_image_info(basis, bytes, &width, &height, &mipmap_count))
+      auto out = reinterpret_cast<uint8_t*>(allocate(offsets.back()));
+      if (!out)
         return false;
+      write_header(container, out, dec.get_width(), dec.get_height(), mipmap_count, has_alpha);
 
-      auto fmt = Transcoder_format::ETC2;
+      // --- levels are transcoded at their final offset. Concurrent calls to the decoder are safe with a state per thread:
+      const auto transcode_level = [&dec, &block_counts, &offsets, out, fmt, bytes_per_block, container](int i)
+      {
+        auto dst = out + offsets[i];
+        if (get_level_prefix_size(container))
+        {
+          const uint32_t img_size_in_bytes = block_counts[i] * bytes_per_block;
+          memcpy(dst, &img_size_in_bytes, sizeof(img_size_in_bytes));
+          dst += get_level_prefix_size(container);
+        }
+        return dec.transcode_image_level(i, 0, 0, dst, block_counts[i], fmt, 0, 0, 0, -1, -1, &get_thread_transcoder_state());
+      };
+      const auto transcode_levels = [&transcode_level](int first, int last)
+      {
+        for (int i = first; i < last; ++i)
+        {
+          if (!transcode_level(i))
+            return false;
+        }
+        return true;
+      };
 
-      auto gpu_images = transcode_image(basis, bytes, fmt);
-      if (gpu_images.empty())
+      // Level 0 is at least 3/4 of the work, so the other ones are transcoded by a single helper thread ( if it's idle ):
+      if (is_parallel && mipmap_count > 1)
       {
-        return false; // transcoding failed
+        auto smaller_levels = Level_helper::get().try_run([&transcode_levels, mipmap_count]() { return transcode_levels(1, mipmap_count); });
+        if (smaller_levels.valid())
+        {
+          const bool is_level0_ok = transcode_levels(0, 1);
+          return smaller_levels.get() && is_level0_ok;
+        }
       }
+      return transcode_levels(0, mipmap_count);
+    }
 
-      return create_ktx_from_etc2_mipmaps(gpu_images, *ktx_out, width, height, mipmap_count, has_alpha);
+    bool transcode_basis_to_dds(const char* basis, int bytes, std::vector<uint8_t>* dds_out, bool has_alpha)
+    {
+      if (dds_out == nullptr)
+        return false; // mising input or output
+      return transcode_basis_to_container(basis, bytes, Mip_container::Dds, has_alpha, [dds_out](size_t size)
+      {
+        dds_out->resize(size);
+        return reinterpret_cast<char*>(dds_out->data());
+      });
+    }
+
+    bool transcode_basis_to_ktx(const char* basis, int bytes, std::vector<uint8_t>* ktx_out, bool has_alpha)
+    {
+      if (ktx_out == nullptr)
+        return false; // mising input or output
+      return transcode_basis_to_container(basis, bytes, Mip_container::Ktx, has_alpha, [ktx_out](size_t size)
+      {
+        ktx_out->resize(size);
+        return reinterpret_cast<char*>(ktx_out->data());
+      });
     }
 
     bool get_basis_image_info(const char* basis, int bytes, int* mip0_w, int* mip0_h, int* mipmap_count)
@@ -546,7 +695,9 @@ namespace i3slib
       const char* data,
       int w, int h,
       int component_count, // must be 3 or 4 (rgb8 or rgba8)
-      std::string& basis_out
+      std::string& basis_out,
+      i3s::Texture_semantic sem,
+      const i3s::Basis_encoding_params& params
     )
     {
       if (component_count != 3 && component_count != 4)
@@ -560,6 +711,24 @@ namespace i3slib
     bool transcode_mip_level(const char* basis_img, int num_bytes, int mip_level, std::vector<uint8_t>* out, Transcoder_format fmt) { return true; }
     bool get_basis_image_info(const char* basis_img, int num_bytes, int* mip0_w, int* mip0_h, int* mipmap_count) { return true; }
     bool transcode_basis_to_dds(const char* basis_img, int num_bytes, std::vector<uint8_t>* out, bool has_alpha) { return true; }
+    bool transcode_basis_to_container(const char* basis_img, int num_bytes, Mip_container container, bool has_alpha, const std::function<char* (size_t)>& allocate, bool is_parallel) { return true; }
     }
   }
 #endif
+
+namespace i3slib
+{
+  namespace utl
+  {
+    bool compress_to_basis_with_mips(
+      const char* data,
+      int w, int h,
+      int component_count,
+      std::string& basis_out,
+      i3s::Texture_semantic sem
+    )
+    {
+      return compress_to_basis_with_mips(data, w, h, component_count, basis_out, sem, i3s::Basis_encoding_params{});
+    }
+  }
+}
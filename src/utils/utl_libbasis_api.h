@@ -19,6 +19,7 @@ email: contracts@esri.com
 
 #pragma once
 
+#include <functional>
 #include <vector>
 #include <string>
 #include <stdint.h>
@@ -27,6 +28,11 @@ email: contracts@esri.com
 
 namespace i3slib
 {
+  namespace i3s
+  {
+    struct Basis_encoding_params;
+  }
+
   namespace utl
   {
     // Encoding
@@ -35,21 +41,43 @@ namespace i3slib
     // For normal maps(Texture_semmantic::Normal_map) UASTC  mode will be enabled.
     // This will create higher quality a texture, similar to BC7, which is suitable for normal maps,
     // but will result in a larger file size.
-    // Everything else will use ETC1S.
+    // Everything else is encoded as specified by params ( ETC1S by default ).
     I3S_EXPORT bool compress_to_basis_with_mips(
       const char* data,
       int w, int h,
       int component_count, // must be 3 or 4 (rgb8 or rgba8)
       std::string& basis_out,
-      i3s::Texture_semantic sem = i3s::Texture_semantic::Base_color
+      i3s::Texture_semantic sem,
+      const i3s::Basis_encoding_params& params
     ); // on conversion to 1.8+. Creates a ktx2 file.
 
+    // Same, with the default Basis_encoding_params.
+    I3S_EXPORT bool compress_to_basis_with_mips(
+      const char* data,
+      int w, int h,
+      int component_count, // must be 3 or 4 (rgb8 or rgba8)
+      std::string& basis_out,
+      i3s::Texture_semantic sem = i3s::Texture_semantic::Base_color
+    );
+
     // TRANSCODING
     enum class Transcoder_format { BC1 = 1, BC3 = 2, BC7 = 3, RGBA = 4, ETC2 = 5};
 
     I3S_EXPORT bool transcode_mip_level(const char* basis_img, int num_bytes, int mip_level, std::vector<uint8_t>* out, Transcoder_format fmt);
     I3S_EXPORT bool get_basis_image_info(const char* basis_img, int num_bytes, int* mip0_w, int* mip0_h, int* mipmap_count);
 
+    enum class Mip_container { Dds, Ktx };
+
+    // Transcodes all the mip levels to a DDS ( BC3 if has_alpha, BC1 otherwise ) or KTX ( ETC2 ) container.
+    // allocate(size) is called once with the size of the whole container and returns the output buffer ( nullptr to abort ):
+    // levels are transcoded directly at their final offset, level 0 and the smaller ones concurrently if is_parallel
+    // ( and the helper thread is idle ).
+    I3S_EXPORT bool transcode_basis_to_container(
+      const char* basis_img, int num_bytes,
+      Mip_container container, bool has_alpha,
+      const std::function<char*(size_t size)>& allocate,
+      bool is_parallel = true);
+
     // for SLL test viewer. On-the-fly transcoding to dds
     // trancodes basis file to BC3 (if has alpha), BC1 (no alpha)
     // includes mipmaps
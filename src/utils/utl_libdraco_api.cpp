@@ -597,6 +597,8 @@ static bool draco_compress(T& builder, int size, const draco_i3s_mesh* src, drac
     encoder.SetAttributeQuantization(draco::GeometryAttribute::TEX_COORD, src->bits_uv);
 
   encoder.SetSpeedOptions(3,3); //(best compression) TBD!
+  if (src->keep_face_order)
+    encoder.SetEncodingMethod(draco::MESH_SEQUENTIAL_ENCODING);
 
   if (src->pos_scale_x != 1.0 || src->pos_scale_y != 1.0)
   {
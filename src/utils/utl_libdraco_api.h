@@ -45,6 +45,7 @@ struct draco_i3s_mesh
   uint32_t              anchor_point_count = 0;
   const uint32_t*       anchor_point_fid_indices = nullptr;
   const float*          anchor_points = nullptr; // float3
+  bool                  keep_face_order = false; // sequential connectivity encoding ( larger ) instead of edgebreaker, which reorders faces
 }; 
 
 enum draco_attrib_type_t { Pos=0, Normal, Color, Uv, Region, Fid_index, Fid, Anchor_point_fid_index, Anchor_points };
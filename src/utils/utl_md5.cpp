@@ -24,6 +24,11 @@ email: contracts@esri.com
 #include <algorithm>
 #include <cstring>
 #include <stdint.h>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#endif
 
 namespace
 {
@@ -39,7 +44,7 @@ uint32_t left_rotate(uint32_t x, int n)
   return (x << n) | (x >> (32 - n));
 }
 
-const uint32_t s[] =
+constexpr uint32_t s[] =
 {
   7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,   // 0..15
   5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,   // 16..31
@@ -47,7 +52,7 @@ const uint32_t s[] =
   6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21    // 48..63
 };
 
-const uint32_t k[] =
+constexpr uint32_t k[] =
 {
   0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, // 0..3
   0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501, // 4..7
@@ -67,6 +72,148 @@ const uint32_t k[] =
   0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391  // 60..63
 }; 
 
+constexpr uint32_t c_init_state[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+
+// --- Multi-buffer MD5: each lane of a vector holds the same state word of a different message.
+#if defined(__AVX512F__)
+struct Md5_lanes
+{
+  static constexpr bool c_is_simd = true;
+  static constexpr int c_count = 16;
+  static Md5_lanes load(const uint32_t* p) { return { _mm512_loadu_si512(p) }; }
+  static Md5_lanes set1(uint32_t x) { return { _mm512_set1_epi32(static_cast<int>(x)) }; }
+  void store(uint32_t* p) const { _mm512_storeu_si512(p, v); }
+  template< int S > Md5_lanes rotl() const { return { _mm512_rol_epi32(v, S) }; }
+  friend Md5_lanes operator+(Md5_lanes a, Md5_lanes b) { return { _mm512_add_epi32(a.v, b.v) }; }
+  friend Md5_lanes operator&(Md5_lanes a, Md5_lanes b) { return { _mm512_and_si512(a.v, b.v) }; }
+  friend Md5_lanes operator|(Md5_lanes a, Md5_lanes b) { return { _mm512_or_si512(a.v, b.v) }; }
+  friend Md5_lanes operator^(Md5_lanes a, Md5_lanes b) { return { _mm512_xor_si512(a.v, b.v) }; }
+  friend Md5_lanes andnot(Md5_lanes a, Md5_lanes b) { return { _mm512_andnot_si512(a.v, b.v) }; } // ~a & b
+  __m512i v;
+};
+#elif defined(__AVX2__)
+struct Md5_lanes
+{
+  static constexpr bool c_is_simd = true;
+  static constexpr int c_count = 8;
+  static Md5_lanes load(const uint32_t* p) { return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)) }; }
+  static Md5_lanes set1(uint32_t x) { return { _mm256_set1_epi32(static_cast<int>(x)) }; }
+  void store(uint32_t* p) const { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+  template< int S > Md5_lanes rotl() const { return { _mm256_or_si256(_mm256_slli_epi32(v, S), _mm256_srli_epi32(v, 32 - S)) }; }
+  friend Md5_lanes operator+(Md5_lanes a, Md5_lanes b) { return { _mm256_add_epi32(a.v, b.v) }; }
+  friend Md5_lanes operator&(Md5_lanes a, Md5_lanes b) { return { _mm256_and_si256(a.v, b.v) }; }
+  friend Md5_lanes operator|(Md5_lanes a, Md5_lanes b) { return { _mm256_or_si256(a.v, b.v) }; }
+  friend Md5_lanes operator^(Md5_lanes a, Md5_lanes b) { return { _mm256_xor_si256(a.v, b.v) }; }
+  friend Md5_lanes andnot(Md5_lanes a, Md5_lanes b) { return { _mm256_andnot_si256(a.v, b.v) }; } // ~a & b
+  __m256i v;
+};
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+struct Md5_lanes
+{
+  static constexpr bool c_is_simd = true;
+  static constexpr int c_count = 4;
+  static Md5_lanes load(const uint32_t* p) { return { _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) }; }
+  static Md5_lanes set1(uint32_t x) { return { _mm_set1_epi32(static_cast<int>(x)) }; }
+  void store(uint32_t* p) const { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+  template< int S > Md5_lanes rotl() const { return { _mm_or_si128(_mm_slli_epi32(v, S), _mm_srli_epi32(v, 32 - S)) }; }
+  friend Md5_lanes operator+(Md5_lanes a, Md5_lanes b) { return { _mm_add_epi32(a.v, b.v) }; }
+  friend Md5_lanes operator&(Md5_lanes a, Md5_lanes b) { return { _mm_and_si128(a.v, b.v) }; }
+  friend Md5_lanes operator|(Md5_lanes a, Md5_lanes b) { return { _mm_or_si128(a.v, b.v) }; }
+  friend Md5_lanes operator^(Md5_lanes a, Md5_lanes b) { return { _mm_xor_si128(a.v, b.v) }; }
+  friend Md5_lanes andnot(Md5_lanes a, Md5_lanes b) { return { _mm_andnot_si128(a.v, b.v) }; } // ~a & b
+  __m128i v;
+};
+#else
+// Portable fallback ( slower than the scalar implementation unless auto-vectorized, see Md5::hash_n() ):
+struct Md5_lanes
+{
+  static constexpr bool c_is_simd = false;
+  static constexpr int c_count = 4;
+  static Md5_lanes load(const uint32_t* p) { Md5_lanes r; std::memcpy(r.v, p, sizeof(r.v)); return r; }
+  static Md5_lanes set1(uint32_t x) { return { { x, x, x, x } }; }
+  void store(uint32_t* p) const { std::memcpy(p, v, sizeof(v)); }
+  template< int S > Md5_lanes rotl() const { return apply([](uint32_t x, uint32_t) { return left_rotate(x, S); }, *this, *this); }
+  friend Md5_lanes operator+(Md5_lanes a, Md5_lanes b) { return apply([](uint32_t x, uint32_t y) { return x + y; }, a, b); }
+  friend Md5_lanes operator&(Md5_lanes a, Md5_lanes b) { return apply([](uint32_t x, uint32_t y) { return x & y; }, a, b); }
+  friend Md5_lanes operator|(Md5_lanes a, Md5_lanes b) { return apply([](uint32_t x, uint32_t y) { return x | y; }, a, b); }
+  friend Md5_lanes operator^(Md5_lanes a, Md5_lanes b) { return apply([](uint32_t x, uint32_t y) { return x ^ y; }, a, b); }
+  friend Md5_lanes andnot(Md5_lanes a, Md5_lanes b) { return apply([](uint32_t x, uint32_t y) { return ~x & y; }, a, b); }
+  template< class Op > static Md5_lanes apply(Op op, Md5_lanes a, Md5_lanes b)
+  {
+    Md5_lanes r;
+    for (int i = 0; i < c_count; ++i)
+      r.v[i] = op(a.v[i], b.v[i]);
+    return r;
+  }
+  uint32_t v[4];
+};
+#endif
+
+using Md5_lanes_block = uint32_t[16][Md5_lanes::c_count]; // [word][lane]
+
+// Step I of the MD5 compression, for all lanes. Steps are unrolled at compile-time so that the shifts are immediates.
+template< int I >
+void md5_lanes_steps(Md5_lanes& a, Md5_lanes& b, Md5_lanes& c, Md5_lanes& d, const Md5_lanes_block& m)
+{
+  if constexpr (I < 64)
+  {
+    Md5_lanes f;
+    int g;
+    if constexpr (I < 16)
+    {
+      f = (b & c) | andnot(b, d);
+      g = I;
+    }
+    else if constexpr (I < 32)
+    {
+      f = (d & b) | andnot(d, c);
+      g = (I * 5 + 1) & 0x0f;
+    }
+    else if constexpr (I < 48)
+    {
+      f = b ^ c ^ d;
+      g = (I * 3 + 5) & 0x0f;
+    }
+    else
+    {
+      f = c ^ (b | andnot(d, Md5_lanes::set1(~0u)));
+      g = (I * 7) & 0x0f;
+    }
+    const auto t = d;
+    d = c;
+    c = b;
+    b = b + (a + f + Md5_lanes::set1(k[I]) + Md5_lanes::load(m[g])).template rotl< static_cast<int>(s[I]) >();
+    a = t;
+    md5_lanes_steps< I + 1 >(a, b, c, d, m);
+  }
+}
+
+// Number of 64-byte blocks of a padded message.
+uint64_t get_padded_block_count(size_t length)
+{
+  return (static_cast<uint64_t>(length) + 8) / 64 + 1;
+}
+
+// Block i of the padded message, as 16 little-endian words. 
+void get_padded_block(const uint8_t* data, size_t length, uint64_t i, uint32_t* out)
+{
+  uint8_t block[64] = {};
+  const uint64_t offset = i * 64;
+  if (offset < length)
+    std::memcpy(block, data + offset, static_cast<size_t>(std::min<uint64_t>(64, length - offset)));
+  if (offset <= length && length - offset < 64)
+    block[length - offset] = 0x80;
+  if (i + 1 == get_padded_block_count(length))
+  {
+    auto message_bits = static_cast<uint64_t>(length) << 3;
+    boost::endian::native_to_little_inplace(message_bits);
+    std::memcpy(block + 56, &message_bits, 8);
+  }
+  std::memcpy(out, block, 64);
+  for (int w = 0; w < 16; ++w)
+    boost::endian::native_to_little_inplace(out[w]); // little-endian to native: the swap is its own inverse
+}
+
 }
 
 namespace i3slib
@@ -177,6 +324,73 @@ void Md5::hash(const uint8_t* data, size_t length, Digest& digest)
   hasher.finalize(digest);
 }
 
+//static
+void Md5::hash_n(const uint8_t* const* data, const size_t* lengths, size_t count, Digest* digests)
+{
+  if constexpr (!Md5_lanes::c_is_simd)
+  {
+    for (size_t i = 0; i < count; ++i)
+      hash(data[i], lengths[i], digests[i]);
+    return;
+  }
+
+  // Each lane hashes a message block by block and picks the next message when done, so that messages of different 
+  // lengths keep all the lanes busy.
+  constexpr int c_lanes = Md5_lanes::c_count;
+  uint32_t state[4][c_lanes];
+  Md5_lanes_block m;
+  size_t msg[c_lanes];
+  uint64_t block[c_lanes];
+  bool is_active[c_lanes];
+  size_t next = 0;
+  const auto start_next_message = [&](int lane)
+  {
+    is_active[lane] = next < count;
+    if (!is_active[lane])
+      return;
+    msg[lane] = next++;
+    block[lane] = 0;
+    for (int w = 0; w < 4; ++w)
+      state[w][lane] = c_init_state[w];
+  };
+  for (int lane = 0; lane < c_lanes; ++lane)
+    start_next_message(lane);
+
+  while (std::find(is_active, is_active + c_lanes, true) != is_active + c_lanes)
+  {
+    // transpose the current blocks:
+    for (int lane = 0; lane < c_lanes; ++lane)
+    {
+      uint32_t words[16] = {};
+      if (is_active[lane])
+        get_padded_block(data[msg[lane]], lengths[msg[lane]], block[lane], words);
+      for (int w = 0; w < 16; ++w)
+        m[w][lane] = words[w];
+    }
+
+    auto a = Md5_lanes::load(state[0]);
+    auto b = Md5_lanes::load(state[1]);
+    auto c = Md5_lanes::load(state[2]);
+    auto d = Md5_lanes::load(state[3]);
+    md5_lanes_steps< 0 >(a, b, c, d, m);
+    (Md5_lanes::load(state[0]) + a).store(state[0]);
+    (Md5_lanes::load(state[1]) + b).store(state[1]);
+    (Md5_lanes::load(state[2]) + c).store(state[2]);
+    (Md5_lanes::load(state[3]) + d).store(state[3]);
+
+    for (int lane = 0; lane < c_lanes; ++lane)
+    {
+      if (!is_active[lane] || ++block[lane] < get_padded_block_count(lengths[msg[lane]]))
+        continue;
+      uint32_t dig[4] = { state[0][lane], state[1][lane], state[2][lane], state[3][lane] };
+      for (auto& word : dig)
+        boost::endian::native_to_little_inplace(word); // the digest is the little-endian state
+      std::memcpy(digests[msg[lane]].data(), dig, sizeof(dig));
+      start_next_message(lane);
+    }
+  }
+}
+
 //static
 std::string Md5::to_string(const Digest& digest)
 {
@@ -275,7 +489,7 @@ void Md5::process_chunk_(const uint32_t* m)
 void Md5::process_chunk_(const uint8_t* data)
 {
   // TODO: add endianness support.
-  std::memcpy(m_chunk_buffer.data(), data, 4);
+  std::memcpy(m_chunk_buffer.data(), data, 64);
   process_chunk_(m_chunk_buffer.data());
 }
 
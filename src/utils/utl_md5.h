@@ -60,6 +60,11 @@ public:
   /// \brief Compute MD5 digest in a single step.
   static void hash(const uint8_t* data, size_t length, Digest& digest);
 
+  /// \brief Compute the MD5 digests of count independent messages ( digests[i] of data[i] ). Same results as hash(), 
+  /// but messages are interleaved in SIMD lanes ( 4 with SSE2, 8 with AVX2, 16 with AVX-512, depending on the 
+  /// compilation target ), which is much faster for many short messages ( e.g. archive paths ).
+  static void hash_n(const uint8_t* const* data, const size_t* lengths, size_t count, Digest* digests);
+
   static std::string to_string(const Digest& digest);
   static bool        from_string(const std::string& in, Md5::Digest& out);
 private:
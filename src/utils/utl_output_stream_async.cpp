@@ -0,0 +1,458 @@
+/*
+Copyright 2020 Esri
+
+Licensed under the Apache License, Version 2.0 (the "License"); you may not use
+this file except in compliance with the License. You may obtain a copy of
+the License at http://www.apache.org/licenses/LICENSE-2.0
+Unless required by applicable law or agreed to in writing, software distributed
+under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+CONDITIONS OF ANY KIND, either express or implied. See the License for the
+specific language governing permissions and limitations under the License.
+
+For additional information, contact:
+Environmental Systems Research Institute, Inc.
+Attn: Contracts Dept
+380 New York Street
+Redlands, California, USA 92373
+email: contracts@esri.com
+*/
+
+#include "pch.h"
+#include "utils/utl_slpk_writer_api.h"
+#include "utils/utl_platform_def.h"
+#include "utils/utl_i3s_assert.h"
+#include "utils/utl_lock.h"
+#include "utils/utl_fs.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <share.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+#endif
+
+namespace i3slib
+{
+
+namespace utl
+{
+
+namespace detail
+{
+
+//-----------------------------------------------------------------------
+// class Raw_file : minimal unbuffered file handle used by the I/O thread.
+//-----------------------------------------------------------------------
+
+class Raw_file
+{
+public:
+  Raw_file() = default;
+  ~Raw_file() { close(); }
+  Raw_file(const Raw_file&) = delete;
+  Raw_file& operator=(const Raw_file&) = delete;
+
+  bool    open(const std::filesystem::path& path, bool is_append);
+  // Once the file is opened, try to bypass the OS page cache. Returns false if not supported.
+  bool    enable_direct_io();
+  bool    disable_direct_io();
+  bool    write(const char* data, size_t n_bytes);
+  bool    sync();
+  bool    seek_end();
+  int64_t size() const;
+  bool    close();
+  bool    is_open() const { return m_fd != -1; }
+
+private:
+  int m_fd = -1;
+};
+
+#ifdef _WIN32
+
+bool Raw_file::open(const std::filesystem::path& path, bool is_append)
+{
+  const int flags = _O_BINARY | _O_WRONLY | _O_CREAT | (is_append ? 0 : _O_TRUNC);
+  if (_wsopen_s(&m_fd, path.c_str(), flags, _SH_DENYWR, _S_IREAD | _S_IWRITE) != 0)
+  {
+    m_fd = -1;
+    return false;
+  }
+  return _lseeki64(m_fd, 0, SEEK_END) >= 0;
+}
+
+// Unbuffered I/O on Windows requires a different open mode (FILE_FLAG_NO_BUFFERING) which
+// is not available through the CRT.
+bool Raw_file::enable_direct_io() { return false; }
+bool Raw_file::disable_direct_io() { return true; }
+
+bool Raw_file::write(const char* data, size_t n_bytes)
+{
+  while (n_bytes)
+  {
+    const auto n = static_cast<unsigned int>(std::min<size_t>(n_bytes, 1u << 30));
+    const int written = _write(m_fd, data, n);
+    if (written <= 0)
+      return false;
+    data += written;
+    n_bytes -= written;
+  }
+  return true;
+}
+
+bool Raw_file::sync() { return _commit(m_fd) == 0; }
+bool Raw_file::seek_end() { return _lseeki64(m_fd, 0, SEEK_END) >= 0; }
+int64_t Raw_file::size() const { return _filelengthi64(m_fd); }
+
+bool Raw_file::close()
+{
+  if (m_fd == -1)
+    return true;
+  const bool ok = _close(m_fd) == 0;
+  m_fd = -1;
+  return ok;
+}
+
+#else
+
+bool Raw_file::open(const std::filesystem::path& path, bool is_append)
+{
+  const int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (is_append ? 0 : O_TRUNC);
+  m_fd = ::open(path.c_str(), flags, 0666);
+  if (m_fd == -1)
+    return false;
+  return ::lseek(m_fd, 0, SEEK_END) >= 0;
+}
+
+bool Raw_file::enable_direct_io()
+{
+#ifdef O_DIRECT
+  const int flags = ::fcntl(m_fd, F_GETFL);
+  return flags != -1 && ::fcntl(m_fd, F_SETFL, flags | O_DIRECT) == 0;
+#else
+  return false;
+#endif
+}
+
+bool Raw_file::disable_direct_io()
+{
+#ifdef O_DIRECT
+  const int flags = ::fcntl(m_fd, F_GETFL);
+  return flags != -1 && ::fcntl(m_fd, F_SETFL, flags & ~O_DIRECT) == 0;
+#else
+  return true;
+#endif
+}
+
+bool Raw_file::write(const char* data, size_t n_bytes)
+{
+  while (n_bytes)
+  {
+    const auto written = ::write(m_fd, data, n_bytes);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    if (written == 0)
+      return false;
+    data += written;
+    n_bytes -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+bool Raw_file::sync()
+{
+#if defined(__APPLE__)
+  return ::fsync(m_fd) == 0;
+#else
+  return ::fdatasync(m_fd) == 0;
+#endif
+}
+
+bool Raw_file::seek_end() { return ::lseek(m_fd, 0, SEEK_END) >= 0; }
+
+int64_t Raw_file::size() const
+{
+  struct stat st;
+  return ::fstat(m_fd, &st) == 0 ? static_cast<int64_t>(st.st_size) : -1;
+}
+
+bool Raw_file::close()
+{
+  if (m_fd == -1)
+    return true;
+  const bool ok = ::close(m_fd) == 0;
+  m_fd = -1;
+  return ok;
+}
+
+#endif
+
+//-----------------------------------------------------------------------
+// class Output_stream_async
+//-----------------------------------------------------------------------
+
+//! Write-behind output stream.
+//! - write() copies into the current block of a ring of large aligned blocks. Full blocks are handed over to a
+//!   dedicated I/O thread, so the caller only blocks when all the blocks are in flight.
+//! - I/O errors are sticky: they are reported by fail()/good() on the next call and after close().
+//! - Not thread-safe (same as std::ofstream): a single writer is expected. Slpk_writer_impl serializes the calls.
+class Output_stream_async final : public Output_stream
+{
+public:
+  static constexpr size_t c_io_alignment = 4096;
+
+  Output_stream_async(const std::filesystem::path& path, std::ios_base::openmode mode, const Output_stream_async_params& params);
+  ~Output_stream_async() override { close(); }
+  Output_stream_async(const Output_stream_async&) = delete;
+  Output_stream_async& operator=(const Output_stream_async&) = delete;
+
+  // --- Output_stream: ---
+  virtual int64_t  tellp() override { return m_is_failed ? -1 : m_pos; }
+  virtual void     close() noexcept override;
+  virtual bool     fail() const override { return m_is_failed; }
+  virtual bool     good() const override { return !m_is_failed; }
+  virtual Output_stream& write(const char* raw_bytes, std::streamsize count) override;
+  virtual int64_t  splice_file(const std::filesystem::path& src, int64_t n_bytes) override;
+
+private:
+  struct Block
+  {
+    char*  data = nullptr;
+    size_t size = 0;
+  };
+
+  [[nodiscard]] bool _submit_current();
+  void _io_loop() noexcept;
+  bool _write_block(const Block& block);
+
+  std::filesystem::path   m_path;
+  Raw_file                m_file;
+  std::vector<Block>      m_blocks;
+  Block*                  m_cur = nullptr;   // block being filled by the caller.
+  std::deque<Block*>      m_full;            // blocks waiting for the I/O thread.
+  std::vector<Block*>     m_free;
+  std::mutex              m_mutex;
+  std::condition_variable m_cv_full;
+  std::condition_variable m_cv_free;
+  std::thread             m_io_thread;
+  std::atomic<bool>       m_is_failed{ false };
+  bool                    m_is_stopping = false;
+  bool                    m_is_direct = false;
+  size_t                  m_block_size = 0;
+  int                     m_sync_every_n_blocks = 0;
+  int                     m_blocks_since_sync = 0;
+  int64_t                 m_pos = 0;         // logical position, as seen by the caller.
+};
+
+Output_stream_async::Output_stream_async(
+  const std::filesystem::path& path,
+  std::ios_base::openmode mode,
+  const Output_stream_async_params& params)
+  : m_path(path)
+  , m_block_size((std::max<size_t>(params.block_size, c_io_alignment) + c_io_alignment - 1) & ~(c_io_alignment - 1))
+  , m_sync_every_n_blocks(params.sync_every_n_blocks)
+{
+  const bool is_append = (mode & (std::ios::app | std::ios::ate)) != 0;
+  if (!m_file.open(path, is_append) || (m_pos = m_file.size()) < 0)
+  {
+    m_is_failed = true;
+    return;
+  }
+
+  // Direct I/O requires aligned file offsets. When appending to an unaligned file, stay buffered.
+  if (params.direct_io && (m_pos % c_io_alignment) == 0)
+    m_is_direct = m_file.enable_direct_io();
+
+  const int block_count = std::max(params.block_count, 2);
+  m_blocks.resize(block_count);
+  m_free.reserve(block_count);
+  for (auto& b : m_blocks)
+  {
+    b.data = static_cast<char*>(_aligned_malloc(m_block_size, c_io_alignment));
+    if (!b.data)
+    {
+      m_is_failed = true;
+      return;
+    }
+    m_free.push_back(&b);
+  }
+  m_cur = m_free.back();
+  m_free.pop_back();
+
+  m_io_thread = std::thread(&Output_stream_async::_io_loop, this);
+}
+
+Output_stream& Output_stream_async::write(const char* raw_bytes, std::streamsize count)
+{
+  if (!m_cur)
+  {
+    // closed or failed.
+    m_is_failed = true;
+    return *this;
+  }
+  while (count > 0)
+  {
+    const auto n = std::min<size_t>(static_cast<size_t>(count), m_block_size - m_cur->size);
+    memcpy(m_cur->data + m_cur->size, raw_bytes, n);
+    m_cur->size += n;
+    m_pos += n;
+    raw_bytes += n;
+    count -= n;
+    if (m_cur->size == m_block_size && !_submit_current())
+      break;
+  }
+  return *this;
+}
+
+bool Output_stream_async::_submit_current()
+{
+  Unique_lock lk(m_mutex);
+  m_full.push_back(m_cur);
+  m_cur = nullptr;
+  m_cv_full.notify_one();
+  m_cv_free.wait(lk, [this]() { return !m_free.empty() || m_is_failed; });
+  if (m_is_failed)
+    return false;
+  m_cur = m_free.back();
+  m_free.pop_back();
+  return true;
+}
+
+int64_t Output_stream_async::splice_file(const std::filesystem::path& src, int64_t n_bytes)
+{
+  if (!m_cur)
+    return 0;
+
+  // Drain the ring, so the I/O thread is idle and the file is up to date:
+  Unique_lock lk(m_mutex);
+  if (m_cur->size)
+  {
+    m_full.push_back(m_cur);
+    m_cur = nullptr;
+    m_cv_full.notify_one();
+  }
+  m_cv_free.wait(lk, [this]() { return m_free.size() + (m_cur ? 1 : 0) == m_blocks.size() || m_is_failed; });
+  if (m_is_failed)
+    return 0;
+  if (!m_cur)
+  {
+    m_cur = m_free.back();
+    m_free.pop_back();
+  }
+
+  const auto n_copied = append_file_range(m_path, src, 0, n_bytes);
+  if (n_copied)
+  {
+    m_pos += n_copied;
+    if (!m_file.seek_end())
+      m_is_failed = true;
+    // Next blocks won't be aligned on disk anymore:
+    if (m_is_direct)
+    {
+      m_file.disable_direct_io();
+      m_is_direct = false;
+    }
+  }
+  return n_copied;
+}
+
+bool Output_stream_async::_write_block(const Block& block)
+{
+  if (block.size == m_block_size || !m_is_direct)
+    return m_file.write(block.data, block.size);
+
+  // Last (partial) block in direct mode: write the unaligned tail through the page cache.
+  return m_file.disable_direct_io() && m_file.write(block.data, block.size);
+}
+
+void Output_stream_async::_io_loop() noexcept
+{
+  for (;;)
+  {
+    Block* block = nullptr;
+    {
+      Unique_lock lk(m_mutex);
+      m_cv_full.wait(lk, [this]() { return !m_full.empty() || m_is_stopping; });
+      if (m_full.empty())
+        return;
+      block = m_full.front();
+      m_full.pop_front();
+    }
+
+    if (!m_is_failed)
+    {
+      bool is_ok = _write_block(*block);
+      if (is_ok && m_sync_every_n_blocks > 0 && ++m_blocks_since_sync >= m_sync_every_n_blocks)
+      {
+        is_ok = m_file.sync();
+        m_blocks_since_sync = 0;
+      }
+      if (!is_ok)
+        m_is_failed = true;
+    }
+
+    {
+      Lock_guard lk(m_mutex);
+      block->size = 0;
+      m_free.push_back(block);
+    }
+    m_cv_free.notify_one();
+  }
+}
+
+void Output_stream_async::close() noexcept
+{
+  if (m_io_thread.joinable())
+  {
+    {
+      Lock_guard lk(m_mutex);
+      if (m_cur && m_cur->size)
+        m_full.push_back(m_cur);
+      m_cur = nullptr;
+      m_is_stopping = true;
+    }
+    m_cv_full.notify_one();
+    m_io_thread.join();
+
+    if (!m_is_failed && m_sync_every_n_blocks > 0 && !m_file.sync())
+      m_is_failed = true;
+  }
+  m_cur = nullptr;
+  if (!m_file.close())
+    m_is_failed = true;
+
+  for (auto& b : m_blocks)
+    _aligned_free(b.data);
+  m_blocks.clear();
+  m_free.clear();
+  m_full.clear();
+}
+
+} // namespace detail
+
+Output_stream* create_output_stream_async(
+  const std::filesystem::path& path,
+  std::ios_base::openmode mode,
+  const Output_stream_async_params& params)
+{
+  return new detail::Output_stream_async(path, mode, params);
+}
+
+} // namespace utl
+
+} // namespace i3slib
@@ -21,6 +21,7 @@ email: contracts@esri.com
 #include "utils/utl_png.h"
 #include "utils/utl_colors.h"
 #include <stdint.h>
+#include <algorithm>
 #include <cstring>
 
 #include <iostream>
@@ -29,6 +30,9 @@ email: contracts@esri.com
 
 #define PNG_DEBUG 3
 #include "libpng/png.h"
+#ifdef USE_LIBDEFLATE
+#include "libdeflate.h"
+#endif
 
 namespace i3slib
 {
@@ -107,148 +111,9 @@ void read_png_from_buffer_tpl(png_structp png_ptr, png_bytep out_bytes,
 //bool read_png_from_buffer(const std::string& input, int* out_w, int* out_h, std::vector<char>* out) 
 
 
-static bool decode_png_internal(void* src_object, read_png_custom_fct read_png_fct,  Buffer_view<char>* out
-                           , int* out_w, int* out_h, bool* has_alpha=nullptr
-                           , int output_channel_count=4
-                           , int dst_byte_alignment=0
-                           )
+//! Pixel layout of the decoded rows: 8-bit RGBA for color images, 16-bit (little-endian, inverted) or 8-bit gray otherwise.
+static void set_read_transforms(png_structp png_ptr, png_infop info_ptr, int color_type, int bit_depth)
 {
-  I3S_ASSERT_EXT(output_channel_count == 4); //TODO
-
-  png_structp png_ptr;
-  png_infop info_ptr;
-  unsigned int sig_read = 0;
-  png_uint_32 width, height;
-  int bit_depth, color_type, interlace_type;
-
-
-  /* Create and initialize the png_struct with the desired error handler
-  * functions.  If you want to use the default stderr and longjump method,
-  * you can supply NULL for the last three parameters.  We also supply the
-  * the compiler header file version, so that we know if the application
-  * was compiled with a compatible version of the library.  REQUIRED
-  */
-  png_voidp user_error_ptr = nullptr;
-  png_error_ptr user_error_fn = nullptr;
-  png_error_ptr user_warning_fn = nullptr;
-  png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,
-                                   /*png_voidp*/user_error_ptr, user_error_fn, user_warning_fn);
-
-  if (png_ptr == NULL)
-  {
-    //fclose(fp);
-    return false;
-  }
-
-  /* Allocate/initialize the memory for image information.  REQUIRED. */
-  info_ptr = png_create_info_struct(png_ptr);
-  if (info_ptr == NULL)
-  {
-    //fclose(fp);
-    png_destroy_read_struct(&png_ptr, nullptr, nullptr);
-    return false;
-  }
-
-  /* Set error handling if you are using the setjmp/longjmp method (this is
-  * the normal method of doing things with libpng).  REQUIRED unless you
-  * set up your own error handlers in the png_create_read_struct() earlier.
-  */
-
-  if (setjmp(png_jmpbuf(png_ptr)))
-  {
-    /* Free all of the memory associated with the png_ptr and info_ptr */
-    png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
-    //fclose(fp);
-    /* If we get here, we had a problem reading the file */
-    return false;
-  }
-
-  /* One of the following I/O initialization methods is REQUIRED */
-  //#ifdef streams /* PNG file I/O method 1 */
-  ///* Set up the input control if you are using standard C streams */
-  //png_init_io(png_ptr, fp);
-
-  //#else no_streams /* PNG file I/O method 2 */
-    /* If you are using replacement read functions, instead of calling
-    * png_init_io() here you would call:
-    */
-    png_set_read_fn(png_ptr, src_object, read_png_fct);
-    /* where user_io_ptr is a structure you want available to the callbacks */
-  //#endif no_streams /* Use only one I/O method! */
-
-  /* If we have already read some of the signature */
-  png_set_sig_bytes(png_ptr, sig_read);
-
-//#define hilevel 1;
-#ifdef hilevel
-  png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type,
-               &interlace_type, nullptr, nullptr);
-  //copy to output:
-  if (out_h)
-    *out_h = height;
-  if (out_w)
-
-    *out_w = width;
-
-  if (has_alpha)
-    *has_alpha = true;
-  /*
-  * If you have enough memory to read in the entire image at once,
-  * and you need to specify only transforms that can be controlled
-  * with one of the PNG_TRANSFORM_* bits (this presently excludes
-  * dithering, filling, setting background, and doing gamma
-  * adjustment), then you can read the entire image (including
-  * pixels) into the info structure with this call:
-  */
-  auto png_transforms = PNG_TRANSFORM_IDENTITY;
-  png_read_png(png_ptr, info_ptr, png_transforms, nullptr/*png_voidp_NULL*/);
-#else
-  /* OK, you're doing it the hard way, with the lower-level functions */
-
-  /* The call to png_read_info() gives us all of the information from the
-  * PNG file before the first IDAT (image data chunk).  REQUIRED
-  */
-  png_read_info(png_ptr, info_ptr);
-
-  png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type,
-               &interlace_type, nullptr, nullptr);
-  //copy to output:
-  if (out_h)
-    *out_h = height;
-  if (out_w)
-    *out_w = width;
-
-  if (has_alpha)
-  {
-    //TBD:
-    //PNG supports transparency in two(or three) quite different ways :
-    //Truecolor or grayscale images with a separated alpha channel(RGBA or GA)
-    //  Transparency extra info in the(optional) tRNS chunk.Which has two different flavors :
-    //2a.For indexed images : the tRNS chunk specifies a transparency value("alpha") for one, several or all the palette indexes.
-    //  2b.For truecolor or grayscale images : the tRNS chunk specifies a single color value(RGB or Gray) that should be considered as fully transparent.
-    //  If you are interested in case 2a, and if you are using libpng, you should look at the function png_get_tRNS()
-
-    if (color_type == PNG_COLOR_TYPE_RGBA || color_type == PNG_COLOR_TYPE_GA)
-      *has_alpha = true;
-    else
-    {
-      png_bytep trans_alpha = NULL;
-      int num_trans = 0;
-      png_color_16p trans_color = NULL;
-
-      png_get_tRNS(png_ptr, info_ptr, &trans_alpha, &num_trans, &trans_color);
-      if (trans_alpha != NULL)
-        *has_alpha = true;
-      else
-        *has_alpha = false;
-    }
-  }
-
-  if (!out)
-  {
-    png_destroy_read_struct(&png_ptr, &info_ptr, nullptr); // clean-up
-    return true; //just getting the size...
-  }
   /* Set up the data transformations you want.  Note that these are all
   * optional.  Only call them if you want/need them.  Many of the
   * transformations only work on specific types of images, and many
@@ -415,6 +280,151 @@ static bool decode_png_internal(void* src_object, read_png_custom_fct read_png_f
   /* Add filler (or alpha) byte (before/after each RGB triplet) */
   if (color_type != PNG_COLOR_TYPE_GRAY)
     png_set_filler(png_ptr, 0xff, PNG_FILLER_AFTER);
+}
+
+static bool decode_png_internal(void* src_object, read_png_custom_fct read_png_fct,  Buffer_view<char>* out
+                           , int* out_w, int* out_h, bool* has_alpha=nullptr
+                           , int output_channel_count=4
+                           , int dst_byte_alignment=0
+                           )
+{
+  I3S_ASSERT_EXT(output_channel_count == 4); //TODO
+
+  png_structp png_ptr;
+  png_infop info_ptr;
+  unsigned int sig_read = 0;
+  png_uint_32 width, height;
+  int bit_depth, color_type, interlace_type;
+
+
+  /* Create and initialize the png_struct with the desired error handler
+  * functions.  If you want to use the default stderr and longjump method,
+  * you can supply NULL for the last three parameters.  We also supply the
+  * the compiler header file version, so that we know if the application
+  * was compiled with a compatible version of the library.  REQUIRED
+  */
+  png_voidp user_error_ptr = nullptr;
+  png_error_ptr user_error_fn = nullptr;
+  png_error_ptr user_warning_fn = nullptr;
+  png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,
+                                   /*png_voidp*/user_error_ptr, user_error_fn, user_warning_fn);
+
+  if (png_ptr == NULL)
+  {
+    //fclose(fp);
+    return false;
+  }
+
+  /* Allocate/initialize the memory for image information.  REQUIRED. */
+  info_ptr = png_create_info_struct(png_ptr);
+  if (info_ptr == NULL)
+  {
+    //fclose(fp);
+    png_destroy_read_struct(&png_ptr, nullptr, nullptr);
+    return false;
+  }
+
+  /* Set error handling if you are using the setjmp/longjmp method (this is
+  * the normal method of doing things with libpng).  REQUIRED unless you
+  * set up your own error handlers in the png_create_read_struct() earlier.
+  */
+
+  if (setjmp(png_jmpbuf(png_ptr)))
+  {
+    /* Free all of the memory associated with the png_ptr and info_ptr */
+    png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+    //fclose(fp);
+    /* If we get here, we had a problem reading the file */
+    return false;
+  }
+
+  /* One of the following I/O initialization methods is REQUIRED */
+  //#ifdef streams /* PNG file I/O method 1 */
+  ///* Set up the input control if you are using standard C streams */
+  //png_init_io(png_ptr, fp);
+
+  //#else no_streams /* PNG file I/O method 2 */
+    /* If you are using replacement read functions, instead of calling
+    * png_init_io() here you would call:
+    */
+    png_set_read_fn(png_ptr, src_object, read_png_fct);
+    /* where user_io_ptr is a structure you want available to the callbacks */
+  //#endif no_streams /* Use only one I/O method! */
+
+  /* If we have already read some of the signature */
+  png_set_sig_bytes(png_ptr, sig_read);
+
+//#define hilevel 1;
+#ifdef hilevel
+  png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type,
+               &interlace_type, nullptr, nullptr);
+  //copy to output:
+  if (out_h)
+    *out_h = height;
+  if (out_w)
+
+    *out_w = width;
+
+  if (has_alpha)
+    *has_alpha = true;
+  /*
+  * If you have enough memory to read in the entire image at once,
+  * and you need to specify only transforms that can be controlled
+  * with one of the PNG_TRANSFORM_* bits (this presently excludes
+  * dithering, filling, setting background, and doing gamma
+  * adjustment), then you can read the entire image (including
+  * pixels) into the info structure with this call:
+  */
+  auto png_transforms = PNG_TRANSFORM_IDENTITY;
+  png_read_png(png_ptr, info_ptr, png_transforms, nullptr/*png_voidp_NULL*/);
+#else
+  /* OK, you're doing it the hard way, with the lower-level functions */
+
+  /* The call to png_read_info() gives us all of the information from the
+  * PNG file before the first IDAT (image data chunk).  REQUIRED
+  */
+  png_read_info(png_ptr, info_ptr);
+
+  png_get_IHDR(png_ptr, info_ptr, &width, &height, &bit_depth, &color_type,
+               &interlace_type, nullptr, nullptr);
+  //copy to output:
+  if (out_h)
+    *out_h = height;
+  if (out_w)
+    *out_w = width;
+
+  if (has_alpha)
+  {
+    //TBD:
+    //PNG supports transparency in two(or three) quite different ways :
+    //Truecolor or grayscale images with a separated alpha channel(RGBA or GA)
+    //  Transparency extra info in the(optional) tRNS chunk.Which has two different flavors :
+    //2a.For indexed images : the tRNS chunk specifies a transparency value("alpha") for one, several or all the palette indexes.
+    //  2b.For truecolor or grayscale images : the tRNS chunk specifies a single color value(RGB or Gray) that should be considered as fully transparent.
+    //  If you are interested in case 2a, and if you are using libpng, you should look at the function png_get_tRNS()
+
+    if (color_type == PNG_COLOR_TYPE_RGBA || color_type == PNG_COLOR_TYPE_GA)
+      *has_alpha = true;
+    else
+    {
+      png_bytep trans_alpha = NULL;
+      int num_trans = 0;
+      png_color_16p trans_color = NULL;
+
+      png_get_tRNS(png_ptr, info_ptr, &trans_alpha, &num_trans, &trans_color);
+      if (trans_alpha != NULL)
+        *has_alpha = true;
+      else
+        *has_alpha = false;
+    }
+  }
+
+  if (!out)
+  {
+    png_destroy_read_struct(&png_ptr, &info_ptr, nullptr); // clean-up
+    return true; //just getting the size...
+  }
+  set_read_transforms(png_ptr, info_ptr, color_type, bit_depth);
 
   /* Turn on interlace handling.  REQUIRED if you are not using
   * png_read_image().  To see how to handle interlacing passes,
@@ -729,6 +739,113 @@ bool Png_writer::write_file(const std::filesystem::path& path, int w, int h, con
   return Png_writer_impl::write_file(path, w, h, buffer, n_bytes);
 }
 
+class Png_reader_impl
+{
+public:
+  Png_reader_impl() = default;
+  ~Png_reader_impl() { _close(); }
+  bool open(const std::filesystem::path& file_name, int* out_w, int* out_h, int* out_bytes_per_pixel);
+  bool read_rows(int n_rows, char* buffer, int n_bytes);
+
+private:
+  void      _close();
+
+  FILE* m_file = nullptr;
+  int m_h = 0;
+  int m_y0 = 0;
+  size_t m_row_size = 0;
+  png_structp m_png_ptr = nullptr;
+  png_infop m_info_ptr = nullptr;
+};
+
+//! Reads the header and sets up the same transformations as read_png_from_file().
+bool Png_reader_impl::open(const std::filesystem::path& file_name, int* out_w, int* out_h, int* out_bytes_per_pixel)
+{
+  _close();
+  if (fopen(m_file, file_name, "rb"))
+    return false;
+
+  m_png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+  if (!m_png_ptr)
+    return false;
+  m_info_ptr = png_create_info_struct(m_png_ptr);
+  if (!m_info_ptr)
+    return false;
+  if (setjmp(png_jmpbuf(m_png_ptr)))
+    return false;
+
+  png_init_io(m_png_ptr, m_file);
+  png_read_info(m_png_ptr, m_info_ptr);
+
+  png_uint_32 width, height;
+  int bit_depth, color_type, interlace_type;
+  png_get_IHDR(m_png_ptr, m_info_ptr, &width, &height, &bit_depth, &color_type, &interlace_type, nullptr, nullptr);
+
+  // interlaced images cannot be read a few rows at a time:
+  if (interlace_type != PNG_INTERLACE_NONE)
+    return false;
+
+  set_read_transforms(m_png_ptr, m_info_ptr, color_type, bit_depth);
+  png_read_update_info(m_png_ptr, m_info_ptr);
+
+  m_h = static_cast<int>(height);
+  m_y0 = 0;
+  m_row_size = png_get_rowbytes(m_png_ptr, m_info_ptr);
+  if (out_w)
+    *out_w = static_cast<int>(width);
+  if (out_h)
+    *out_h = m_h;
+  if (out_bytes_per_pixel)
+    *out_bytes_per_pixel = static_cast<int>(m_row_size / width);
+  return true;
+}
+
+// Read the next (contiguous) rows of the image. Rows are complete ( num columns = image width ).
+bool Png_reader_impl::read_rows(int n_rows, char* buffer, int n_bytes)
+{
+  if (!m_png_ptr || m_y0 + n_rows > m_h || static_cast<size_t>(n_bytes) < m_row_size * n_rows)
+    return false;
+
+  std::vector< png_bytep > rows(n_rows);
+  for (int i = 0; i < n_rows; i++)
+    rows[i] = reinterpret_cast<png_bytep>(buffer) + i * m_row_size;
+
+  if (setjmp(png_jmpbuf(m_png_ptr)))
+    return false;
+  png_read_rows(m_png_ptr, rows.data(), nullptr, static_cast<png_uint_32>(n_rows));
+  m_y0 += n_rows;
+  return true;
+}
+
+void Png_reader_impl::_close()
+{
+  if (m_png_ptr)
+    png_destroy_read_struct(&m_png_ptr, m_info_ptr ? &m_info_ptr : nullptr, nullptr);
+  m_png_ptr = nullptr;
+  m_info_ptr = nullptr;
+  if (m_file)
+    fclose(m_file);
+  m_file = nullptr;
+}
+
+
+Png_reader::Png_reader()
+{
+  m_pimpl = std::make_unique<Png_reader_impl>();
+}
+
+Png_reader::~Png_reader() = default;
+
+bool Png_reader::open(const std::filesystem::path& file_name, int* out_w, int* out_h, int* out_bytes_per_pixel)
+{
+  return m_pimpl->open(file_name, out_w, out_h, out_bytes_per_pixel);
+}
+
+bool Png_reader::read_rows(int n_rows, char* buffer, int n_bytes)
+{
+  return m_pimpl->read_rows(n_rows, buffer, n_bytes);
+}
+
 // A simple test function to create a gradient image:
 namespace test
 {
@@ -782,11 +899,230 @@ private:
   png_structp m_png_write_struct = nullptr;
 };
 
+int to_png_filters(Png_encoding_params::Filter filter)
+{
+  switch (filter)
+  {
+    case Png_encoding_params::Filter::None:     return PNG_FILTER_NONE;
+    case Png_encoding_params::Filter::Sub:      return PNG_FILTER_SUB;
+    case Png_encoding_params::Filter::Up:       return PNG_FILTER_UP;
+    case Png_encoding_params::Filter::Average:  return PNG_FILTER_AVG;
+    case Png_encoding_params::Filter::Paeth:    return PNG_FILTER_PAETH;
+    default:                                    return PNG_ALL_FILTERS;
+  }
 }
 
-I3S_EXPORT bool encode_png(const uint8_t* raw_bytes, int w, int h, bool has_alpha, std::vector<uint8_t>& png_bytes)
+#ifdef USE_LIBDEFLATE
+
+// PNG filter types ( the byte starting each filtered row ):
+constexpr uint8_t c_filter_none = 0;
+constexpr uint8_t c_filter_sub = 1;
+constexpr uint8_t c_filter_up = 2;
+constexpr uint8_t c_filter_average = 3;
+constexpr uint8_t c_filter_paeth = 4;
+constexpr uint8_t c_filter_type_count = 5;
+
+uint8_t paeth_predictor(int a, int b, int c)
+{
+  const int p = a + b - c;
+  const int pa = std::abs(p - a);
+  const int pb = std::abs(p - b);
+  const int pc = std::abs(p - c);
+  if (pa <= pb && pa <= pc)
+    return static_cast<uint8_t>(a);
+  return static_cast<uint8_t>(pb <= pc ? b : c);
+}
+
+//! prev is the unfiltered previous row ( all zeros for the first row ).
+void filter_row(uint8_t type, const uint8_t* row, const uint8_t* prev, size_t stride, size_t bpp, uint8_t* out)
+{
+  *(out++) = type;
+  switch (type)
+  {
+    case c_filter_none:
+      std::memcpy(out, row, stride);
+      break;
+    case c_filter_sub:
+      std::memcpy(out, row, bpp);
+      for (size_t i = bpp; i < stride; ++i)
+        out[i] = row[i] - row[i - bpp];
+      break;
+    case c_filter_up:
+      for (size_t i = 0; i < stride; ++i)
+        out[i] = row[i] - prev[i];
+      break;
+    case c_filter_average:
+      for (size_t i = 0; i < bpp; ++i)
+        out[i] = row[i] - (prev[i] >> 1);
+      for (size_t i = bpp; i < stride; ++i)
+        out[i] = row[i] - static_cast<uint8_t>((row[i - bpp] + prev[i]) >> 1);
+      break;
+    case c_filter_paeth:
+      for (size_t i = 0; i < bpp; ++i)
+        out[i] = row[i] - prev[i];
+      for (size_t i = bpp; i < stride; ++i)
+        out[i] = row[i] - paeth_predictor(row[i - bpp], prev[i], prev[i - bpp]);
+      break;
+    default:
+      I3S_ASSERT(false);
+      break;
+  }
+}
+
+//! Same heuristic as libpng's: minimum sum of the absolute values of the filtered bytes ( as signed ).
+size_t get_filter_cost(const uint8_t* filtered, size_t stride)
+{
+  size_t cost = 0;
+  for (size_t i = 0; i < stride; ++i)
+    cost += static_cast<size_t>(std::abs(static_cast<int>(static_cast<int8_t>(filtered[i]))));
+  return cost;
+}
+
+//! Filtered image data ( a filter type byte before each row ) into out.
+void filter_rows(const uint8_t* raw_bytes, int h, size_t stride, size_t bpp, Png_encoding_params::Filter filter, uint8_t* out)
+{
+  const std::vector<uint8_t> zero_row(stride, 0);
+  std::vector<uint8_t> candidate(filter == Png_encoding_params::Filter::Adaptive ? stride + 1 : 0);
+  const uint8_t* prev = zero_row.data();
+  for (int y = 0; y < h; ++y, out += stride + 1)
+  {
+    const uint8_t* row = raw_bytes + y * stride;
+    if (filter != Png_encoding_params::Filter::Adaptive)
+      filter_row(static_cast<uint8_t>(static_cast<int>(filter) - 1), row, prev, stride, bpp, out);
+    else
+    {
+      filter_row(c_filter_none, row, prev, stride, bpp, out);
+      size_t best_cost = get_filter_cost(out + 1, stride);
+      for (uint8_t type = c_filter_sub; type < c_filter_type_count; ++type)
+      {
+        filter_row(type, row, prev, stride, bpp, candidate.data());
+        const auto cost = get_filter_cost(candidate.data() + 1, stride);
+        if (cost < best_cost)
+        {
+          best_cost = cost;
+          std::memcpy(out, candidate.data(), stride + 1);
+        }
+      }
+    }
+    prev = row;
+  }
+}
+
+void write_u32_be(uint8_t* dst, uint32_t v)
+{
+  dst[0] = static_cast<uint8_t>(v >> 24);
+  dst[1] = static_cast<uint8_t>(v >> 16);
+  dst[2] = static_cast<uint8_t>(v >> 8);
+  dst[3] = static_cast<uint8_t>(v);
+}
+
+//! The chunk data must already be at dst + 8. Returns the end of the chunk.
+uint8_t* finalize_chunk(uint8_t* dst, const char* type, size_t size)
+{
+  write_u32_be(dst, static_cast<uint32_t>(size));
+  std::memcpy(dst + 4, type, 4);
+  write_u32_be(dst + 8 + size, libdeflate_crc32(0, dst + 4, size + 4));
+  return dst + 12 + size;
+}
+
+struct Libdeflate_compressor
+{
+  ~Libdeflate_compressor()
+  {
+    if (compressor)
+      libdeflate_free_compressor(compressor);
+  }
+  libdeflate_compressor*  compressor = nullptr;
+  int                     level = -1;
+};
+
+//! Compressors are expensive to allocate ( large hash tables ), so one is kept per thread.
+libdeflate_compressor* get_thread_compressor(int level)
+{
+  thread_local Libdeflate_compressor t_compressor;
+  if (t_compressor.compressor && t_compressor.level != level)
+  {
+    libdeflate_free_compressor(t_compressor.compressor);
+    t_compressor.compressor = nullptr;
+  }
+  if (!t_compressor.compressor)
+  {
+    t_compressor.compressor = libdeflate_alloc_compressor(level);
+    t_compressor.level = level;
+  }
+  return t_compressor.compressor;
+}
+
+//! Writes the PNG stream directly: the whole filtered image is deflated in one call into a single IDAT chunk.
+bool encode_png_libdeflate(const uint8_t* raw_bytes, int w, int h, bool has_alpha, const Png_encoding_params& params, std::vector<uint8_t>& png_bytes)
+{
+  static const uint8_t c_signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  constexpr size_t c_ihdr_size = 13;
+
+  auto* compressor = get_thread_compressor(params.zlib_level < 0 ? 6 : std::min(params.zlib_level, 9));
+  if (!compressor)
+    return false;
+
+  const size_t bpp = has_alpha ? 4 : 3;
+  const size_t stride = static_cast<size_t>(w) * bpp;
+  std::vector<uint8_t> filtered((stride + 1) * h);
+  filter_rows(raw_bytes, h, stride, bpp, params.filter, filtered.data());
+
+  const auto max_idat_size = libdeflate_zlib_compress_bound(compressor, filtered.size());
+  png_bytes.resize(sizeof(c_signature) + (12 + c_ihdr_size) + (12 + max_idat_size) + 12);
+  uint8_t* dst = png_bytes.data();
+  std::memcpy(dst, c_signature, sizeof(c_signature));
+  dst += sizeof(c_signature);
+
+  write_u32_be(dst + 8, static_cast<uint32_t>(w));
+  write_u32_be(dst + 12, static_cast<uint32_t>(h));
+  dst[16] = 8; // bit depth
+  dst[17] = has_alpha ? PNG_COLOR_TYPE_RGBA : PNG_COLOR_TYPE_RGB;
+  dst[18] = PNG_COMPRESSION_TYPE_DEFAULT;
+  dst[19] = PNG_FILTER_TYPE_DEFAULT;
+  dst[20] = PNG_INTERLACE_NONE;
+  dst = finalize_chunk(dst, "IHDR", c_ihdr_size);
+
+  const auto idat_size = libdeflate_zlib_compress(compressor, filtered.data(), filtered.size(), dst + 8, max_idat_size);
+  if (!idat_size)
+    return false;
+  dst = finalize_chunk(dst, "IDAT", idat_size);
+  dst = finalize_chunk(dst, "IEND", 0);
+
+  png_bytes.resize(dst - png_bytes.data());
+  return true;
+}
+
+#endif // USE_LIBDEFLATE
+
+}
+
+Png_encoding_params get_png_encoding_params(Png_encoding_preset preset)
+{
+  Png_encoding_params params;
+  switch (preset)
+  {
+    case Png_encoding_preset::Fast:
+      params.zlib_level = 1;
+      params.filter = Png_encoding_params::Filter::Up;
+      break;
+    case Png_encoding_preset::Small:
+      params.zlib_level = 9;
+      break;
+    default:
+      break;
+  }
+  return params;
+}
+
+I3S_EXPORT bool encode_png(const uint8_t* raw_bytes, int w, int h, bool has_alpha, std::vector<uint8_t>& png_bytes
+                           , const Png_encoding_params& params)
 {
   png_bytes.clear();
+#ifdef USE_LIBDEFLATE
+  if (params.use_libdeflate)
+    return encode_png_libdeflate(raw_bytes, w, h, has_alpha, params, png_bytes);
+#endif
 
   std::unique_ptr<png_struct, Png_write_struct_deleter> png(
     png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL));
@@ -816,6 +1152,10 @@ I3S_EXPORT bool encode_png(const uint8_t* raw_bytes, int w, int h, bool has_alph
   png_set_IHDR(png.get(), info.get(), w, h, 8,
     has_alpha ? PNG_COLOR_TYPE_RGBA : PNG_COLOR_TYPE_RGB,
     PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+  if (params.zlib_level >= 0)
+    png_set_compression_level(png.get(), std::min(params.zlib_level, 9));
+  if (params.filter != Png_encoding_params::Filter::Adaptive)
+    png_set_filter(png.get(), PNG_FILTER_TYPE_BASE, to_png_filters(params.filter));
 
   png_set_rows(png.get(), info.get(), rows.data());
   png_set_write_fn(png.get(), &png_bytes, write_callback, NULL);
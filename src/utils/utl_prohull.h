@@ -63,6 +63,10 @@ namespace utl
     int base_vector_size;           // number of directions
     int base_obb_size;              // number of base OBBs
 
+    // independent direction triples: the planes dir[i].x = pi, dir[j].x = pj, dir[k].x = pk meet at pi * a + pj * b + pk * c
+    struct Triple { int i, j, k; Vec3d a, b, c; };
+    std::vector<Triple> triples;
+
     Pro_set();                       // constructor
     Pro_set( Polyhedron base);       // constructor
 
@@ -87,6 +91,10 @@ namespace utl
 
   public:
     enum class Method :int  { Minimal_diameter=0, Minimal_surface_area=1, Minimal_volume=2 };
+    // how get_box() bounds the hull along a candidate axis: 
+    //   Intervals - combination of the projection intervals of the 3 closest independent directions ( cheap, looser ),
+    //   Convexoid - vertices of the slab polytope, and the convexoid axes as an additional candidate ( tighter on flat geometry, 20-30x slower ).
+    enum class Fit :int { Intervals = 0, Convexoid = 1 };
     explicit Pro_hull(const Pro_set* proset = Pro_set::get_default());
     // calculate convexoid OBB for a set of points. 
     void get_ball_box(const std::vector<Vec3d>& points
@@ -96,6 +104,16 @@ namespace utl
     }    
     void get_ball_box(const Vec3d* points, int count
       , Obb_abs& obb, double& radius, Method method = Pro_hull::Method::Minimal_surface_area);
+    // get_ball_box() leaves the hull of the points, so that hulls of neighboring objects can be merged:
+    void clear();
+    bool is_empty() const;              // true if no point has been added
+    void add(const Pro_hull& h);        // add a hull ( of the same projection set )
+    void add(const Vec3d& vector);    // add a point
+    // calculate an OBB of the hull: the best of the fixed OBB set ( if any, exact for the hull ) and of the OBBs aligned with
+    // one of the boxes ( or with the convexoid, for Fit::Convexoid ), bounding both the boxes and the hull. The boxes must contain
+    // the points of the hull ( count > 0 if there is no fixed OBB set ).
+    void get_box(const Obb_abs* boxes, int count, Obb_abs& obb, Method method = Pro_hull::Method::Minimal_surface_area
+      , Fit fit = Fit::Intervals) const;
 
   private:
     friend class Bvh_builder;
@@ -104,13 +122,12 @@ namespace utl
     Pro_hull(const Pro_set* proset, const Vec3d& vector);
 
     //----------------------------------------------------------------------------------------------------------
-    void clear();
-
     double center(int dir) const;      // middle value of projection for a direction
     double extent(int dir) const;      // size of projection for a direction
 
-    void add(const Pro_hull& h);        // add a hull
-    void add(const Vec3d& vector);    // add a point
+    void translate(const Vec3d& offset);  // move all the points of the hull
+    void get_slab_vertices(const Vec3d& origin, std::vector<Vec3d>& vertices) const;  // vertices of the polytope bounded by the projection slabs ( relative to origin )
+    bool get_interval_bounds(const Vec3d& axis, double& min_proj, double& max_proj) const;  // bounds of the projection of the hull on a unit axis
 
     int principal_dimension_max() const;      // calculate principal dimension using maximal projection direction
     int principal_dimension_pca() const;      // calculate principal dimension using some variation of PCA ( Principal Componet Analysis )
@@ -137,7 +154,8 @@ namespace utl
     int convex_edge_roll(int vindex0, int vindex1);
     int convex_face_roll(int vindex0, int vindex1, int vindex2);
 
-    double get_metrics(Method method, Vec3d&  extent);
+    static double get_metrics(Method method, const Vec3d& extent);
+    void get_obb_axes(Method method, Vec3d obb_axis[3]);  // OBB axes aligned with the faces of the convexoid
     void get_extrema(const Vec3d& dir, double &min_proj, double &max_proj, Vec3d& min_vertex, Vec3d& max_vertex); // extermal slab of convexoid for direction
     void get_projection_fold( const Vec3d& normal, const Vec3d& dir, std::vector<Vec3d>& fold); // calculate a projection fold of convexoid for a direction
     void get_convexoid_faces(std::vector<Vec3i>& faces);    // construct faces of inner convexoid
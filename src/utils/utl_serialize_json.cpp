@@ -21,6 +21,7 @@ email: contracts@esri.com
 #include "utils/utl_serialize_json.h"
 #include "utils/utl_variant.h"
 #include "utils/utl_base64.h"
+#include <algorithm>
 
 namespace i3slib
 {
@@ -200,6 +201,13 @@ void Archive_out_json::_save_variant(const Variant& v)
   else
     (*m_out) << v.to_string();
 }
+void Archive_out_json::_save_string_view(std::string_view v)
+{
+  if (std::none_of(v.begin(), v.end(), [](char c) { return is_special(c) != static_cast<size_t>(-1); }))
+    (*m_out) << '\"' << v << '\"';
+  else
+    (*m_out) << '\"' << escape_special_char_for_json(std::string(v)) << '\"';
+}
 void Archive_out_json::_save_unparsed_node(Unparsed_field& node)
 {
   if (node.raw.empty())
@@ -64,6 +64,7 @@ namespace utl
     int     _open_sequence(); // returns the number of values in the array
     int     _read_seq_separator(); // you can be used to iterate over both arrays and dictionaries
     void    _load_variant(Variant& v);
+    bool    _load_string_view(std::string_view* v); // false if the current value isn't a string
     //int     _load_array_size() override  { return -1; } //not supported. use utl::seq instead.
     //void    _load_array(char* ptr, int n_bytes) override { I3S_ASSERT(false); } //implement it if you need it
     void    _load_binary_blob(Binary_blob& blob)
@@ -352,6 +353,14 @@ namespace utl
     return sb.GetString();
   }
 
+  bool Archive_in_json_dom_impl::_load_string_view(std::string_view* v)
+  {
+    if (!m_current->IsString())
+      return false;
+    *v = std::string_view(m_current->GetString(), m_current->GetStringLength());
+    return true;
+  }
+
   void Archive_in_json_dom_impl::_load_variant(Variant& v)
   {
     if (m_current->IsNull())
@@ -748,6 +757,7 @@ bool  Archive_in_json_dom::_close_tag_name(const char* name) { return  m_impl->_
 int   Archive_in_json_dom::_open_sequence() { return m_impl->_open_sequence(); }
 int   Archive_in_json_dom::_read_seq_separator() { return m_impl->_read_seq_separator(); }
 void  Archive_in_json_dom::_load_variant(Variant& v) { return m_impl->_load_variant(v); }
+void  Archive_in_json_dom::_load_string_view(std::string_view* v) { if (!m_impl->_load_string_view(v)) Archive_in::_load_string_view(v); }
 //int   Archive_in_json_dom::_load_array_size() { I3S_ASSERT_EXT(false);  return -1; } //not supported. use utl::seq instead.
 //void  Archive_in_json_dom::_loadArray(char* ptr, int nBytes) { I3S_ASSERT_EXT(false); } //implement it if you need it
 void  Archive_in_json_dom::_load_binary_blob(Binary_blob& blob) { m_impl->_load_binary_blob(blob); }
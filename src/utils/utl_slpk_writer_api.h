@@ -23,6 +23,7 @@ email: contracts@esri.com
 #include "utils/utl_mime.h"
 #include <stdint.h>
 #include <filesystem>
+#include <functional>
 
 namespace i3slib
 {
@@ -40,6 +41,18 @@ public:
   virtual bool     fail() const = 0;
   virtual bool     good() const = 0;
   virtual Output_stream& write(const char* raw_bytes, std::streamsize count) = 0;
+  //! Append the first n_bytes of a regular file without going through user-space buffers, if supported.
+  //! Returns the number of bytes appended (0 by default). Caller must write() the remainder.
+  virtual int64_t  splice_file(const std::filesystem::path& src, int64_t n_bytes) { return 0; }
+};
+
+//! Settings for the write-behind output stream (see create_output_stream_async()).
+struct Output_stream_async_params
+{
+  size_t block_size = 8 * 1024 * 1024; // rounded up to a multiple of 4KB.
+  int    block_count = 4;               // number of blocks in the ring ( at least 2 ).
+  bool   direct_io = false;             // use O_DIRECT when supported by the OS and the filesystem. Ignored otherwise.
+  int    sync_every_n_blocks = 0;       // if > 0, fdatasync() after this many blocks and on close(). 
 };
 
 /*!
@@ -59,6 +72,11 @@ public:
     On_destruction_keep_unfinalized_to_reopen = 2, // In destructor temporary files will be preserved.
                                                    // Allows SLPK being re-opened
                                                    // with Unfinalized_only flag to keep adding files later on. 
+    Write_behind = 4, // Archive is written in large blocks by a dedicated I/O thread (see create_output_stream_async()).
+                      // I/O errors are reported by the next append_file() or by finalize().
+    Update_existing = 8, // Open a **finalized** SLPK to add or replace files. Existing files are never rewritten: replaced ones are 
+                         // left out of the new central directory and index (use compact_slpk() to reclaim the space). 
+                         // cancel() restores the original archive. Not compatible with On_destruction_keep_unfinalized_to_reopen.
     Overwrite_if_exists_and_cancel_in_destructor = 0 // default.
   };
   DECL_PTR(Slpk_writer);
@@ -66,6 +84,8 @@ public:
   // --- Slpk_writer: ---
   virtual bool    create_archive(const std::filesystem::path& path, Create_flags flags = Create_flag::Overwrite_if_exists_and_cancel_in_destructor) = 0;
   virtual bool    create_stream(Output_stream::ptr strm) { return false; }
+  //! Settings of the output stream of the next create_archive() with Create_flag::Write_behind. 
+  virtual void    set_write_behind_params(const Output_stream_async_params& params) {}
 
   virtual bool append_file(
     const std::string& archive_Path,
@@ -76,6 +96,14 @@ public:
 #if 0 // deprecated TBD
   virtual bool    get_file(const std::string& archive_Path, std::string* content) =0;
 #endif
+  //! Append all the files of a **finalized** SLPK without repacking them: the payload region is copied as-is (in-kernel when possible),
+  //! central directory entries and hash index are merged with their offsets shifted. 
+  //! Files for which is_excluded(path) returns true are left out of the central directory and index (their bytes are still copied).
+  //! Output is deterministic for a given sequence of calls. Returns false if src is not a valid SLPK or on I/O error.
+  virtual bool    append_archive(const std::filesystem::path& src, const std::function<bool(const std::string&)>& is_excluded = nullptr) { return false; }
+  //! Create_flag::Update_existing only: read a file of the archive as it was before the update. 
+  //! path_in_archive includes the extension. Returns false if not found.
+  virtual bool    get_existing_file(const std::string& path_in_archive, std::string* content) { return false; }
   virtual bool    finalize()  = 0;
   virtual bool    cancel() noexcept = 0; // removes all temporary files or returns false if failed or unsupported
   
@@ -89,6 +117,18 @@ Slpk_writer* create_file_slpk_writer(const std::filesystem::path& path);
 I3S_EXPORT Slpk_writer*   create_slpk_writer(const std::string& dst_path = std::string());
 I3S_EXPORT Output_stream* create_output_stream_std(std::filesystem::path path, std::ios_base::openmode mode); //for unit-testing.
 
+//! Copy the files of a finalized SLPK that are referenced by its central directory, dropping everything else
+//! ( e.g. files replaced using Slpk_writer::Create_flag::Update_existing ).
+I3S_EXPORT bool           compact_slpk(const std::filesystem::path& src, const std::filesystem::path& dst);
+
+//! Write-behind stream: write() copies into a ring of large aligned blocks which are flushed to disk by a dedicated I/O thread.
+//! Caller only blocks when all blocks are in flight. I/O errors are sticky and reported by fail() on the next call and after close().
+//! mode: std::ios::app or std::ios::ate to append to an existing file, truncate otherwise.
+I3S_EXPORT Output_stream* create_output_stream_async(
+  const std::filesystem::path& path, 
+  std::ios_base::openmode mode, 
+  const Output_stream_async_params& params = {});
+
 } // namespace utl
 
 } // namespace i3slib
@@ -27,8 +27,14 @@ email: contracts@esri.com
 #include "utils/utl_slpk_writer_factory.h"
 #include <stdint.h>
 #include <vector>
+#include <deque>
 #include <fstream>
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_set>
 
 namespace i3slib
 {
@@ -59,6 +65,47 @@ static bool  copy_stream(std::istream* src, Output_stream_t* dest, uint64_t n_by
   return !src->fail() && dest->good() && !dest->fail();
 }
 
+//! Central directory entries are written the same way as _append_file_no_lock() does: 64-bit offset always goes to the extra field.
+static void  set_cd_hdr_offset(detail::Cd_hdr* hdr, uint64_t offset)
+{
+  hdr->offset = offset;
+  hdr->raw.rel_offset = detail::c_ones_32;
+  hdr->raw.comment_length = 0;
+  hdr->raw.extra_length = static_cast<uint16_t>(hdr->raw.packed_size == detail::c_ones_32
+    ? sizeof(detail::Extra_field_64_big_file_with_offset) : sizeof(detail::Extra_field_64_offset_only));
+}
+
+//! Number of paths hashed at once when an archive index has to be rebuilt ( see Md5::hash_n() ).
+static constexpr size_t c_hash_batch_size = 1024;
+
+//! Read the hash index of a finalized archive if it's consistent with its central directory. 
+static bool  read_hash_index(std::istream* in, const detail::End_of_cd_64& eocd, std::vector< detail::Hashed_offset >* out)
+{
+  out->clear();
+  detail::Cd_hdr hdr;
+  in->seekg(eocd.offset_cd);
+  for (uint64_t i = 0; i < eocd.num_entries_total; ++i)
+  {
+    if (!hdr.read_it(in))
+      return false;
+    if (hdr.path != detail::c_hash_table_file_name)
+      continue;
+    if (hdr.size64 != (eocd.num_entries_total - 1) * sizeof(detail::Hashed_offset))
+      return false;
+    detail::Local_file_hdr loc_hdr;
+    uint64_t size = 0;
+    if (!loc_hdr.read(in, hdr.offset, &size, &hdr.path) || size != hdr.size64)
+      return false;
+    out->resize(static_cast<size_t>(size / sizeof(detail::Hashed_offset)));
+    in->read(reinterpret_cast<char*>(out->data()), out->size() * sizeof(detail::Hashed_offset));
+    if (!in->fail())
+      return true;
+    out->clear();
+    return false;
+  }
+  return false;
+}
+
 //-----------------------------------------------------------------------
 // class Scoped_temp_folder
 //-----------------------------------------------------------------------
@@ -102,13 +149,23 @@ class  Output_stream_std : public Output_stream
 {
 public:
   DECL_PTR(Output_stream);
-  Output_stream_std(std::filesystem::path path, std::ios_base::openmode mode) : m_ofs(path, mode) {}
+  Output_stream_std(std::filesystem::path path, std::ios_base::openmode mode) : m_path(path), m_ofs(path, mode) {}
   virtual int64_t  tellp() override { return m_ofs.tellp(); }
   virtual void     close() noexcept override { return m_ofs.close(); }
   virtual bool     fail() const override { return m_ofs.fail(); }
   virtual bool     good() const override { return m_ofs.good(); }
   virtual Output_stream& write(const char* raw_bytes, std::streamsize count) override { m_ofs.write(raw_bytes, count); return *this; }
+  virtual int64_t  splice_file(const std::filesystem::path& src, int64_t n_bytes) override
+  {
+    if (!m_ofs.flush().good())
+      return 0;
+    const auto n_copied = append_file_range(m_path, src, 0, n_bytes);
+    if (n_copied)
+      m_ofs.seekp(0, std::ios::end); // file has grown behind our back.
+    return n_copied;
+  }
 private:
+  std::filesystem::path m_path;
   std::ofstream m_ofs;
 };
 //-----------------------------------------------------------------------
@@ -138,6 +195,7 @@ public:
   void    destroy();
   bool    finalize_index(const char** ptr, int64_t* size);
   int64_t   find_file(std::string* path_in_archive); // returns -1 on failure.
+  bool    contains(const Md5::Digest& h);
 private:
   bool _load_to_sysmem();
 
@@ -184,6 +242,15 @@ int64_t Slpk_writer_index::find_file(std::string* path_in_archive)
   return  found->offset;
 }
 
+bool Slpk_writer_index::contains(const Md5::Digest& h)
+{
+  if (!_load_to_sysmem())
+    return false;
+  const auto key = Hashed_offset(h, 0);
+  const auto found = std::lower_bound(m_pending.cbegin(), m_pending.cend(), key);
+  return found != m_pending.cend() && found->path_key == h;
+}
+
 bool Slpk_writer_index::load(const std::filesystem::path& index_path, int64_t slpk_pending_size, int64_t cd_pending_size)
 {
   //open stream:
@@ -316,10 +383,13 @@ public:
   // --- Slpk_writer: ---
   virtual bool    create_archive(const std::filesystem::path& path, Create_flags flags) override;
   virtual bool    create_stream(Output_stream::ptr strm) override;
+  virtual void    set_write_behind_params(const Output_stream_async_params& params) override { Lock_guard lk(m_mutex); m_write_behind_params = params; }
   virtual bool    append_file(const std::string& path_in_archive, const char* buffer, int n_bytes, Mime_type type, Mime_encoding pack) override;
 #if 0 // deprecated TBD
   virtual bool    get_file(const std::string& path_in_archive, std::string* content) override;
 #endif
+  virtual bool    append_archive(const std::filesystem::path& src, const std::function<bool(const std::string&)>& is_excluded) override;
+  virtual bool    get_existing_file(const std::string& path_in_archive, std::string* content) override;
   virtual bool    finalize()  override { Lock_guard lk(m_mutex); return _finalize_no_lock(); }
   virtual bool    cancel() noexcept override { Lock_guard lk(m_mutex); return _cancel_no_lock(); }
   virtual bool    close_unfinalized() noexcept override { Lock_guard lk(m_mutex); return _close_unfinalized_no_lock(); }
@@ -330,11 +400,13 @@ private:
   [[ nodiscard ]]
   uint64_t _append_file_no_lock(std::string && clean_path_in_archive, const char* buffer, size_t n_bytes, const uint32_t crc)noexcept;
 
-  void    _init() { m_path.clear(); m_ar = nullptr; m_tmp = std::fstream(); m_index.init_index(); m_flags = Create_flag::Overwrite_if_exists_and_cancel_in_destructor; }
+  void    _init() { m_path.clear(); m_ar = nullptr; m_tmp = std::fstream(); m_index.init_index(); m_flags = Create_flag::Overwrite_if_exists_and_cancel_in_destructor; m_existing_size = 0; }
   bool    _finalize_no_lock() noexcept;
   bool    _cancel_no_lock() noexcept;
   bool    _close_unfinalized_no_lock() noexcept;
+  bool    _merge_existing_cd_no_lock();
   bool    _create_archive_no_lock(const std::filesystem::path& path, Create_flags flags, Output_stream::ptr strm);
+  Output_stream::ptr _create_output_stream(const std::filesystem::path& path, std::ios_base::openmode mode) const;
 
   std::filesystem::path     m_path; //Path of the SLPK as provided by caller
   //std::fstream              m_ar;
@@ -343,6 +415,9 @@ private:
   mutable Slpk_writer_index m_index;
   mutable std::mutex        m_mutex;
   Create_flags              m_flags = Create_flag::Overwrite_if_exists_and_cancel_in_destructor;
+  Output_stream_async_params m_write_behind_params; // Create_flag::Write_behind only.
+  detail::End_of_cd_64      m_existing_cd;       // Update_existing only.
+  int64_t                   m_existing_size = 0; // Update_existing only: size of the archive before update.
   // must be last member:
   Scoped_temp_folder        m_temp_folder_for_stream_artifacts; // not use for regular filesystem slpk archives.
 };
@@ -422,6 +497,18 @@ bool Slpk_writer_impl::create_stream(Output_stream::ptr strm)
   return _create_archive_no_lock(path, Create_flag::Overwrite_if_exists_and_cancel_in_destructor, strm);
 }
 
+bool  Slpk_writer_impl::get_existing_file(const std::string& path_in_archive, std::string* content)
+{
+  Lock_guard lk(m_mutex);
+  if (!(m_flags & Create_flag::Update_existing) || m_path.empty())
+    return false;
+  // the original archive is the unchanged beginning of the pending one:
+  auto slpk_path = m_path;
+  slpk_path += I3S_T(".pending");
+  std::ifstream in(slpk_path, std::ios::binary);
+  return in.good() && detail::read_stored_file(&in, m_existing_cd, path_in_archive, content);
+}
+
 bool  Slpk_writer_impl::create_archive(const std::filesystem::path& path, Create_flags flags)
 {
   Lock_guard lk(m_mutex);
@@ -432,6 +519,13 @@ bool  Slpk_writer_impl::create_archive(const std::filesystem::path& path, Create
   return _create_archive_no_lock(path, flags, nullptr);
 }
 
+Output_stream::ptr Slpk_writer_impl::_create_output_stream(const std::filesystem::path& path, std::ios_base::openmode mode) const
+{
+  if (m_flags & Create_flag::Write_behind)
+    return Output_stream::ptr(create_output_stream_async(path, mode, m_write_behind_params));
+  return std::make_shared< Output_stream_std>(path, mode);
+}
+
 bool  Slpk_writer_impl::_create_archive_no_lock(const std::filesystem::path& path, Create_flags flags, Output_stream::ptr strm)
 {
 
@@ -453,7 +547,7 @@ bool  Slpk_writer_impl::_create_archive_no_lock(const std::filesystem::path& pat
     I3S_ASSERT(!strm);
     //look for an "unfinalized" SLPK:
     //m_ar = std::ofstream(slpk_path, std::ios::binary | std::ios::out | std::ios::in |std::ios::ate);
-    m_ar = std::make_shared< Output_stream_std>(slpk_path, std::ios::binary | std::ios::out | std::ios::ate | std::ios::app);
+    m_ar = _create_output_stream(slpk_path, std::ios::binary | std::ios::out | std::ios::ate | std::ios::app);
     m_tmp = std::fstream(tmp_cd_path, std::ios::binary | std::ios::out | std::ios::in | std::ios::ate);
     if (_is_io_fail() || !m_index.load(tmp_index_path, m_ar->tellp(), m_tmp.tellp()))
     {
@@ -461,6 +555,43 @@ bool  Slpk_writer_impl::_create_archive_no_lock(const std::filesystem::path& pat
       return false;
     }
   }
+  else if (flags & Create_flag::Update_existing)
+  {
+    I3S_ASSERT(!strm);
+    if (flags & Create_flag::On_destruction_keep_unfinalized_to_reopen)
+    {
+      I3S_ASSERT(false); // existing central directory is only merged by finalize(). 
+      _init();
+      return false;
+    }
+    {
+      std::ifstream in(path, std::ios::binary);
+      if (!in.good() || !detail::read_end_of_cd_64(&in, &m_existing_cd))
+      {
+        _init();
+        return false;
+      }
+      in.seekg(0, std::ios::end);
+      m_existing_size = in.tellg();
+    }
+    std::error_code err_code;
+    if (file_exists(slpk_path))
+      stdfs::remove(slpk_path, err_code);
+    stdfs::rename(path, slpk_path, err_code);
+    if (err_code)
+    {
+      _init();
+      return false;
+    }
+    // new files go after the existing end of central directory, so that cancel() can restore the original archive: 
+    m_ar = _create_output_stream(slpk_path, std::ios::binary | std::ios::out | std::ios::ate | std::ios::app);
+    m_tmp = std::fstream(tmp_cd_path, std::ios::binary | std::ios::out | std::ios::in | std::ios::trunc);
+    if (_is_io_fail())
+    {
+      _cancel_no_lock();
+      return false;
+    }
+  }
   else
   {
     std::error_code err_code;
@@ -479,7 +610,7 @@ bool  Slpk_writer_impl::_create_archive_no_lock(const std::filesystem::path& pat
     if (strm)
       m_ar = strm;
     else
-      m_ar = std::make_shared< Output_stream_std>(slpk_path, std::ios::binary | std::ios::out | std::ios::trunc);
+      m_ar = _create_output_stream(slpk_path, std::ios::binary | std::ios::out | std::ios::trunc);
     m_tmp = std::fstream(tmp_cd_path, std::ios::binary | std::ios::out | std::ios::in | std::ios::trunc);
     if (file_exists(tmp_index_path))
     {
@@ -554,6 +685,178 @@ uint64_t Slpk_writer_impl::_append_file_no_lock(
   return offset;
 }
 
+bool Slpk_writer_impl::append_archive(const std::filesystem::path& src, const std::function<bool(const std::string&)>& is_excluded)
+{
+  std::ifstream in(src, std::ios::binary);
+  detail::End_of_cd_64 eocd;
+  if (!in.good() || !detail::read_end_of_cd_64(&in, &eocd))
+    return false;
+
+  Lock_guard lk(m_mutex);
+  if (m_path.empty())
+    return false;
+
+  // --- payload region ( everything before the central directory ) is copied verbatim:
+  const uint64_t base = m_ar->tellp();
+  const auto n_spliced = static_cast<uint64_t>(std::max<int64_t>(m_ar->splice_file(src, eocd.offset_cd), 0));
+  I3S_ASSERT(n_spliced <= eocd.offset_cd);
+  in.seekg(n_spliced);
+  if (n_spliced != eocd.offset_cd && !copy_stream(&in, m_ar.get(), eocd.offset_cd - n_spliced))
+    return false;
+
+  // --- hash index: re-use the source one when it's consistent with the central directory, re-hash the paths otherwise:
+  std::vector< detail::Hashed_offset > src_index;
+  read_hash_index(&in, eocd, &src_index);
+  in.clear();
+
+  // --- central directory: shift offsets, drop the source index and excluded files:
+  std::vector< std::string > excluded_paths;
+  detail::Cd_hdr hdr;
+  in.seekg(eocd.offset_cd);
+  for (uint64_t i = 0; i < eocd.num_entries_total; ++i)
+  {
+    if (!hdr.read_it(&in) || hdr.offset >= eocd.offset_cd)
+      return false;
+    if (hdr.path == detail::c_hash_table_file_name)
+      continue;
+    if (is_excluded && is_excluded(hdr.path))
+    {
+      excluded_paths.push_back(std::move(hdr.path));
+      continue;
+    }
+    set_cd_hdr_offset(&hdr, hdr.offset + base);
+    hdr.write(&m_tmp);
+  }
+  if (_is_io_fail())
+    return false;
+
+  if (src_index.size())
+  {
+    std::vector< Md5::Digest > excluded(excluded_paths.size());
+    detail::hash_paths(excluded_paths.data(), excluded_paths.size(), excluded.data());
+    std::sort(excluded.begin(), excluded.end(), [](const Md5::Digest& a, const Md5::Digest& b) 
+    { 
+      return detail::Hashed_offset(a, 0) < detail::Hashed_offset(b, 0); 
+    });
+    for (const auto& e : src_index)
+    {
+      const auto found = std::lower_bound(excluded.begin(), excluded.end(), e.path_key, [](const Md5::Digest& a, const Md5::Digest& b)
+      {
+        return detail::Hashed_offset(a, 0) < detail::Hashed_offset(b, 0);
+      });
+      if (found == excluded.end() || *found != e.path_key)
+        m_index.add(e.path_key, e.offset + base);
+    }
+  }
+  else
+  {
+    std::vector< std::string > paths;
+    std::vector< uint64_t > offsets;
+    std::vector< Md5::Digest > hashes;
+    const auto add_batch = [&]()
+    {
+      hashes.resize(paths.size());
+      detail::hash_paths(paths.data(), paths.size(), hashes.data());
+      for (size_t j = 0; j < paths.size(); ++j)
+        m_index.add(hashes[j], offsets[j] + base);
+      paths.clear();
+      offsets.clear();
+    };
+    in.clear();
+    in.seekg(eocd.offset_cd);
+    for (uint64_t i = 0; i < eocd.num_entries_total; ++i)
+    {
+      if (!hdr.read_it(&in))
+        return false;
+      if (hdr.path != detail::c_hash_table_file_name && !(is_excluded && is_excluded(hdr.path)))
+      {
+        paths.push_back(std::move(hdr.path));
+        offsets.push_back(hdr.offset);
+        if (paths.size() == c_hash_batch_size)
+          add_batch();
+      }
+    }
+    add_batch();
+  }
+  return !_is_io_fail();
+}
+
+//! Update_existing: add the entries of the existing central directory that haven't been replaced. 
+//! Uses the existing hash index to identify them, so existing paths don't need to be re-hashed.
+bool Slpk_writer_impl::_merge_existing_cd_no_lock()
+{
+  auto pending_file_path = m_path;
+  pending_file_path += I3S_T(".pending");
+  std::ifstream in(pending_file_path, std::ios::binary); // existing part of the archive has not been modified.
+  std::vector< detail::Hashed_offset > existing_index;
+  read_hash_index(&in, m_existing_cd, &existing_index);
+  in.clear();
+
+  std::vector< detail::Hashed_offset > kept;
+  std::vector< uint64_t > replaced;
+  for (const auto& e : existing_index)
+  {
+    if (m_index.contains(e.path_key))
+      replaced.push_back(e.offset);
+    else
+      kept.push_back(e);
+  }
+  std::sort(replaced.begin(), replaced.end());
+
+  detail::Cd_hdr hdr;
+  in.seekg(m_existing_cd.offset_cd);
+  if (existing_index.empty())
+  {
+    // no index to re-use, paths are hashed by batches:
+    std::vector< detail::Cd_hdr > batch;
+    std::vector< std::string > paths;
+    std::vector< Md5::Digest > hashes;
+    const auto write_batch = [&]()
+    {
+      hashes.resize(paths.size());
+      detail::hash_paths(paths.data(), paths.size(), hashes.data());
+      for (size_t j = 0; j < batch.size(); ++j)
+      {
+        if (m_index.contains(hashes[j]))
+          continue;
+        kept.emplace_back(hashes[j], batch[j].offset);
+        batch[j].path = std::move(paths[j]);
+        set_cd_hdr_offset(&batch[j], batch[j].offset);
+        batch[j].write(&m_tmp);
+      }
+      batch.clear();
+      paths.clear();
+    };
+    for (uint64_t i = 0; i < m_existing_cd.num_entries_total; ++i)
+    {
+      if (!hdr.read_it(&in))
+        return false;
+      if (hdr.path == detail::c_hash_table_file_name)
+        continue;
+      paths.push_back(std::move(hdr.path));
+      batch.push_back(std::move(hdr));
+      if (batch.size() == c_hash_batch_size)
+        write_batch();
+    }
+    write_batch();
+  }
+  else
+  {
+    for (uint64_t i = 0; i < m_existing_cd.num_entries_total; ++i)
+    {
+      if (!hdr.read_it(&in))
+        return false;
+      if (hdr.path == detail::c_hash_table_file_name || std::binary_search(replaced.begin(), replaced.end(), hdr.offset))
+        continue;
+      set_cd_hdr_offset(&hdr, hdr.offset);
+      hdr.write(&m_tmp);
+    }
+  }
+  for (const auto& e : kept)
+    m_index.add(e.path_key, e.offset);
+  return !in.fail() && !_is_io_fail();
+}
+
 bool Slpk_writer_impl::_cancel_no_lock()noexcept
 {
   if (m_path.empty())
@@ -574,8 +877,20 @@ bool Slpk_writer_impl::_cancel_no_lock()noexcept
   }
   auto pending_file_path = m_path;
   pending_file_path += I3S_T(".pending");
-  is_deleted = utl::remove_file(pending_file_path);
-  I3S_ASSERT(is_deleted);
+  if (m_existing_size)
+  {
+    // restore the archive as it was before the update:
+    std::error_code err_code;
+    stdfs::resize_file(pending_file_path, static_cast<uintmax_t>(m_existing_size), err_code);
+    if (!err_code)
+      stdfs::rename(pending_file_path, m_path, err_code);
+    I3S_ASSERT(!err_code);
+  }
+  else
+  {
+    is_deleted = utl::remove_file(pending_file_path);
+    I3S_ASSERT(is_deleted);
+  }
 
   if (m_temp_folder_for_stream_artifacts)
     m_temp_folder_for_stream_artifacts.clear();
@@ -618,7 +933,7 @@ bool Slpk_writer_impl::_close_unfinalized_no_lock() noexcept
 bool Slpk_writer_impl::_finalize_no_lock()noexcept
 {
   bool is_ok = false;
-  if (!m_path.empty())
+  if (!m_path.empty() && (!m_existing_size || _merge_existing_cd_no_lock()))
   {
     const char* src_ptr;
     int64_t size;
@@ -635,9 +950,13 @@ bool Slpk_writer_impl::_finalize_no_lock()noexcept
       uint64_t offset_to_cd = m_ar->tellp();
       uint64_t cd_size = m_tmp.tellp();
       m_tmp.flush();
-      m_tmp.seekg(0);
-      //copy the tmp CD to the ZIP archive:
-      if (copy_stream(&m_tmp, m_ar.get(), cd_size))
+      //copy the tmp CD to the ZIP archive. Try an in-kernel copy first, then copy what's left (if any) through a buffer:
+      auto tmp_cd_path = m_path;
+      tmp_cd_path += I3S_T(".tmp");
+      const auto n_spliced = static_cast<uint64_t>(std::max<int64_t>(m_ar->splice_file(tmp_cd_path, cd_size), 0));
+      I3S_ASSERT(n_spliced <= cd_size);
+      m_tmp.seekg(n_spliced);
+      if (n_spliced == cd_size || copy_stream(&m_tmp, m_ar.get(), cd_size - n_spliced))
       {
         //add [zip64 end of central directory record]
         uint64_t offset_to_eocd64 = m_ar->tellp();
@@ -649,16 +968,16 @@ bool Slpk_writer_impl::_finalize_no_lock()noexcept
         //[end of central directory record]
         detail::End_of_cd_legacy the_end(total_file_count, cd_size, offset_to_cd);
         write_it(m_ar.get(), the_end);
+        // closing flushes any write-behind buffer, so check for I/O errors afterwards.
+        m_ar->close();
         if (m_ar->good() && !m_ar->fail())
         {
           m_tmp.close();
           std::error_code err_code;
 
-          auto tmp_file_path = m_path;
-          tmp_file_path += I3S_T(".tmp");
           {
             [[maybe_unused]]
-            auto is_deleted = utl::remove_file(tmp_file_path);
+            auto is_deleted = utl::remove_file(tmp_cd_path);
             I3S_ASSERT(is_deleted);
           }
 
@@ -667,7 +986,6 @@ bool Slpk_writer_impl::_finalize_no_lock()noexcept
 
           m_index.destroy();
           //rename:
-          m_ar->close();
           m_ar = nullptr;
           if (!m_temp_folder_for_stream_artifacts)
           {
@@ -691,6 +1009,151 @@ bool Slpk_writer_impl::_finalize_no_lock()noexcept
 }
 
 
+//-----------------------------------------------------------------------
+// class Folder_cache
+//-----------------------------------------------------------------------
+
+//! Thread-safe set of folders known to exist, so each folder is checked/created only once 
+//! (metadata operations are expensive on network filesystems).
+class Folder_cache
+{
+public:
+  bool create(const stdfs::path& dir);
+  void clear() { std::unique_lock lk(m_mutex); m_known.clear(); }
+private:
+  std::shared_mutex                               m_mutex;
+  std::unordered_set<stdfs::path::string_type>    m_known;
+};
+
+bool Folder_cache::create(const stdfs::path& dir)
+{
+  {
+    std::shared_lock lk(m_mutex);
+    if (m_known.count(dir.native()))
+      return true;
+  }
+  // if create_directory fails, check if it's because directory already exists (created in another thread)
+  if (!create_directory_recursively(dir) && !folder_exists(dir))
+    return false;
+
+  // the whole branch has been created at once, remember all the ancestors too:
+  std::unique_lock lk(m_mutex);
+  for (auto p = dir; p.has_relative_path() && m_known.insert(p.native()).second; p = p.parent_path())
+    ;
+  return true;
+}
+
+//-----------------------------------------------------------------------
+// class Async_file_writer
+//-----------------------------------------------------------------------
+
+//! Bounded pool of threads writing whole files. 
+//! write() blocks when more than max_pending_bytes are queued. Failures are sticky and reported by 
+//! the next write() or by wait().
+class Async_file_writer
+{
+public:
+  Async_file_writer(unsigned thread_count, size_t max_pending_bytes);
+  ~Async_file_writer();
+  Async_file_writer(const Async_file_writer&) = delete;
+  Async_file_writer& operator=(const Async_file_writer&) = delete;
+
+  bool write(stdfs::path path, const char* data, size_t n_bytes);
+  bool wait(); // waits for all pending writes to complete.
+private:
+  struct Task
+  {
+    stdfs::path path;
+    std::string content;
+  };
+  void _run() noexcept;
+
+  std::vector<std::thread>  m_threads;
+  std::deque<Task>          m_tasks;
+  std::mutex                m_mutex;
+  std::condition_variable   m_cv_task;
+  std::condition_variable   m_cv_done;
+  size_t                    m_pending_bytes = 0;
+  size_t                    m_max_pending_bytes;
+  int                       m_in_flight = 0;
+  bool                      m_is_stopping = false;
+  std::atomic<bool>         m_is_failed{ false };
+};
+
+Async_file_writer::Async_file_writer(unsigned thread_count, size_t max_pending_bytes)
+  : m_max_pending_bytes(max_pending_bytes)
+{
+  for (unsigned i = 0; i < std::max(thread_count, 1u); ++i)
+    m_threads.emplace_back(&Async_file_writer::_run, this);
+}
+
+Async_file_writer::~Async_file_writer()
+{
+  {
+    Lock_guard lk(m_mutex);
+    m_is_stopping = true;
+  }
+  m_cv_task.notify_all();
+  for (auto& t : m_threads)
+    t.join();
+}
+
+bool Async_file_writer::write(stdfs::path path, const char* data, size_t n_bytes)
+{
+  if (m_is_failed)
+    return false;
+  Task task{ std::move(path), std::string(data, n_bytes) };
+  {
+    Unique_lock lk(m_mutex);
+    // a single large file is let through if nothing else is pending.
+    m_cv_done.wait(lk, [&]() { return m_pending_bytes == 0 || m_pending_bytes + n_bytes <= m_max_pending_bytes || m_is_failed; });
+    m_pending_bytes += n_bytes;
+    m_tasks.push_back(std::move(task));
+  }
+  m_cv_task.notify_one();
+  return !m_is_failed;
+}
+
+bool Async_file_writer::wait()
+{
+  Unique_lock lk(m_mutex);
+  m_cv_done.wait(lk, [this]() { return m_tasks.empty() && m_in_flight == 0; });
+  return !m_is_failed;
+}
+
+void Async_file_writer::_run() noexcept
+{
+  for (;;)
+  {
+    Task task;
+    {
+      Unique_lock lk(m_mutex);
+      m_cv_task.wait(lk, [this]() { return !m_tasks.empty() || m_is_stopping; });
+      if (m_tasks.empty())
+        return;
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+      ++m_in_flight;
+    }
+    if (!m_is_failed && !write_file(task.path, task.content))
+      m_is_failed = true;
+    {
+      Lock_guard lk(m_mutex);
+      --m_in_flight;
+      m_pending_bytes -= task.content.size();
+    }
+    m_cv_done.notify_all();
+  }
+}
+
+//-----------------------------------------------------------------------
+// class Extracted_slpk_writer
+//-----------------------------------------------------------------------
+
+//! Writes an "extracted" SLPK (.eslpk), i.e. one file per resource in a folder hierarchy.
+//! With Create_flag::Write_behind, files are written by a bounded pool of I/O threads and I/O errors 
+//! are reported by the next append_file() or by finalize().
+//! this class is thread-safe.
 class Extracted_slpk_writer final : public Slpk_writer
 {
 public:
@@ -702,12 +1165,19 @@ public:
   virtual bool    get_file(const std::string& archivePath, std::string* content) override { return false; }
 #endif
   virtual bool    append_file(const std::string& archivePath, const char* buffer, int nBytes, Mime_type type = Mime_type::Not_set, Mime_encoding pack = Mime_encoding::Not_set) override;
-  virtual bool    finalize() override { m_dest.clear();  return true; }
+  virtual bool    finalize() override { return _close(); }
   virtual bool    cancel() noexcept override ; // clears the destination folder
-  virtual bool    close_unfinalized() noexcept override  { m_dest.clear();  return true; }
+  virtual bool    close_unfinalized() noexcept override  { return _close(); }
 private:
+  bool _close() noexcept;
+
+  static constexpr unsigned c_max_io_thread_count = 8;
+  static constexpr size_t   c_max_pending_bytes = 256 * 1024 * 1024;
+
   stdfs::path m_dest;
   Create_flags m_openning_flags = Overwrite_if_exists_and_cancel_in_destructor;
+  Folder_cache m_folders;
+  std::unique_ptr<Async_file_writer> m_async; // only if Create_flag::Write_behind
 };
 
 Extracted_slpk_writer::~Extracted_slpk_writer()
@@ -723,7 +1193,7 @@ bool Extracted_slpk_writer::create_archive(const std::filesystem::path& path, Cr
 {
   if (flags & Unfinalized_only)
   {
-    if (!folder_exists(m_dest))
+    if (!folder_exists(path))
       return false;
   }
   else
@@ -731,36 +1201,53 @@ bool Extracted_slpk_writer::create_archive(const std::filesystem::path& path, Cr
     // if destination exists, it must be empty.
     // directories will be created when extracting.
     std::error_code e;
-    if (folder_exists(m_dest) && (!std::filesystem::is_empty(m_dest, e) || e))
+    if (folder_exists(path) && (!std::filesystem::is_empty(path, e) || e))
       return false;
   }
   m_dest = path;
   m_openning_flags = flags;
+  m_folders.clear();
+  m_async.reset();
+  if (flags & Write_behind)
+  {
+    const auto thread_count = std::min(std::max(std::thread::hardware_concurrency(), 2u), c_max_io_thread_count);
+    m_async = std::make_unique<Async_file_writer>(thread_count, c_max_pending_bytes);
+  }
   return true;
 }
 
 bool Extracted_slpk_writer::append_file(const std::string& archivePath, const char* buffer, int nBytes, Mime_type type, Mime_encoding pack)
 {
-  const auto path_out = m_dest / archivePath;        // nodes/0/textures/0.jpg
-  const auto dir = std::filesystem::path(path_out).parent_path(); // nodes/0/textures
+  auto path_out = m_dest / archivePath;        // nodes/0/textures/0.jpg
   // check directory exists. Create if it doesn't.
-  if (!folder_exists(dir))
-  {
-    // if create_directory fails, check if it's because directory already exsists (created in another thread)
-    if (!create_directory_recursively(dir) && !folder_exists(dir))
-      return false;
-  }
+  if (!m_folders.create(path_out.parent_path())) // nodes/0/textures
+    return false;
   // append the file
+  if (m_async)
+    return m_async->write(std::move(path_out), buffer, nBytes);
   return write_file(path_out, buffer, nBytes);
 }
 
+bool Extracted_slpk_writer::_close() noexcept
+{
+  const bool is_ok = !m_async || m_async->wait();
+  m_async.reset();
+  m_dest.clear();
+  return is_ok;
+}
+
 bool Extracted_slpk_writer::cancel() noexcept
 {
   if (m_dest.empty())
     return true;
-  m_dest.clear();
+  if (m_async)
+  {
+    m_async->wait();
+    m_async.reset();
+  }
   std::error_code ec;
   stdfs::remove_all(m_dest, ec);
+  m_dest.clear();
   return !ec;
 }
 
@@ -773,6 +1260,40 @@ Output_stream* create_output_stream_std(std::filesystem::path path, std::ios_bas
 }//endof ::utl::detail
 
 
+bool utl::compact_slpk(const std::filesystem::path& src, const std::filesystem::path& dst)
+{
+  std::ifstream cd(src, std::ios::binary);
+  std::ifstream content(src, std::ios::binary);
+  detail::End_of_cd_64 eocd;
+  if (!cd.good() || !content.good() || !detail::read_end_of_cd_64(&cd, &eocd))
+    return false;
+
+  detail::Slpk_writer_impl writer;
+  if (!writer.create_archive(dst, Slpk_writer::Create_flag::Overwrite_if_exists_and_cancel_in_destructor))
+    return false;
+
+  detail::Cd_hdr hdr;
+  detail::Local_file_hdr loc_hdr;
+  std::vector< char > buffer;
+  cd.seekg(eocd.offset_cd);
+  for (uint64_t i = 0; i < eocd.num_entries_total; ++i)
+  {
+    if (!hdr.read_it(&cd))
+      return false;
+    if (hdr.path == detail::c_hash_table_file_name)
+      continue; // re-created by finalize()
+    uint64_t size = 0;
+    if (hdr.raw.compression_type != 0 || !loc_hdr.read(&content, hdr.offset, &size, &hdr.path)
+      || size > static_cast<uint64_t>(std::numeric_limits<int>::max()))
+      return false;
+    buffer.resize(static_cast<size_t>(size));
+    content.read(buffer.data(), buffer.size());
+    if (content.fail() || !writer.append_file(hdr.path, buffer.data(), static_cast<int>(buffer.size()), Mime_type::Not_set, Mime_encoding::Not_set))
+      return false;
+  }
+  return writer.finalize();
+}
+
 utl::Slpk_writer* utl::create_file_slpk_writer(const std::filesystem::path& dst_path)
 {
   if (dst_path.extension() == ".eslpk")
@@ -22,6 +22,10 @@ email: contracts@esri.com
 #ifndef NO_UTL_SERIALIZABLE 
 #include "utils/utl_serialize.h"
 #endif
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include <cmath>
 
 namespace i3slib
 {
@@ -202,6 +206,106 @@ struct Attribute_stats_desc
 
 };
 
+// ---- Merge stats documents ( e.g. layer built in shards ):
+
+//! Counts of values found in both lists are added. Result is sorted by count and truncated to the longest input.
+template< class T >
+inline void merge_most_frequent(std::vector< Value_count_tpl< T > >* dst, const std::vector< Value_count_tpl< T > >& src)
+{
+  const size_t max_count = std::max(dst->size(), src.size());
+  for (const auto& vc : src)
+  {
+    auto found = std::find_if(dst->begin(), dst->end(), [&vc](const Value_count_tpl< T >& a) { return a.value == vc.value; });
+    if (found != dst->end())
+      found->count += vc.count;
+    else
+      dst->push_back(vc);
+  }
+  std::stable_sort(dst->begin(), dst->end(), std::greater<>());
+  if (dst->size() > max_count)
+    dst->resize(max_count);
+}
+
+//! Histograms with different ranges are re-binned over the union range: each source bin is added to the bin that contains its center.
+inline void merge_histo(Histo_stats* dst, const Histo_stats& src)
+{
+  if (src.counts.empty())
+    return;
+  if (dst->counts.empty())
+  {
+    *dst = src;
+    return;
+  }
+  if (dst->minH == src.minH && dst->maxH == src.maxH && dst->counts.size() == src.counts.size())
+  {
+    for (size_t i = 0; i < src.counts.size(); ++i)
+      dst->counts[i] += src.counts[i];
+    return;
+  }
+  Histo_stats out;
+  out.minH = std::min(dst->minH, src.minH);
+  out.maxH = std::max(dst->maxH, src.maxH);
+  out.counts.assign(std::max(dst->counts.size(), src.counts.size()), 0);
+  const double out_width = (out.maxH - out.minH) / (double)out.counts.size();
+  auto rebin = [&out, out_width](const Histo_stats& h)
+  {
+    const double width = (h.maxH - h.minH) / (double)h.counts.size();
+    for (size_t i = 0; i < h.counts.size(); ++i)
+    {
+      const double center = h.minH + ((double)i + 0.5) * width;
+      size_t k = out_width > 0.0 ? (size_t)std::max(0.0, (center - out.minH) / out_width) : 0;
+      out.counts[std::min(k, out.counts.size() - 1)] += h.counts[i];
+    }
+  };
+  rebin(*dst);
+  rebin(src);
+  *dst = std::move(out);
+}
+
+inline void merge_stats(Atrb_stats* dst, const Atrb_stats& src)
+{
+  if (src.count <= 0.0)
+    return;
+  if (dst->count <= 0.0)
+  {
+    *dst = src;
+    return;
+  }
+  // recover sum and sum of squares ( inverse of set_stddev() ):
+  auto get_sum = [](const Atrb_stats& s) { return s.sum != 0.0 ? s.sum : s.avg * s.count; };
+  auto get_sum_of_square = [&get_sum](const Atrb_stats& s) 
+  { 
+    const double sum = get_sum(s);
+    return (s.stddev * s.stddev * s.count * (s.count - 1.0) + sum * sum) / s.count; 
+  };
+  const double sum_of_square = get_sum_of_square(*dst) + get_sum_of_square(src);
+  const double sum = get_sum(*dst) + get_sum(src);
+  dst->minH = std::min(dst->minH, src.minH);
+  dst->maxH = std::max(dst->maxH, src.maxH);
+  dst->set_stddev(sum_of_square, sum, dst->count + src.count);
+  merge_histo(&dst->histo, src.histo);
+  merge_most_frequent(&dst->mostFrequent, src.mostFrequent);
+}
+
+template< class String_t >
+inline void merge_stats(Atrb_stats_string< String_t >* dst, const Atrb_stats_string< String_t >& src)
+{
+  dst->totalValuesCount += src.totalValuesCount;
+  merge_most_frequent(&dst->mostFrequent, src.mostFrequent);
+}
+
+//! Time strings are expected to be ISO 8601 ( i.e. lexicographic order is chronological order )
+template< class String_t >
+inline void merge_stats(Atrb_stats_datetime< String_t >* dst, const Atrb_stats_datetime< String_t >& src)
+{
+  if (dst->min_time.empty() || (!src.min_time.empty() && src.min_time < dst->min_time))
+    dst->min_time = src.min_time;
+  if (dst->max_time.empty() || (!src.max_time.empty() && src.max_time > dst->max_time))
+    dst->max_time = src.max_time;
+  dst->totalValuesCount += src.totalValuesCount;
+  merge_most_frequent(&dst->mostFrequent, src.mostFrequent);
+}
+
 } //endof ::utl
 } // namespace i3slib
 
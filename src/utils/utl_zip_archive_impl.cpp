@@ -265,6 +265,44 @@ void Cd_hdr::write(std::ostream* out)
 
 
 
+bool read_end_of_cd_64(std::istream* in, End_of_cd_64* out)
+{
+  // [zip64 end of central directory record][zip64 end of central directory locator][end of central directory record]
+  in->seekg(-(int64_t)(sizeof(End_of_cd_legacy) + sizeof(End_of_cd_locator_64)), std::ios::end);
+  End_of_cd_locator_64 locator;
+  if (!utl::read_it(in, &locator) || locator.sig != End_of_cd_locator_64::c_magic)
+    return false;
+  in->seekg(locator.offset_to_eocd64);
+  if (!utl::read_it(in, out) || out->sig != End_of_cd_64::c_magic)
+    return false;
+  return out->offset_cd + out->cd_size <= locator.offset_to_eocd64;
+}
+
+bool read_stored_file(std::istream* in, const End_of_cd_64& eocd, const std::string& path_in_archive, std::string* content)
+{
+  auto clean = path_in_archive;
+  clean_path(&clean);
+  in->seekg(eocd.offset_cd);
+  Cd_hdr hdr;
+  for (uint64_t i = 0; i < eocd.num_entries_total; ++i)
+  {
+    if (!hdr.read_it(in))
+      return false;
+    if (hdr.path != clean)
+      continue;
+    if (hdr.raw.compression_type != 0)
+      return false; // not supported.
+    Local_file_hdr loc_hdr;
+    uint64_t size = 0;
+    if (!loc_hdr.read(in, hdr.offset, &size, &clean))
+      return false;
+    content->resize(static_cast<size_t>(size));
+    in->read(content->data(), content->size());
+    return !in->fail();
+  }
+  return false;
+}
+
 static void  clean_path(std::string* path)
 {
   //convert slashes:
@@ -289,6 +327,19 @@ Md5::Digest hash_path(std::string* path)
   return hash;
 }
 
+void hash_paths(std::string* paths, size_t count, Md5::Digest* out)
+{
+  std::vector< const uint8_t* > data(count);
+  std::vector< size_t > lengths(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    clean_path(&paths[i]);
+    data[i] = reinterpret_cast<const uint8_t*>(paths[i].data());
+    lengths[i] = paths[i].size();
+  }
+  Md5::hash_n(data.data(), lengths.data(), count, out);
+}
+
 }
 
 }//endof ::utl::Detail
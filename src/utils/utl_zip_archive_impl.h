@@ -29,6 +29,8 @@ email: contracts@esri.com
 namespace i3slib::utl::detail
 {
 I3S_EXPORT Md5::Digest hash_path(std::string* path);
+//! Batched hash_path(): out[i] is the hash of paths[i] ( cleaned in-place ).
+I3S_EXPORT void hash_paths(std::string* paths, size_t count, Md5::Digest* out);
 
 bool _parse_extra_record(const char* extra_rec, int extra_rec_size, uint32_t file_size32, uint64_t* out_file_size64, uint32_t offset32, uint64_t* out_offset64);
 
@@ -433,4 +435,10 @@ struct End_of_cd_legacy
 };
 #pragma pack(pop)
 
+//! Read the zip64 end of central directory record of an archive written by Slpk_writer (i.e. ZIP64, no archive comment).
+I3S_EXPORT bool read_end_of_cd_64(std::istream* in, End_of_cd_64* out);
+
+//! Read an uncompressed file by scanning the central directory. Meant for one-off lookups (no hash index needed).
+I3S_EXPORT bool read_stored_file(std::istream* in, const End_of_cd_64& eocd, const std::string& path_in_archive, std::string* content);
+
 } // namespace i3slib::utl::detail